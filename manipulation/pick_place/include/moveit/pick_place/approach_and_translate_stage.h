@@ -38,6 +38,7 @@
 #define MOVEIT_PICK_PLACE_APPROACH_AND_TRANSLATE_STAGE_
 
 #include <moveit/pick_place/manipulation_stage.h>
+#include <moveit/pick_place/cartesian_segment_cache.h>
 #include <moveit/planning_pipeline/planning_pipeline.h>
 #include <moveit/trajectory_processing/iterative_time_parameterization.h>
 
@@ -51,6 +52,8 @@ public:
   ApproachAndTranslateStage(const planning_scene::PlanningSceneConstPtr &scene,
                             const collision_detection::AllowedCollisionMatrixConstPtr &collision_matrix);
 
+  virtual ~ApproachAndTranslateStage();
+
   virtual bool evaluate(const ManipulationPlanPtr &plan) const;
 
 private:
@@ -59,6 +62,10 @@ private:
   collision_detection::AllowedCollisionMatrixConstPtr collision_matrix_;
   trajectory_processing::IterativeParabolicTimeParameterization time_param_;
 
+  /** \brief The results shared between the approach motions of the plans this stage evaluates; this is NULL if
+      sharing is disabled */
+  CartesianSegmentCachePtr segment_cache_;
+
   unsigned int max_goal_count_;
   unsigned int max_fail_;
   double max_step_;
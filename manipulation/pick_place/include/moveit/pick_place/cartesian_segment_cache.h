@@ -0,0 +1,90 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_PICK_PLACE_CARTESIAN_SEGMENT_CACHE_
+#define MOVEIT_PICK_PLACE_CARTESIAN_SEGMENT_CACHE_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <Eigen/Geometry>
+#include <vector>
+#include <map>
+
+namespace pick_place
+{
+
+/** \brief Results the Cartesian approach motions of different plans in the same pick or place request can share: the
+    group configurations that successful approaches ended at. These are keyed on position only, quantized to a given
+    resolution, so grasps that differ by a rotation about the approach axis can use them as IK seeds. */
+class CartesianSegmentCache
+{
+public:
+
+  CartesianSegmentCache(double position_resolution);
+
+  /** \brief Remember the values of the planning group for a goal state that reached \e position with a valid approach */
+  void addSeed(const Eigen::Vector3d &position, const std::vector<double> &group_values);
+
+  /** \brief Get the values of the planning group for a goal state that reached \e position with a valid approach.
+      Returns false if there is no such state */
+  bool getSeed(const Eigen::Vector3d &position, std::vector<double> &group_values) const;
+
+  /** \brief The number of seeds that were handed out */
+  std::size_t getSeedHitCount() const;
+
+private:
+
+  struct PositionKey
+  {
+    bool operator<(const PositionKey &other) const;
+
+    int cell_[3];
+  };
+
+  PositionKey getPositionKey(const Eigen::Vector3d &position) const;
+
+  double position_resolution_;
+
+  std::map<PositionKey, std::vector<double> > seeds_;
+
+  mutable std::size_t seed_hits_;
+  mutable boost::mutex lock_;
+};
+
+typedef boost::shared_ptr<CartesianSegmentCache> CartesianSegmentCachePtr;
+typedef boost::shared_ptr<const CartesianSegmentCache> CartesianSegmentCacheConstPtr;
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_PICK_PLACE_GRASP_PREFILTER_
+#define MOVEIT_PICK_PLACE_GRASP_PREFILTER_
+
+#include <moveit/pick_place/manipulation_stage.h>
+#include <moveit/pick_place/reachability_map.h>
+#include <moveit/planning_scene/planning_scene.h>
+
+namespace pick_place
+{
+
+/** \brief Reject goal poses with cheap tests before any IK is attempted: the end-effector alone must be collision free
+    at the pose and at the start of the approach towards it. If a reachability map is passed, both positions must also
+    lie in the sampled workspace of the IK link; since that map is approximate, this can reject reachable poses */
+class GraspPrefilter : public ManipulationStage
+{
+public:
+
+  GraspPrefilter(const planning_scene::PlanningSceneConstPtr &scene,
+                 const collision_detection::AllowedCollisionMatrixConstPtr &collision_matrix,
+                 const ReachabilityMapConstPtr &reachability_map);
+
+  virtual bool evaluate(const ManipulationPlanPtr &plan) const;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+
+  bool isReachable(const Eigen::Vector3d &position) const;
+  bool isEndEffectorFree(const ManipulationPlanPtr &plan, robot_state::RobotState &token_state, const Eigen::Affine3d &pose) const;
+
+  planning_scene::PlanningSceneConstPtr planning_scene_;
+  collision_detection::AllowedCollisionMatrixConstPtr collision_matrix_;
+  ReachabilityMapConstPtr reachability_map_;
+
+  /** \brief The transform from the planning frame to the frame of the reachability map */
+  Eigen::Affine3d reachability_frame_;
+};
+
+}
+
+#endif
@@ -38,16 +38,47 @@
 #define MOVEIT_PICK_PLACE_MANIPULATION_PIPELINE_
 
 #include <moveit/pick_place/manipulation_stage.h>
+#include <ros/time.h>
 #include <boost/thread.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/function.hpp>
+#include <functional>
 #include <vector>
-#include <deque>
+#include <map>
 
 namespace pick_place
 {
 
-/** \brief Represent the sequence of steps that are executed for a manipulation plan */
+/** \brief Counters for the work done by one stage of a manipulation pipeline */
+struct ManipulationStageStatistics
+{
+  ManipulationStageStatistics() :
+    evaluated_(0),
+    passed_(0),
+    evaluation_time_(0.0),
+    max_evaluation_time_(0.0),
+    queue_time_(0.0)
+  {
+  }
+
+  /** \brief The number of plans the stage evaluated */
+  std::size_t evaluated_;
+
+  /** \brief The number of plans that passed the stage */
+  std::size_t passed_;
+
+  /** \brief The total and the largest time spent evaluating a plan in this stage (seconds) */
+  double evaluation_time_;
+  double max_evaluation_time_;
+
+  /** \brief The total time plans spent waiting in the queue of this stage (seconds) */
+  double queue_time_;
+};
+
+/** \brief Represent the sequence of steps that are executed for a manipulation plan.
+    Every stage has its own queue of plans, ordered by plan priority. Each processing thread prefers one stage, but
+    takes work from the queues of the other stages (the later ones first) when its own queue is empty, so slow stages
+    do not keep the other threads idle. */
 class ManipulationPipeline
 {
 public:
@@ -60,16 +91,30 @@ public:
     return name_;
   }
   
+  /** \brief Set the callback to be called once the requested number of successful plans has been found */
   void setSolutionCallback(const boost::function<void()> &callback)
   {
     solution_callback_ = callback;
   }
   
+  /** \brief Set the callback to be called when all queues are empty and no plan is being processed */
   void setEmptyQueueCallback(const boost::function<void()> &callback)
   {
     empty_queue_callback_ = callback;
   }
   
+  /** \brief Set the number of successful plans after which processing stops and the remaining plans are dropped (default is 1).
+      Once the pipeline is stopped, the successful plans are ordered by increasing priority */
+  void setMaxSuccessCount(std::size_t count)
+  {
+    max_success_count_ = count;
+  }
+
+  std::size_t getMaxSuccessCount() const
+  {
+    return max_success_count_;
+  }
+
   ManipulationPipeline& addStage(const ManipulationStagePtr &next);
   const ManipulationStagePtr& getFirstStage() const;
   const ManipulationStagePtr& getLastStage() const;
@@ -94,29 +139,58 @@ public:
     return failed_;
   }
   
+  /** \brief Get the counters for each stage, since the pipeline was last started */
+  std::vector<ManipulationStageStatistics> getStageStatistics() const;
+
   void reprocessLastFailure();
   
 protected:
   
+  struct QueuedPlan
+  {
+    ManipulationPlanPtr plan_;
+    ros::WallTime queued_;
+  };
+
+  /// The plans waiting for a stage, highest priority first; plans of equal priority keep the order they were queued in
+  typedef std::multimap<double, QueuedPlan, std::greater<double> > StageQueue;
+
   void processingThread(unsigned int index);
-  
+
+  /// Queue a plan for a stage; the queue lock must be held
+  void enqueue(std::size_t stage, const ManipulationPlanPtr &plan);
+
+  /// Take the next plan to process, preferring \e home_stage; the queue lock must be held
+  bool dequeue(std::size_t home_stage, std::size_t &stage, QueuedPlan &plan);
+
+  /// Run a plan through a stage; returns true if the plan should go on to the next stage
+  bool evaluateStage(unsigned int index, std::size_t stage, const ManipulationPlanPtr &plan, double &evaluation_time);
+
+  void logStatistics() const;
+
   std::string name_;
   unsigned int nthreads_;
   bool verbose_;
   std::vector<ManipulationStagePtr> stages_;
   
-  std::deque<ManipulationPlanPtr> queue_;
+  std::vector<StageQueue> queues_;
   std::vector<ManipulationPlanPtr> success_;
   std::vector<ManipulationPlanPtr> failed_;
-  
+  std::size_t max_success_count_;
+
+  std::vector<ManipulationStageStatistics> statistics_;
+  ros::WallTime start_time_;
+  std::size_t cancelled_;
+
   std::vector<boost::thread*> processing_threads_;
   boost::condition_variable queue_access_cond_;
-  boost::mutex queue_access_lock_;
+  mutable boost::mutex queue_access_lock_;
   boost::mutex result_lock_;
   
   boost::function<void()> solution_callback_;
   boost::function<void()> empty_queue_callback_;
-  unsigned int empty_queue_threads_;
+  unsigned int active_threads_;
+  bool empty_queue_signaled_;
   
   bool stop_processing_;
   
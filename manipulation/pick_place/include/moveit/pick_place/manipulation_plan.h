@@ -87,7 +87,8 @@ struct ManipulationPlan
 {
   ManipulationPlan(const ManipulationPlanSharedDataConstPtr &shared_data) :
     shared_data_(shared_data),
-    processing_stage_(0)
+    processing_stage_(0),
+    priority_(0.0)
   {
   }
 
@@ -141,6 +142,9 @@ struct ManipulationPlan
   // An id for this plan; this is usually the index of the Grasp / PlaceLocation in the input request
   std::size_t id_;
 
+  // Plans with higher priority are processed first by the manipulation pipeline; for pick, this is the grasp quality
+  double priority_;
+
 };
 
 typedef boost::shared_ptr<ManipulationPlan> ManipulationPlanPtr;
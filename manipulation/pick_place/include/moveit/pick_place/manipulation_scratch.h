@@ -0,0 +1,93 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_PICK_PLACE_MANIPULATION_SCRATCH_
+#define MOVEIT_PICK_PLACE_MANIPULATION_SCRATCH_
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit_msgs/AttachedCollisionObject.h>
+#include <boost/noncopyable.hpp>
+
+namespace pick_place
+{
+
+/** \brief Objects a thread of the manipulation pipeline reuses across the plans it evaluates, instead of allocating
+    them anew for every plan. Each thread has its own instance, so no locking is needed; the objects are freed when
+    the thread exits. */
+class ManipulationScratch : private boost::noncopyable
+{
+public:
+
+  /** \brief The robot states a thread can hold at the same time. Each stage uses its own slots, so a state obtained
+      by one stage is not overwritten by another */
+  enum StateSlot
+    {
+      PREFILTER_STATE = 0,
+      POSE_FILTER_STATE,
+      GOAL_SAMPLING_STATE,
+      CLOSE_UP_STATE,
+      APPROACH_STATE,
+      RETREAT_STATE,
+      STATE_SLOT_COUNT
+    };
+
+  /** \brief Get the scratch objects of the calling thread */
+  static ManipulationScratch& get();
+
+  /** \brief Get the state in \e slot, set to \e reference. Only the values of an existing state are overwritten,
+      unless \e reference is for a different robot model. The state remains valid until the calling thread asks for
+      the same slot again */
+  robot_state::RobotState& getState(StateSlot slot, const robot_state::RobotState &reference);
+
+  /** \brief Get a planning scene that is a diff on top of \e parent, with its current state set to \e state and with
+      \e attached_object applied to it. Creating a diff copies the collision world, so the same diff is kept for as
+      long as \e parent does not change; between uses, only the object named in \e attached_object is restored to what
+      \e parent has. The scene remains valid until the calling thread asks for it again. */
+  const planning_scene::PlanningScenePtr& getSceneWithAttachedObject(const planning_scene::PlanningSceneConstPtr &parent,
+                                                                     const robot_state::RobotState &state,
+                                                                     const moveit_msgs::AttachedCollisionObject &attached_object);
+
+private:
+
+  ManipulationScratch();
+
+  robot_state::RobotStatePtr states_[STATE_SLOT_COUNT];
+
+  planning_scene::PlanningSceneConstPtr parent_scene_;
+  planning_scene::PlanningScenePtr diff_scene_;
+};
+
+}
+
+#endif
@@ -39,12 +39,15 @@
 
 #include <moveit/pick_place/manipulation_pipeline.h>
 #include <moveit/pick_place/pick_place_params.h>
+#include <moveit/pick_place/reachability_map.h>
 #include <moveit/constraint_sampler_manager_loader/constraint_sampler_manager_loader.h>
 #include <moveit/planning_pipeline/planning_pipeline.h>
 #include <moveit_msgs/PickupAction.h>
 #include <moveit_msgs/PlaceAction.h>
 #include <boost/noncopyable.hpp>
 #include <boost/enable_shared_from_this.hpp>
+#include <boost/thread.hpp>
+#include <set>
 
 namespace pick_place
 {
@@ -126,6 +129,7 @@ public:
   static const double DEFAULT_GRASP_POSTURE_COMPLETION_DURATION; // seconds
 
   PickPlace(const planning_pipeline::PlanningPipelinePtr &planning_pipeline);
+  ~PickPlace();
 
   const constraint_samplers::ConstraintSamplerManagerPtr& getConstraintsSamplerManager() const
   {
@@ -142,6 +146,12 @@ public:
     return planning_pipeline_->getRobotModel();
   }
 
+  /** \brief Get the reachability map of \e link when moving \e group. The maps for the end-effectors of the robot start
+      building in the background on construction; other maps, and maps whose parameters changed, are (re)built in the
+      background when first asked for. Returns an empty pointer until the map is ready, or if reachability maps are
+      disabled, which is the default */
+  ReachabilityMapConstPtr getReachabilityMap(const robot_model::JointModelGroup *group, const robot_model::LinkModel *link) const;
+
   /** \brief Plan the sequence of motions that perform a pickup action */
   PickPlanPtr planPick(const planning_scene::PlanningSceneConstPtr &planning_scene, const moveit_msgs::PickupGoal &goal) const;
 
@@ -167,6 +177,17 @@ private:
   ros::Publisher grasps_publisher_;
 
   constraint_sampler_manager_loader::ConstraintSamplerManagerLoaderPtr constraint_sampler_manager_loader_;
+
+  /** \brief Start building the map of \e link when moving \e group in the background, unless it is already being built.
+      Must be called with reachability_maps_lock_ held */
+  void buildReachabilityMapInBackground(const robot_model::JointModelGroup *group, const robot_model::LinkModel *link) const;
+  void buildReachabilityMap(const robot_model::JointModelGroup *group, const robot_model::LinkModel *link,
+                            double resolution, unsigned int samples) const;
+
+  mutable std::map<std::pair<std::string, std::string>, ReachabilityMapPtr> reachability_maps_;
+  mutable std::set<std::pair<std::string, std::string> > reachability_maps_building_;
+  mutable boost::thread_group reachability_threads_;
+  mutable boost::mutex reachability_maps_lock_;
 };
 
 }
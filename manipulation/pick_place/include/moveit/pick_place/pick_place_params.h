@@ -48,6 +48,10 @@ namespace pick_place
     unsigned int max_fail_;
     double max_step_;
     double jump_factor_;
+    double reachability_resolution_;
+    unsigned int reachability_samples_;
+    double cartesian_cache_resolution_;
+    unsigned int max_success_count_;
   };
   
   // Get access to a global variable that contains the pick & place params.
@@ -0,0 +1,97 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_PICK_PLACE_REACHABILITY_MAP_
+#define MOVEIT_PICK_PLACE_REACHABILITY_MAP_
+
+#include <moveit/robot_model/robot_model.h>
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Geometry>
+#include <vector>
+
+namespace pick_place
+{
+
+/** \brief A precomputed, sampled approximation of the positions a link can reach by moving the joints of a group.
+    The positions are expressed in the frame of the link the group is attached to, and stored in a grid of cells
+    that is dilated by one cell, so lookups are a single index computation. Because the map is built from a finite
+    number of random samples it is \e not conservative: thin or rarely sampled parts of the workspace may be missing,
+    and reachable positions there are reported as unreachable. */
+class ReachabilityMap
+{
+public:
+
+  /** \brief Build the map for \e link, moving the joints of \e group, by sampling \e samples random states and marking
+      the cells of size \e resolution the link ends up in */
+  ReachabilityMap(const robot_model::RobotModelConstPtr &model, const robot_model::JointModelGroup *group,
+                  const robot_model::LinkModel *link, double resolution, unsigned int samples);
+
+  /** \brief The link the map is expressed in; this is NULL if the group moves its own base (planar or floating
+      joints), in which case every position is considered reachable */
+  const robot_model::LinkModel* getBaseLink() const
+  {
+    return base_link_;
+  }
+
+  double getResolution() const
+  {
+    return resolution_;
+  }
+
+  unsigned int getSampleCount() const
+  {
+    return samples_;
+  }
+
+  /** \brief Check if \e position (expressed in the frame of the base link) was near a sampled position. A false
+      result is only as reliable as the sampling the map was built from */
+  bool isReachable(const Eigen::Vector3d &position) const;
+
+private:
+
+  const robot_model::LinkModel *base_link_;
+  double resolution_;
+  unsigned int samples_;
+
+  Eigen::Vector3d origin_;
+  int size_[3];
+  std::vector<bool> cells_;
+};
+
+typedef boost::shared_ptr<ReachabilityMap> ReachabilityMapPtr;
+typedef boost::shared_ptr<const ReachabilityMap> ReachabilityMapConstPtr;
+
+}
+
+#endif
@@ -55,8 +55,6 @@ public:
   virtual bool evaluate(const ManipulationPlanPtr &plan) const;
 
 private:
-  
-  bool isEndEffectorFree(const ManipulationPlanPtr &plan, robot_state::RobotState &token_state) const;
 
   planning_scene::PlanningSceneConstPtr planning_scene_;
   collision_detection::AllowedCollisionMatrixConstPtr collision_matrix_;
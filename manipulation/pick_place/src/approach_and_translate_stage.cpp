@@ -36,6 +36,7 @@
 
 #include <moveit/pick_place/pick_place.h>
 #include <moveit/pick_place/approach_and_translate_stage.h>
+#include <moveit/pick_place/manipulation_scratch.h>
 #include <moveit/trajectory_processing/trajectory_tools.h>
 #include <eigen_conversions/eigen_msg.h>
 #include <ros/console.h>
@@ -53,6 +54,14 @@ ApproachAndTranslateStage::ApproachAndTranslateStage(const planning_scene::Plann
   max_fail_ = GetGlobalPickPlaceParams().max_fail_;
   max_step_ = GetGlobalPickPlaceParams().max_step_;
   jump_factor_ = GetGlobalPickPlaceParams().jump_factor_;
+  if (GetGlobalPickPlaceParams().cartesian_cache_resolution_ > 0.0)
+    segment_cache_.reset(new CartesianSegmentCache(GetGlobalPickPlaceParams().cartesian_cache_resolution_));
+}
+
+ApproachAndTranslateStage::~ApproachAndTranslateStage()
+{
+  if (segment_cache_)
+    ROS_DEBUG("Shared approach results provided %u IK seeds", (unsigned int)segment_cache_->getSeedHitCount());
 }
 
 namespace
@@ -95,28 +104,37 @@ bool isStateCollisionFree(const planning_scene::PlanningScene *planning_scene,
 }
 
 bool samplePossibleGoalStates(const ManipulationPlanPtr &plan, const robot_state::RobotState &reference_state,
-  double min_distance, unsigned int attempts)
+  double min_distance, unsigned int attempts, std::vector<double> &seed)
 {
-  // initialize with scene state
-  robot_state::RobotStatePtr token_state(new robot_state::RobotState(reference_state));
+  // initialize with scene state; a new state is only allocated for samples that are kept
+  robot_state::RobotState &token_state = ManipulationScratch::get().getState(ManipulationScratch::GOAL_SAMPLING_STATE, reference_state);
   const robot_state::JointModelGroup *jmg = plan->shared_data_->planning_group_;
   for (unsigned int j = 0 ; j < attempts ; ++j)
   {
     double min_d = std::numeric_limits<double>::infinity();
 
-    // Samples given the constraints, populating the joint state group
-    if (plan->goal_sampler_->sample(*token_state, plan->shared_data_->max_goal_sampling_attempts_))
+    // Samples given the constraints, populating the joint state group; the seed, if there is one, is used only once
+    bool sampled;
+    if (!seed.empty())
+    {
+      token_state.setJointGroupPositions(jmg, seed);
+      seed.clear();
+      sampled = plan->goal_sampler_->project(token_state, plan->shared_data_->max_goal_sampling_attempts_);
+    }
+    else
+      sampled = plan->goal_sampler_->sample(token_state, plan->shared_data_->max_goal_sampling_attempts_);
+    if (sampled)
     {
       // Check if this new sampled state is closest we've found so far
       for (std::size_t i = 0 ; i < plan->possible_goal_states_.size() ; ++i)
       {
-        double d = plan->possible_goal_states_[i]->distance(*token_state, plan->shared_data_->planning_group_);
+        double d = plan->possible_goal_states_[i]->distance(token_state, plan->shared_data_->planning_group_);
         if (d < min_d)
           min_d = d;
       }
       if (min_d >= min_distance)
       {
-        plan->possible_goal_states_.push_back(token_state);
+        plan->possible_goal_states_.push_back(robot_state::RobotStatePtr(new robot_state::RobotState(token_state)));
         return true;
       }
     }
@@ -124,6 +142,17 @@ bool samplePossibleGoalStates(const ManipulationPlanPtr &plan, const robot_state
   return false;
 }
 
+// Remember the goal state of a plan whose approach succeeded, as a seed for other plans that reach the same position
+void addSeed(const CartesianSegmentCachePtr &cache, const ManipulationPlanPtr &plan, const robot_state::RobotState &goal_state)
+{
+  if (cache)
+  {
+    std::vector<double> values;
+    goal_state.copyJointGroupPositions(plan->shared_data_->planning_group_, values);
+    cache->addSeed(plan->transformed_goal_pose_.translation(), values);
+  }
+}
+
 // This function is called during trajectory execution, after the gripper is closed, to attach the currently gripped object
 bool executeAttachObject(const ManipulationPlanSharedDataConstPtr &shared_plan_data,
                          const trajectory_msgs::JointTrajectory &detach_posture,
@@ -204,7 +233,13 @@ bool ApproachAndTranslateStage::evaluate(const ManipulationPlanPtr &plan) const
   // state validity checking during the approach must ensure that the gripper posture is that for pre-grasping
   robot_state::GroupStateValidityCallbackFn approach_validCallback = boost::bind(&isStateCollisionFree, planning_scene_.get(),
                                                                                  collision_matrix_.get(), verbose_, &plan->approach_posture_, _1, _2, _3);
+
+  // a goal state that reached the same position in another plan is a good seed for sampling more goal states
+  std::vector<double> seed;
+  if (segment_cache_)
+    segment_cache_->getSeed(plan->transformed_goal_pose_.translation(), seed);
   plan->goal_sampler_->setVerbose(verbose_);
+  ManipulationScratch &scratch = ManipulationScratch::get();
   std::size_t attempted_possible_goal_states = 0;
   do // continously sample possible goal states
   {
@@ -214,9 +249,9 @@ bool ApproachAndTranslateStage::evaluate(const ManipulationPlanPtr &plan) const
       if (plan->shared_data_->minimize_object_distance_)
       {
         static const double MAX_CLOSE_UP_DIST = 1.0;
-        robot_state::RobotStatePtr close_up_state(new robot_state::RobotState(*plan->possible_goal_states_[i]));
+        robot_state::RobotState &close_up_state = scratch.getState(ManipulationScratch::CLOSE_UP_STATE, *plan->possible_goal_states_[i]);
         std::vector<robot_state::RobotStatePtr> close_up_states;
-        double d_close_up = close_up_state->
+        double d_close_up = close_up_state.
           computeCartesianPath(plan->shared_data_->planning_group_,
                                close_up_states, plan->shared_data_->ik_link_,
                                approach_direction, approach_direction_is_global_frame, MAX_CLOSE_UP_DIST,
@@ -227,37 +262,33 @@ bool ApproachAndTranslateStage::evaluate(const ManipulationPlanPtr &plan) const
       }
 
       // try to compute a straight line path that arrives at the goal using the specified approach direction
-      robot_state::RobotStatePtr first_approach_state(new robot_state::RobotState(*plan->possible_goal_states_[i]));
+      robot_state::RobotState &first_approach_state = scratch.getState(ManipulationScratch::APPROACH_STATE, *plan->possible_goal_states_[i]);
 
       std::vector<robot_state::RobotStatePtr> approach_states;
-      double d_approach = first_approach_state->computeCartesianPath(plan->shared_data_->planning_group_, approach_states, plan->shared_data_->ik_link_,
-                                                                     -approach_direction, approach_direction_is_global_frame, plan->approach_.desired_distance,
-                                                                     max_step_, jump_factor_, approach_validCallback);
+      double d_approach = first_approach_state.computeCartesianPath(plan->shared_data_->planning_group_, approach_states, plan->shared_data_->ik_link_,
+                                                                    -approach_direction, approach_direction_is_global_frame, plan->approach_.desired_distance,
+                                                                    max_step_, jump_factor_, approach_validCallback);
 
       // if we were able to follow the approach direction for sufficient length, try to compute a retreat direction
       if (d_approach > plan->approach_.min_distance && !signal_stop_)
       {
         if (plan->retreat_.desired_distance > 0.0)
         {
-          // construct a planning scene that is just a diff on top of our actual planning scene
-          planning_scene::PlanningScenePtr planning_scene_after_approach = planning_scene_->diff();
-
-          // assume the current state of the diff world is the one we plan to reach
-          planning_scene_after_approach->getCurrentStateNonConst() = *plan->possible_goal_states_[i];
-
-          // apply the difference message to this world that virtually attaches the object we are manipulating
-          planning_scene_after_approach->processAttachedCollisionObjectMsg(plan->shared_data_->diff_attached_object_);
+          // get a planning scene that is just a diff on top of our actual planning scene, assuming its current state is the one
+          // we plan to reach and with the difference message applied that virtually attaches the object we are manipulating
+          const planning_scene::PlanningScenePtr &planning_scene_after_approach =
+            scratch.getSceneWithAttachedObject(planning_scene_, *plan->possible_goal_states_[i], plan->shared_data_->diff_attached_object_);
 
           // state validity checking during the retreat after the grasp must ensure the gripper posture is that of the actual grasp
           robot_state::GroupStateValidityCallbackFn retreat_validCallback = boost::bind(&isStateCollisionFree, planning_scene_after_approach.get(),
                                                                                         collision_matrix_.get(), verbose_, &plan->retreat_posture_, _1, _2, _3);
 
           // try to compute a straight line path that moves from the goal in a desired direction
-          robot_state::RobotStatePtr last_retreat_state(new robot_state::RobotState(planning_scene_after_approach->getCurrentState()));
+          robot_state::RobotState &last_retreat_state = scratch.getState(ManipulationScratch::RETREAT_STATE, planning_scene_after_approach->getCurrentState());
           std::vector<robot_state::RobotStatePtr> retreat_states;
-          double d_retreat = last_retreat_state->computeCartesianPath(plan->shared_data_->planning_group_, retreat_states, plan->shared_data_->ik_link_,
-                                                                       retreat_direction, retreat_direction_is_global_frame, plan->retreat_.desired_distance,
-                                                                       max_step_, jump_factor_, retreat_validCallback);
+          double d_retreat = last_retreat_state.computeCartesianPath(plan->shared_data_->planning_group_, retreat_states, plan->shared_data_->ik_link_,
+                                                                      retreat_direction, retreat_direction_is_global_frame, plan->retreat_.desired_distance,
+                                                                      max_step_, jump_factor_, retreat_validCallback);
 
           // if sufficient progress was made in the desired direction, we have a goal state that we can consider for future stages
           if (d_retreat > plan->retreat_.min_distance && !signal_stop_)
@@ -291,14 +322,12 @@ bool ApproachAndTranslateStage::evaluate(const ManipulationPlanPtr &plan) const
             plan->trajectories_.push_back(et_retreat);
 
             plan->approach_state_ = approach_states.front();
+            addSeed(segment_cache_, plan, *plan->possible_goal_states_[i]);
             return true;
           }
         }
         else // No retreat was specified, so package up approach and grip trajectories.
         {
-          // Reset the approach_state_ RobotStatePtr so that we can retry computing the cartesian path
-          plan->approach_state_.swap(first_approach_state);
-
           // Create approach trajectory
           std::reverse(approach_states.begin(), approach_states.end());
           robot_trajectory::RobotTrajectoryPtr approach_traj(new robot_trajectory::RobotTrajectory(planning_scene_->getRobotModel(), plan->shared_data_->planning_group_->getName()));
@@ -317,6 +346,7 @@ bool ApproachAndTranslateStage::evaluate(const ManipulationPlanPtr &plan) const
           addGripperTrajectory(plan, collision_matrix_, "grasp");
 
           plan->approach_state_ = approach_states.front();
+          addSeed(segment_cache_, plan, *plan->possible_goal_states_[i]);
 
           return true;
         }
@@ -324,7 +354,7 @@ bool ApproachAndTranslateStage::evaluate(const ManipulationPlanPtr &plan) const
 
     }
   }
-  while (plan->possible_goal_states_.size() < max_goal_count_ && !signal_stop_ && samplePossibleGoalStates(plan, planning_scene_->getCurrentState(), min_distance, max_fail_));
+  while (plan->possible_goal_states_.size() < max_goal_count_ && !signal_stop_ && samplePossibleGoalStates(plan, planning_scene_->getCurrentState(), min_distance, max_fail_, seed));
 
   plan->error_code_.val = moveit_msgs::MoveItErrorCodes::PLANNING_FAILED;
 
@@ -0,0 +1,86 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/pick_place/cartesian_segment_cache.h>
+#include <algorithm>
+#include <cmath>
+
+namespace pick_place
+{
+
+bool CartesianSegmentCache::PositionKey::operator<(const PositionKey &other) const
+{
+  return std::lexicographical_compare(cell_, cell_ + 3, other.cell_, other.cell_ + 3);
+}
+
+CartesianSegmentCache::CartesianSegmentCache(double position_resolution) :
+  position_resolution_(position_resolution),
+  seed_hits_(0)
+{
+}
+
+CartesianSegmentCache::PositionKey CartesianSegmentCache::getPositionKey(const Eigen::Vector3d &position) const
+{
+  PositionKey key;
+  for (int i = 0 ; i < 3 ; ++i)
+    key.cell_[i] = (int)floor(position[i] / position_resolution_);
+  return key;
+}
+
+void CartesianSegmentCache::addSeed(const Eigen::Vector3d &position, const std::vector<double> &group_values)
+{
+  PositionKey key = getPositionKey(position);
+  boost::mutex::scoped_lock slock(lock_);
+  seeds_[key] = group_values;
+}
+
+bool CartesianSegmentCache::getSeed(const Eigen::Vector3d &position, std::vector<double> &group_values) const
+{
+  PositionKey key = getPositionKey(position);
+  boost::mutex::scoped_lock slock(lock_);
+  std::map<PositionKey, std::vector<double> >::const_iterator it = seeds_.find(key);
+  if (it == seeds_.end())
+    return false;
+  group_values = it->second;
+  seed_hits_++;
+  return true;
+}
+
+std::size_t CartesianSegmentCache::getSeedHitCount() const
+{
+  boost::mutex::scoped_lock slock(lock_);
+  return seed_hits_;
+}
+
+}
@@ -0,0 +1,142 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/pick_place/grasp_prefilter.h>
+#include <moveit/pick_place/manipulation_scratch.h>
+#include <eigen_conversions/eigen_msg.h>
+#include <ros/console.h>
+#include <limits>
+
+pick_place::GraspPrefilter::GraspPrefilter(const planning_scene::PlanningSceneConstPtr &scene,
+                                           const collision_detection::AllowedCollisionMatrixConstPtr &collision_matrix,
+                                           const ReachabilityMapConstPtr &reachability_map) :
+  ManipulationStage("grasp prefilter"),
+  planning_scene_(scene),
+  collision_matrix_(collision_matrix),
+  reachability_map_(reachability_map),
+  reachability_frame_(Eigen::Affine3d::Identity())
+{
+  if (reachability_map_ && reachability_map_->getBaseLink())
+  {
+    robot_state::RobotState state(planning_scene_->getCurrentState());
+    state.update();
+    reachability_frame_ = state.getGlobalLinkTransform(reachability_map_->getBaseLink()).inverse();
+  }
+}
+
+bool pick_place::GraspPrefilter::isReachable(const Eigen::Vector3d &position) const
+{
+  return !reachability_map_ || reachability_map_->isReachable(reachability_frame_ * position);
+}
+
+bool pick_place::GraspPrefilter::isEndEffectorFree(const ManipulationPlanPtr &plan, robot_state::RobotState &token_state,
+                                                   const Eigen::Affine3d &pose) const
+{
+  // the gripper is open while approaching the goal
+  if (!plan->approach_posture_.points.empty())
+    token_state.setVariablePositions(plan->approach_posture_.joint_names, plan->approach_posture_.points.back().positions);
+  token_state.updateStateWithLinkAt(plan->shared_data_->ik_link_, pose);
+  collision_detection::CollisionRequest req;
+  req.verbose = verbose_;
+  collision_detection::CollisionResult res;
+  req.group_name = plan->shared_data_->end_effector_group_->getName();
+  planning_scene_->checkCollision(req, res, token_state, *collision_matrix_);
+  return res.collision == false;
+}
+
+bool pick_place::GraspPrefilter::evaluate(const ManipulationPlanPtr &plan) const
+{
+  robot_state::RobotState &token_state = ManipulationScratch::get().getState(ManipulationScratch::PREFILTER_STATE, planning_scene_->getCurrentState());
+  Eigen::Affine3d goal_pose;
+  tf::poseMsgToEigen(plan->goal_pose_.pose, goal_pose);
+  goal_pose = planning_scene_->getFrameTransform(token_state, plan->goal_pose_.header.frame_id) * goal_pose;
+
+  // the cheapest test first: a lookup in the reachability map
+  if (!isReachable(goal_pose.translation()))
+  {
+    if (verbose_)
+      ROS_INFO("Goal pose for manipulation plan %u is outside the reachable workspace", (unsigned int)plan->id_);
+    plan->error_code_.val = moveit_msgs::MoveItErrorCodes::NO_IK_SOLUTION;
+    return false;
+  }
+
+  // the approach ends at the goal pose; it needs to start at least the minimum approach distance away from it, along
+  // the approach direction, which is local to the IK link if specified in its frame and global otherwise
+  bool check_approach = plan->approach_.min_distance > 0.0;
+  Eigen::Affine3d approach_pose = goal_pose;
+  if (check_approach)
+  {
+    Eigen::Vector3d approach_direction;
+    tf::vectorMsgToEigen(plan->approach_.direction.vector, approach_direction);
+    if (approach_direction.norm() < std::numeric_limits<double>::epsilon())
+    {
+      if (verbose_)
+        ROS_INFO("No approach direction is specified for manipulation plan %u", (unsigned int)plan->id_);
+      plan->error_code_.val = moveit_msgs::MoveItErrorCodes::INVALID_MOTION_PLAN;
+      return false;
+    }
+    approach_direction.normalize();
+    if (robot_state::Transforms::sameFrame(plan->approach_.direction.header.frame_id, plan->shared_data_->ik_link_->getName()))
+      approach_direction = goal_pose.rotation() * approach_direction;
+    else
+      approach_direction = planning_scene_->getFrameTransform(token_state, plan->approach_.direction.header.frame_id).rotation() * approach_direction;
+    approach_pose.translation() -= approach_direction * plan->approach_.min_distance;
+
+    if (!isReachable(approach_pose.translation()))
+    {
+      if (verbose_)
+        ROS_INFO("The approach for manipulation plan %u starts outside the reachable workspace", (unsigned int)plan->id_);
+      plan->error_code_.val = moveit_msgs::MoveItErrorCodes::NO_IK_SOLUTION;
+      return false;
+    }
+  }
+
+  // collision checks for the end-effector alone
+  if (!isEndEffectorFree(plan, token_state, goal_pose))
+  {
+    if (verbose_)
+      ROS_INFO("The end-effector is in collision at the goal pose of manipulation plan %u", (unsigned int)plan->id_);
+    plan->error_code_.val = moveit_msgs::MoveItErrorCodes::GOAL_IN_COLLISION;
+    return false;
+  }
+  if (check_approach && !isEndEffectorFree(plan, token_state, approach_pose))
+  {
+    if (verbose_)
+      ROS_INFO("The end-effector is in collision at the start of the approach for manipulation plan %u", (unsigned int)plan->id_);
+    plan->error_code_.val = moveit_msgs::MoveItErrorCodes::GOAL_IN_COLLISION;
+    return false;
+  }
+
+  return true;
+}
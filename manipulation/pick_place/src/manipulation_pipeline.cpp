@@ -36,6 +36,7 @@
 
 #include <moveit/pick_place/manipulation_pipeline.h>
 #include <ros/console.h>
+#include <algorithm>
 
 namespace pick_place
 {
@@ -44,6 +45,10 @@ ManipulationPipeline::ManipulationPipeline(const std::string &name, unsigned int
   name_(name),
   nthreads_(nthreads),
   verbose_(false),
+  max_success_count_(1),
+  cancelled_(0),
+  active_threads_(0),
+  empty_queue_signaled_(false),
   stop_processing_(true)
 {
   processing_threads_.resize(nthreads, NULL);
@@ -58,6 +63,9 @@ ManipulationPipeline& ManipulationPipeline::addStage(const ManipulationStagePtr
 {
   next->setVerbose(verbose_);
   stages_.push_back(next);
+  boost::mutex::scoped_lock slock(queue_access_lock_);
+  queues_.resize(stages_.size());
+  statistics_.resize(stages_.size());
   return *this;
 }
 
@@ -87,6 +95,9 @@ void ManipulationPipeline::reset()
 {
   clear();
   stages_.clear();
+  boost::mutex::scoped_lock slock(queue_access_lock_);
+  queues_.clear();
+  statistics_.clear();
 }
 
 void ManipulationPipeline::setVerbose(bool flag)
@@ -101,7 +112,8 @@ void ManipulationPipeline::clear()
   stop();
   {
     boost::mutex::scoped_lock slock(queue_access_lock_);
-    queue_.clear();
+    for (std::size_t i = 0 ; i < queues_.size() ; ++i)
+      queues_[i].clear();
   }
   {
     boost::mutex::scoped_lock slock(result_lock_);
@@ -112,8 +124,15 @@ void ManipulationPipeline::clear()
 
 void ManipulationPipeline::start()
 {
-  stop_processing_ = false;
-  empty_queue_threads_ = 0;
+  {
+    boost::mutex::scoped_lock slock(queue_access_lock_);
+    stop_processing_ = false;
+    active_threads_ = 0;
+    empty_queue_signaled_ = false;
+    cancelled_ = 0;
+    statistics_.assign(stages_.size(), ManipulationStageStatistics());
+    start_time_ = ros::WallTime::now();
+  }
   for (std::size_t i = 0 ; i < stages_.size() ; ++i)
     stages_[i]->resetStopSignal();
   for (std::size_t i = 0; i < processing_threads_.size() ; ++i)
@@ -125,111 +144,223 @@ void ManipulationPipeline::signalStop()
 {
   for (std::size_t i = 0 ; i < stages_.size() ; ++i)
     stages_[i]->signalStop();
+  boost::mutex::scoped_lock slock(queue_access_lock_);
   stop_processing_ = true;
   queue_access_cond_.notify_all();
 }
 
+namespace
+{
+bool lowerPriority(const ManipulationPlanPtr &a, const ManipulationPlanPtr &b)
+{
+  return a->priority_ < b->priority_;
+}
+}
+
 void ManipulationPipeline::stop()
 {
   signalStop();
+  bool joined = false;
   for (std::size_t i = 0; i < processing_threads_.size() ; ++i)
     if (processing_threads_[i])
     {
       processing_threads_[i]->join();
       delete processing_threads_[i];
       processing_threads_[i] = NULL;
+      joined = true;
     }
+  if (joined)
+    logStatistics();
+
+  // when more than one plan succeeds, the preferred one (highest priority) is the last
+  boost::mutex::scoped_lock slock(result_lock_);
+  std::stable_sort(success_.begin(), success_.end(), lowerPriority);
+}
+
+std::vector<ManipulationStageStatistics> ManipulationPipeline::getStageStatistics() const
+{
+  boost::mutex::scoped_lock slock(queue_access_lock_);
+  return statistics_;
+}
+
+void ManipulationPipeline::logStatistics() const
+{
+  boost::mutex::scoped_lock slock(queue_access_lock_);
+  double elapsed = (ros::WallTime::now() - start_time_).toSec();
+  for (std::size_t i = 0 ; i < statistics_.size() && i < stages_.size() ; ++i)
+  {
+    const ManipulationStageStatistics &s = statistics_[i];
+    if (s.evaluated_ == 0)
+      continue;
+    ROS_DEBUG("[%s] Stage '%s': %u plans evaluated (%u passed) at %lf plans/s; evaluation took %lf s on average (%lf s max), after waiting %lf s on average",
+              name_.c_str(), stages_[i]->getName().c_str(), (unsigned int)s.evaluated_, (unsigned int)s.passed_,
+              elapsed > 0.0 ? s.evaluated_ / elapsed : 0.0, s.evaluation_time_ / s.evaluated_, s.max_evaluation_time_,
+              s.queue_time_ / s.evaluated_);
+  }
+  if (cancelled_ > 0)
+    ROS_DEBUG("[%s] %u queued plans were not processed", name_.c_str(), (unsigned int)cancelled_);
+}
+
+void ManipulationPipeline::enqueue(std::size_t stage, const ManipulationPlanPtr &plan)
+{
+  QueuedPlan q;
+  q.plan_ = plan;
+  q.queued_ = ros::WallTime::now();
+  queues_[stage].insert(std::make_pair(plan->priority_, q));
+  empty_queue_signaled_ = false;
+  queue_access_cond_.notify_all();
+}
+
+bool ManipulationPipeline::dequeue(std::size_t home_stage, std::size_t &stage, QueuedPlan &plan)
+{
+  if (home_stage < queues_.size() && !queues_[home_stage].empty())
+    stage = home_stage;
+  else
+  {
+    // steal work from the other stages, preferring plans that are closest to completion
+    stage = queues_.size();
+    for (std::size_t i = queues_.size() ; i > 0 ; --i)
+      if (!queues_[i - 1].empty())
+      {
+        stage = i - 1;
+        break;
+      }
+    if (stage == queues_.size())
+      return false;
+  }
+  plan = queues_[stage].begin()->second;
+  queues_[stage].erase(queues_[stage].begin());
+  return true;
 }
 
 void ManipulationPipeline::processingThread(unsigned int index)
 {
   ROS_DEBUG_STREAM("Start thread " << index << " for '" << name_ << "'");
   
+  const std::size_t home_stage = stages_.empty() ? 0 : index % stages_.size();
+  boost::unique_lock<boost::mutex> ulock(queue_access_lock_);
   while (!stop_processing_)
   {
-    bool inc_queue = false;
-    boost::unique_lock<boost::mutex> ulock(queue_access_lock_);
-    // if the queue is empty, we trigger the corresponding event
-    if (queue_.empty() && !stop_processing_ && empty_queue_callback_)
+    std::size_t stage;
+    QueuedPlan q;
+    if (!dequeue(home_stage, stage, q))
     {
-      empty_queue_threads_++;
-      inc_queue = true;
-      if (empty_queue_threads_ == processing_threads_.size())
+      // if all queues are empty and no plan is being processed, we trigger the corresponding event
+      if (active_threads_ == 0 && !empty_queue_signaled_ && empty_queue_callback_)
+      {
+        empty_queue_signaled_ = true;
         empty_queue_callback_();
-    }
-    while (queue_.empty() && !stop_processing_)
+      }
       queue_access_cond_.wait(ulock);
-    while (!stop_processing_ && !queue_.empty())
+      continue;
+    }
+
+    active_threads_++;
+    ros::WallTime start = ros::WallTime::now();
+    statistics_[stage].queue_time_ += (start - q.queued_).toSec();
+    ulock.unlock();
+
+    double evaluation_time = 0.0;
+    bool next = evaluateStage(index, stage, q.plan_, evaluation_time);
+
+    ulock.lock();
+    active_threads_--;
+    ManipulationStageStatistics &s = statistics_[stage];
+    s.evaluated_++;
+    s.evaluation_time_ += evaluation_time;
+    s.max_evaluation_time_ = std::max(s.max_evaluation_time_, evaluation_time);
+    if (next)
     {
-      ManipulationPlanPtr g = queue_.front();
-      queue_.pop_front();
-      if (inc_queue)
-      {
-        empty_queue_threads_--;
-        inc_queue = false;
-      }
-      
-      queue_access_lock_.unlock();
-      try
-      {
-        g->error_code_.val = moveit_msgs::MoveItErrorCodes::FAILURE;
-        for (std::size_t i = 0 ; !stop_processing_ && i < stages_.size() ; ++i)
-        {
-          bool res = stages_[i]->evaluate(g);
-          g->processing_stage_ = i + 1;
-          if (res == false)
-          {
-            boost::mutex::scoped_lock slock(result_lock_);
-            failed_.push_back(g);
-            ROS_INFO_STREAM("Manipulation plan " << g->id_ << " failed at stage '" << stages_[i]->getName() << "' on thread " << index);
-            break;
-          }
-        }
-        if (g->error_code_.val == moveit_msgs::MoveItErrorCodes::SUCCESS)
-        {
-          g->processing_stage_++;
-          {
-            boost::mutex::scoped_lock slock(result_lock_);
-            success_.push_back(g);
-          }
-          signalStop();
-          ROS_INFO_STREAM("Found successful manipulation plan!");
-          if (solution_callback_)
-            solution_callback_();
-        }
-      }
-      catch (std::runtime_error &ex)
+      s.passed_++;
+      if (stage + 1 < stages_.size() && !stop_processing_)
+        enqueue(stage + 1, q.plan_);
+    }
+  }
+
+  // the plans still queued when processing stops are dropped
+  std::size_t cancelled = 0;
+  for (std::size_t i = 0 ; i < queues_.size() ; ++i)
+  {
+    cancelled += queues_[i].size();
+    queues_[i].clear();
+  }
+  cancelled_ += cancelled;
+}
+
+bool ManipulationPipeline::evaluateStage(unsigned int index, std::size_t stage, const ManipulationPlanPtr &g, double &evaluation_time)
+{
+  ros::WallTime start = ros::WallTime::now();
+  try
+  {
+    if (stage == 0)
+      g->error_code_.val = moveit_msgs::MoveItErrorCodes::FAILURE;
+    bool res = stages_[stage]->evaluate(g);
+    evaluation_time = (ros::WallTime::now() - start).toSec();
+    g->processing_stage_ = stage + 1;
+    if (res == false)
+    {
+      boost::mutex::scoped_lock slock(result_lock_);
+      failed_.push_back(g);
+      ROS_INFO_STREAM("Manipulation plan " << g->id_ << " failed at stage '" << stages_[stage]->getName() << "' on thread " << index);
+      return false;
+    }
+    if (stage + 1 < stages_.size())
+      return true;
+
+    if (g->error_code_.val == moveit_msgs::MoveItErrorCodes::SUCCESS)
+    {
+      g->processing_stage_++;
+      std::size_t success_count;
       {
-        ROS_ERROR("[%s:%u] %s", name_.c_str(), index, ex.what());
+        boost::mutex::scoped_lock slock(result_lock_);
+        success_.push_back(g);
+        success_count = success_.size();
       }
-      catch (...)
+      ROS_INFO_STREAM("Found successful manipulation plan!");
+      // once enough plans succeeded, the remaining candidates are not worth processing
+      if (success_count >= max_success_count_)
       {
-        ROS_ERROR("[%s:%u] Caught unknown exception while processing manipulation stage", name_.c_str(), index);
+        signalStop();
+        if (solution_callback_)
+          solution_callback_();
       }
-      queue_access_lock_.lock();
     }
+    return true;
+  }
+  catch (std::runtime_error &ex)
+  {
+    ROS_ERROR("[%s:%u] %s", name_.c_str(), index, ex.what());
+  }
+  catch (...)
+  {
+    ROS_ERROR("[%s:%u] Caught unknown exception while processing manipulation stage", name_.c_str(), index);
   }
+  evaluation_time = (ros::WallTime::now() - start).toSec();
+  return false;
 }
 
 void ManipulationPipeline::push(const ManipulationPlanPtr &plan)
 {
   boost::mutex::scoped_lock slock(queue_access_lock_);
-  queue_.push_back(plan);
-  ROS_INFO_STREAM("Added plan for pipeline '" << name_ << "'. Queue is now of size " << queue_.size());
-  queue_access_cond_.notify_all();
+  if (queues_.empty())
+  {
+    ROS_ERROR_STREAM("No stages were added to pipeline '" << name_ << "'");
+    return;
+  }
+  enqueue(0, plan);
+  ROS_INFO_STREAM("Added plan for pipeline '" << name_ << "'. Queue is now of size " << queues_[0].size());
 }
 
 void ManipulationPipeline::reprocessLastFailure()
 {
   boost::mutex::scoped_lock slock(queue_access_lock_);
-  if (failed_.empty())
+  if (failed_.empty() || queues_.empty())
     return;
   ManipulationPlanPtr plan = failed_.back();
   failed_.pop_back();
   plan->clear();
-  queue_.push_back(plan);
-  ROS_INFO_STREAM("Re-added last failed plan for pipeline '" << name_ << "'. Queue is now of size " << queue_.size());
-  queue_access_cond_.notify_all();
+  enqueue(0, plan);
+  ROS_INFO_STREAM("Re-added last failed plan for pipeline '" << name_ << "'. Queue is now of size " << queues_[0].size());
 }
 
 }
@@ -0,0 +1,98 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/pick_place/manipulation_scratch.h>
+#include <boost/thread/tss.hpp>
+
+namespace pick_place
+{
+
+namespace
+{
+boost::thread_specific_ptr<ManipulationScratch> THREAD_SCRATCH;
+}
+
+ManipulationScratch::ManipulationScratch()
+{
+}
+
+ManipulationScratch& ManipulationScratch::get()
+{
+  ManipulationScratch *scratch = THREAD_SCRATCH.get();
+  if (!scratch)
+  {
+    scratch = new ManipulationScratch();
+    THREAD_SCRATCH.reset(scratch);
+  }
+  return *scratch;
+}
+
+robot_state::RobotState& ManipulationScratch::getState(StateSlot slot, const robot_state::RobotState &reference)
+{
+  robot_state::RobotStatePtr &state = states_[slot];
+  if (state && state->getRobotModel() == reference.getRobotModel())
+    *state = reference;
+  else
+    state.reset(new robot_state::RobotState(reference));
+  return *state;
+}
+
+const planning_scene::PlanningScenePtr& ManipulationScratch::getSceneWithAttachedObject(const planning_scene::PlanningSceneConstPtr &parent,
+                                                                                        const robot_state::RobotState &state,
+                                                                                        const moveit_msgs::AttachedCollisionObject &attached_object)
+{
+  const std::string &id = attached_object.object.id;
+  if (!diff_scene_ || parent_scene_ != parent || id.empty())
+  {
+    diff_scene_ = parent->diff();
+    parent_scene_ = parent;
+  }
+  else
+  {
+    // undo what the previous use did to the world: the object is either attached to the previous state or placed
+    // in the world at the pose the previous state implied
+    const collision_detection::WorldPtr &world = diff_scene_->getWorldNonConst();
+    world->removeObject(id);
+    collision_detection::World::ObjectConstPtr obj = parent->getWorld()->getObject(id);
+    if (obj)
+      world->addToObject(id, obj->shapes_, obj->shape_poses_);
+  }
+
+  // copying the state also replaces the attached bodies of the previous use
+  diff_scene_->getCurrentStateNonConst() = state;
+  diff_scene_->processAttachedCollisionObjectMsg(attached_object);
+  return diff_scene_;
+}
+
+}
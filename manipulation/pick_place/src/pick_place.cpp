@@ -104,6 +104,68 @@ PickPlace::PickPlace(const planning_pipeline::PlanningPipelinePtr &planning_pipe
   display_grasps_(false)
 {
   constraint_sampler_manager_loader_.reset(new constraint_sampler_manager_loader::ConstraintSamplerManagerLoader());
+
+  // build the reachability maps pick and place requests are most likely to need, so the first request does not wait
+  if (GetGlobalPickPlaceParams().reachability_samples_ > 0)
+  {
+    boost::mutex::scoped_lock slock(reachability_maps_lock_);
+    const std::vector<const robot_model::JointModelGroup*> &eefs = getRobotModel()->getEndEffectors();
+    for (std::size_t i = 0 ; i < eefs.size() ; ++i)
+    {
+      const std::pair<std::string, std::string> &parent = eefs[i]->getEndEffectorParentGroup();
+      const robot_model::JointModelGroup *group = getRobotModel()->getJointModelGroup(parent.first);
+      const robot_model::LinkModel *link = getRobotModel()->getLinkModel(parent.second);
+      if (group && link)
+        buildReachabilityMapInBackground(group, link);
+    }
+  }
+}
+
+PickPlace::~PickPlace()
+{
+  reachability_threads_.join_all();
+}
+
+ReachabilityMapConstPtr PickPlace::getReachabilityMap(const robot_model::JointModelGroup *group, const robot_model::LinkModel *link) const
+{
+  const PickPlaceParams &params = GetGlobalPickPlaceParams();
+  if (params.reachability_samples_ == 0)
+    return ReachabilityMapConstPtr();
+
+  boost::mutex::scoped_lock slock(reachability_maps_lock_);
+  std::map<std::pair<std::string, std::string>, ReachabilityMapPtr>::const_iterator it =
+    reachability_maps_.find(std::make_pair(group->getName(), link->getName()));
+  // the map is rebuilt if the parameters changed since it was built; requests do not wait for it
+  if (it == reachability_maps_.end() || it->second->getResolution() != params.reachability_resolution_ ||
+      it->second->getSampleCount() != params.reachability_samples_)
+  {
+    buildReachabilityMapInBackground(group, link);
+    return ReachabilityMapConstPtr();
+  }
+  return it->second;
+}
+
+void PickPlace::buildReachabilityMapInBackground(const robot_model::JointModelGroup *group, const robot_model::LinkModel *link) const
+{
+  if (!reachability_maps_building_.insert(std::make_pair(group->getName(), link->getName())).second)
+    return;
+  const PickPlaceParams &params = GetGlobalPickPlaceParams();
+  reachability_threads_.create_thread(boost::bind(&PickPlace::buildReachabilityMap, this, group, link,
+                                                  params.reachability_resolution_, params.reachability_samples_));
+}
+
+void PickPlace::buildReachabilityMap(const robot_model::JointModelGroup *group, const robot_model::LinkModel *link,
+                                     double resolution, unsigned int samples) const
+{
+  ros::WallTime start = ros::WallTime::now();
+  ReachabilityMapPtr map(new ReachabilityMap(getRobotModel(), group, link, resolution, samples));
+  ROS_INFO("Built reachability map for link '%s' of group '%s' in %lf seconds", link->getName().c_str(), group->getName().c_str(),
+           (ros::WallTime::now() - start).toSec());
+
+  boost::mutex::scoped_lock slock(reachability_maps_lock_);
+  std::pair<std::string, std::string> key(group->getName(), link->getName());
+  reachability_maps_[key] = map;
+  reachability_maps_building_.erase(key);
 }
 
 void PickPlace::displayProcessedGrasps(bool flag)
@@ -68,6 +68,10 @@ private:
     params_.max_fail_ = config.max_consecutive_fail_attempts;
     params_.max_step_ = config.cartesian_motion_step_size;
     params_.jump_factor_ = config.jump_factor;
+    params_.reachability_resolution_ = config.reachability_map_resolution;
+    params_.reachability_samples_ = config.reachability_map_samples;
+    params_.cartesian_cache_resolution_ = config.cartesian_cache_resolution;
+    params_.max_success_count_ = config.max_successful_plans;
   }
 
   dynamic_reconfigure::Server<PickPlaceDynamicReconfigureConfig> dynamic_reconfigure_server_;
@@ -79,7 +83,11 @@ private:
 pick_place::PickPlaceParams::PickPlaceParams() : max_goal_count_(5),
 						 max_fail_(3),
 						 max_step_(0.02),
-						 jump_factor_(2.0)
+						 jump_factor_(2.0),
+						 reachability_resolution_(0.05),
+						 reachability_samples_(0),
+						 cartesian_cache_resolution_(0.005),
+						 max_success_count_(1)
 {
 }
 
@@ -35,6 +35,7 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/pick_place/pick_place.h>
+#include <moveit/pick_place/grasp_prefilter.h>
 #include <moveit/pick_place/reachable_valid_pose_filter.h>
 #include <moveit/pick_place/approach_and_translate_stage.h>
 #include <moveit/pick_place/plan_stage.h>
@@ -280,10 +281,13 @@ bool PlacePlan::plan(const planning_scene::PlanningSceneConstPtr &planning_scene
   // configure the manipulation pipeline
   pipeline_.reset();
 
+  ManipulationStagePtr stage0(new GraspPrefilter(planning_scene, approach_place_acm,
+                                                 pick_place_->getReachabilityMap(plan_data->planning_group_, plan_data->ik_link_)));
   ManipulationStagePtr stage1(new ReachableAndValidPoseFilter(planning_scene, approach_place_acm, pick_place_->getConstraintsSamplerManager()));
   ManipulationStagePtr stage2(new ApproachAndTranslateStage(planning_scene, approach_place_acm));
   ManipulationStagePtr stage3(new PlanStage(planning_scene, pick_place_->getPlanningPipeline()));
-  pipeline_.addStage(stage1).addStage(stage2).addStage(stage3);
+  pipeline_.addStage(stage0).addStage(stage1).addStage(stage2).addStage(stage3);
+  pipeline_.setMaxSuccessCount(GetGlobalPickPlaceParams().max_success_count_);
 
   initialize();
 
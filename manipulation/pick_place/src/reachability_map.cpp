@@ -0,0 +1,149 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/pick_place/reachability_map.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/transforms/transforms.h>
+#include <moveit/kdl_kinematics_plugin/kdl_kinematics_plugin.h>
+#include <eigen_stl_containers/eigen_stl_vector_container.h>
+#include <ros/console.h>
+#include <limits>
+#include <cmath>
+
+namespace
+{
+
+// Compute the positions of \e link relative to \e base_link for \e samples random states of \e group in one batch, with the
+// FK of the KDL solver of the group. Returns false if the group is not solved by the KDL plugin, or if its chain does
+// not go from \e base_link to \e link
+bool sampleLinkPositionsWithKDL(const robot_model::JointModelGroup *group, const robot_model::LinkModel *base_link,
+                                const robot_model::LinkModel *link, robot_state::RobotState &state, unsigned int samples,
+                                EigenSTL::vector_Vector3d &positions)
+{
+  const kdl_kinematics_plugin::KDLKinematicsPlugin *kdl =
+    dynamic_cast<const kdl_kinematics_plugin::KDLKinematicsPlugin*>(group->getSolverInstance().get());
+  if (!kdl || !robot_state::Transforms::sameFrame(kdl->getBaseFrame(), base_link->getName()) ||
+      !robot_state::Transforms::sameFrame(kdl->getTipFrame(), link->getName()))
+    return false;
+
+  const std::vector<std::string> &joint_names = kdl->getJointNames();
+  std::vector<double> joint_angles(samples * joint_names.size());
+  for (unsigned int i = 0 ; i < samples ; ++i)
+  {
+    state.setToRandomPositions(group);
+    for (std::size_t j = 0 ; j < joint_names.size() ; ++j)
+      joint_angles[i * joint_names.size() + j] = state.getVariablePosition(joint_names[j]);
+  }
+  std::vector<geometry_msgs::Pose> poses;
+  if (!kdl->getPositionFKBatch(std::vector<std::string>(1, link->getName()), joint_angles, poses))
+    return false;
+  for (unsigned int i = 0 ; i < samples ; ++i)
+    positions[i] = Eigen::Vector3d(poses[i].position.x, poses[i].position.y, poses[i].position.z);
+  return true;
+}
+
+}
+
+pick_place::ReachabilityMap::ReachabilityMap(const robot_model::RobotModelConstPtr &model, const robot_model::JointModelGroup *group,
+                                             const robot_model::LinkModel *link, double resolution, unsigned int samples) :
+  base_link_(NULL),
+  resolution_(resolution),
+  samples_(samples)
+{
+  size_[0] = size_[1] = size_[2] = 0;
+  origin_.setZero();
+
+  const robot_model::JointModel *root = group->getCommonRoot();
+  if (!root || !root->getParentLinkModel() || samples == 0 || resolution <= 0.0)
+    return;
+  const std::vector<const robot_model::JointModel*> &joints = group->getActiveJointModels();
+  for (std::size_t i = 0 ; i < joints.size() ; ++i)
+    if (joints[i]->getType() == robot_model::JointModel::PLANAR || joints[i]->getType() == robot_model::JointModel::FLOATING)
+      return;
+  base_link_ = root->getParentLinkModel();
+
+  // sample positions of the link relative to the base link
+  robot_state::RobotState state(model);
+  state.setToDefaultValues();
+  EigenSTL::vector_Vector3d positions(samples);
+  if (!sampleLinkPositionsWithKDL(group, base_link_, link, state, samples, positions))
+    for (unsigned int i = 0 ; i < samples ; ++i)
+    {
+      state.setToRandomPositions(group);
+      state.update();
+      positions[i] = state.getGlobalLinkTransform(base_link_).inverse() * state.getGlobalLinkTransform(link).translation();
+    }
+  Eigen::Vector3d lower = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+  Eigen::Vector3d upper = -lower;
+  for (unsigned int i = 0 ; i < samples ; ++i)
+  {
+    lower = lower.cwiseMin(positions[i]);
+    upper = upper.cwiseMax(positions[i]);
+  }
+
+  // leave a margin of one cell around the sampled positions for the dilation
+  origin_ = lower - Eigen::Vector3d::Constant(resolution_);
+  for (int k = 0 ; k < 3 ; ++k)
+    size_[k] = (int)floor((upper(k) - origin_(k)) / resolution_) + 2;
+  cells_.resize((std::size_t)size_[0] * size_[1] * size_[2], false);
+
+  for (unsigned int i = 0 ; i < samples ; ++i)
+  {
+    int c[3];
+    for (int k = 0 ; k < 3 ; ++k)
+      c[k] = (int)floor((positions[i](k) - origin_(k)) / resolution_);
+    for (int x = c[0] - 1 ; x <= c[0] + 1 ; ++x)
+      for (int y = c[1] - 1 ; y <= c[1] + 1 ; ++y)
+        for (int z = c[2] - 1 ; z <= c[2] + 1 ; ++z)
+          if (x >= 0 && y >= 0 && z >= 0 && x < size_[0] && y < size_[1] && z < size_[2])
+            cells_[((std::size_t)x * size_[1] + y) * size_[2] + z] = true;
+  }
+
+  ROS_DEBUG("Built reachability map for link '%s' of group '%s' from %u samples: %d x %d x %d cells of size %lf",
+            link->getName().c_str(), group->getName().c_str(), samples, size_[0], size_[1], size_[2], resolution_);
+}
+
+bool pick_place::ReachabilityMap::isReachable(const Eigen::Vector3d &position) const
+{
+  if (!base_link_)
+    return true;
+  int c[3];
+  for (int k = 0 ; k < 3 ; ++k)
+  {
+    c[k] = (int)floor((position(k) - origin_(k)) / resolution_);
+    if (c[k] < 0 || c[k] >= size_[k])
+      return false;
+  }
+  return cells_[((std::size_t)c[0] * size_[1] + c[1]) * size_[2] + c[2]];
+}
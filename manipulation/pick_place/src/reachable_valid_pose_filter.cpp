@@ -35,6 +35,7 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/pick_place/reachable_valid_pose_filter.h>
+#include <moveit/pick_place/manipulation_scratch.h>
 #include <moveit/kinematic_constraints/utils.h>
 #include <eigen_conversions/eigen_msg.h>
 #include <boost/bind.hpp>
@@ -89,59 +90,48 @@ bool isStateCollisionFree(const planning_scene::PlanningScene *planning_scene,
 }
 }
 
-bool pick_place::ReachableAndValidPoseFilter::isEndEffectorFree(const ManipulationPlanPtr &plan, robot_state::RobotState &token_state) const
+bool pick_place::ReachableAndValidPoseFilter::evaluate(const ManipulationPlanPtr &plan) const
 {
+  // initialize with scene state; a new state is only allocated if the sample is kept
+  robot_state::RobotState &token_state = ManipulationScratch::get().getState(ManipulationScratch::POSE_FILTER_STATE, planning_scene_->getCurrentState());
+
+  // the end-effector alone was already checked for collisions at this pose by the grasp prefilter
   tf::poseMsgToEigen(plan->goal_pose_.pose, plan->transformed_goal_pose_);
   plan->transformed_goal_pose_ = planning_scene_->getFrameTransform(token_state, plan->goal_pose_.header.frame_id) * plan->transformed_goal_pose_;
-  token_state.updateStateWithLinkAt(plan->shared_data_->ik_link_, plan->transformed_goal_pose_);
-  collision_detection::CollisionRequest req;
-  req.verbose = verbose_;
-  collision_detection::CollisionResult res;
-  req.group_name = plan->shared_data_->end_effector_group_->getName();
-  planning_scene_->checkCollision(req, res, token_state, *collision_matrix_);
-  return res.collision == false;
-}
 
-bool pick_place::ReachableAndValidPoseFilter::evaluate(const ManipulationPlanPtr &plan) const
-{
-  // initialize with scene state
-  robot_state::RobotStatePtr token_state(new robot_state::RobotState(planning_scene_->getCurrentState()));
-  if (isEndEffectorFree(plan, *token_state))
+  // update the goal pose message if anything has changed; this is because the name of the frame in the input goal pose
+  // can be that of objects in the collision world but most components are unaware of those transforms,
+  // so we convert to a frame that is certainly known
+  if (robot_state::Transforms::sameFrame(planning_scene_->getPlanningFrame(), plan->goal_pose_.header.frame_id))
   {
-    // update the goal pose message if anything has changed; this is because the name of the frame in the input goal pose
-    // can be that of objects in the collision world but most components are unaware of those transforms,
-    // so we convert to a frame that is certainly known
-    if (robot_state::Transforms::sameFrame(planning_scene_->getPlanningFrame(), plan->goal_pose_.header.frame_id))
-    {
-      tf::poseEigenToMsg(plan->transformed_goal_pose_, plan->goal_pose_.pose);
-      plan->goal_pose_.header.frame_id = planning_scene_->getPlanningFrame();
-    }
+    tf::poseEigenToMsg(plan->transformed_goal_pose_, plan->goal_pose_.pose);
+    plan->goal_pose_.header.frame_id = planning_scene_->getPlanningFrame();
+  }
 
-    // convert the pose we want to reach to a set of constraints
-    plan->goal_constraints_ = kinematic_constraints::constructGoalConstraints(plan->shared_data_->ik_link_->getName(), plan->goal_pose_);
+  // convert the pose we want to reach to a set of constraints
+  plan->goal_constraints_ = kinematic_constraints::constructGoalConstraints(plan->shared_data_->ik_link_->getName(), plan->goal_pose_);
 
-    const std::string &planning_group = plan->shared_data_->planning_group_->getName();
+  const std::string &planning_group = plan->shared_data_->planning_group_->getName();
 
-    // construct a sampler for the specified constraints; this can end up calling just IK, but it is more general
-    // and allows for robot-specific samplers, producing samples that also change the base position if needed, etc
-    plan->goal_sampler_ = constraints_sampler_manager_->selectSampler(planning_scene_, planning_group, plan->goal_constraints_);
-    if (plan->goal_sampler_)
+  // construct a sampler for the specified constraints; this can end up calling just IK, but it is more general
+  // and allows for robot-specific samplers, producing samples that also change the base position if needed, etc
+  plan->goal_sampler_ = constraints_sampler_manager_->selectSampler(planning_scene_, planning_group, plan->goal_constraints_);
+  if (plan->goal_sampler_)
+  {
+    plan->goal_sampler_->setGroupStateValidityCallback(boost::bind(&isStateCollisionFree, planning_scene_.get(), collision_matrix_.get(),
+                                                                   verbose_, plan.get(), _1, _2, _3));
+    plan->goal_sampler_->setVerbose(verbose_);
+    if (plan->goal_sampler_->sample(token_state, plan->shared_data_->max_goal_sampling_attempts_))
     {
-      plan->goal_sampler_->setGroupStateValidityCallback(boost::bind(&isStateCollisionFree, planning_scene_.get(), collision_matrix_.get(),
-                                                                     verbose_, plan.get(), _1, _2, _3));
-      plan->goal_sampler_->setVerbose(verbose_);
-      if (plan->goal_sampler_->sample(*token_state, plan->shared_data_->max_goal_sampling_attempts_))
-      {
-        plan->possible_goal_states_.push_back(token_state);
-        return true;
-      }
-      else
-        if (verbose_)
-          ROS_INFO("Sampler failed to produce a state");
+      plan->possible_goal_states_.push_back(robot_state::RobotStatePtr(new robot_state::RobotState(token_state)));
+      return true;
     }
     else
-      ROS_ERROR_THROTTLE(1, "No sampler was constructed");
+      if (verbose_)
+        ROS_INFO("Sampler failed to produce a state");
   }
+  else
+    ROS_ERROR_THROTTLE(1, "No sampler was constructed");
   plan->error_code_.val = moveit_msgs::MoveItErrorCodes::GOAL_IN_COLLISION;
   return false;
 }
@@ -35,6 +35,7 @@
 /* Author: Ioan Sucan */
 
 #include "cartesian_path_service_capability.h"
+#include "kinematics_solver_utils.h"
 #include <moveit/robot_state/conversions.h>
 #include <moveit/kinematic_constraints/utils.h>
 #include <moveit/collision_detection/collision_tools.h>
@@ -42,15 +43,41 @@
 #include <moveit/move_group/capability_names.h>
 #include <moveit/planning_pipeline/planning_pipeline.h>
 #include <moveit_msgs/DisplayTrajectory.h>
+#include <boost/thread.hpp>
+#include <limits>
 
 move_group::MoveGroupCartesianPathService::MoveGroupCartesianPathService() :
   MoveGroupCapability("CartesianPathService"),
-  display_computed_paths_(true)
+  display_computed_paths_(true),
+  eef_speed_(0.0),
+  num_threads_(0),
+  max_acceleration_passes_(100)
 {
 }
 
 void move_group::MoveGroupCartesianPathService::initialize()
 {
+  node_handle_.param("cartesian_path_eef_speed", eef_speed_, 0.0);
+  int num_threads = 0;
+  node_handle_.param("cartesian_path_threads", num_threads, 0);
+  num_threads_ = num_threads > 0 ? num_threads : boost::thread::hardware_concurrency();
+  int max_acceleration_passes = max_acceleration_passes_;
+  node_handle_.param("cartesian_path_max_acceleration_passes", max_acceleration_passes, max_acceleration_passes);
+  max_acceleration_passes_ = std::max(max_acceleration_passes, 1);
+
+  // allocate the solvers of the worker threads now, so the first long path does not pay for their construction
+  if (num_threads_ > 1)
+  {
+    const std::vector<const robot_model::JointModelGroup*> &groups = context_->planning_scene_monitor_->getRobotModel()->getJointModelGroups();
+    for (std::size_t i = 0 ; i < groups.size() ; ++i)
+      if (groups[i]->getSolverInstance())
+      {
+        std::vector<kinematics::KinematicsBasePtr> solvers;
+        solvers_.acquire(groups[i], num_threads_, solvers);
+        solvers_.release(groups[i], solvers);
+      }
+  }
+
   display_path_ = node_handle_.advertise<moveit_msgs::DisplayTrajectory>(planning_pipeline::PlanningPipeline::DISPLAY_PATH_TOPIC, 10, true);
   cartesian_path_service_ = root_node_handle_.advertiseService(CARTESIAN_PATH_SERVICE_NAME, &MoveGroupCartesianPathService::computeService, this);
 }
@@ -67,6 +94,262 @@ bool isStateValid(const planning_scene::PlanningScene *planning_scene,
   return (!planning_scene || !planning_scene->isStateColliding(*state, group->getName())) &&
     (!constraint_set || constraint_set->decide(*state).satisfied);
 }
+
+// the fewest number of interpolated poses each thread should be given; shorter paths are computed serially
+static const std::size_t MIN_POSES_PER_THREAD = 32;
+
+// factor by which the joint-space distance between two consecutive chunks may exceed the average step within a chunk
+static const double DEFAULT_CHUNK_CONTINUITY_FACTOR = 4.0;
+
+// duration used for path segments when neither an end-effector speed nor joint velocity limits are available
+static const double DEFAULT_SEGMENT_DURATION = 0.2;
+
+/* Compute the poses the link needs to go through, in the same way RobotState::computeCartesianPath() does.
+   For every pose, the fraction of the path that is completed once that pose is reached is also stored. */
+void interpolateCartesianPath(const Eigen::Affine3d &start_pose, const EigenSTL::vector_Affine3d &waypoints, bool global_frame, double max_step,
+                              EigenSTL::vector_Affine3d &poses, std::vector<double> &progress)
+{
+  Eigen::Affine3d from = start_pose;
+  for (std::size_t w = 0 ; w < waypoints.size() ; ++w)
+  {
+    Eigen::Affine3d to = global_frame ? waypoints[w] : from * waypoints[w];
+    Eigen::Quaterniond from_quaternion(from.rotation());
+    Eigen::Quaterniond to_quaternion(to.rotation());
+    std::size_t steps = floor((to.translation() - from.translation()).norm() / max_step) + 1;
+    for (std::size_t i = 1 ; i <= steps ; ++i)
+    {
+      double percentage = (double)i / (double)steps;
+      Eigen::Affine3d pose(from_quaternion.slerp(percentage, to_quaternion));
+      pose.translation() = percentage * to.translation() + (1 - percentage) * from.translation();
+      poses.push_back(pose);
+      progress.push_back(((double)w + percentage) / (double)waypoints.size());
+    }
+    from = to;
+  }
+}
+
+/* Solve IK for poses [begin, end), each seeded by the solution of the previous one; the first one is seeded by \e seed.
+   Solving stops at the first pose for which no solution is found. */
+void solveCartesianChain(const kinematics::KinematicsBaseConstPtr &solver, const robot_state::RobotState &seed,
+                         const robot_model::JointModelGroup *jmg, const EigenSTL::vector_Affine3d &poses, std::size_t begin, std::size_t end,
+                         const robot_state::GroupStateValidityCallbackFn &constraint, std::vector<robot_state::RobotStatePtr> *chain)
+{
+  robot_state::RobotState state(seed);
+  chain->clear();
+  chain->reserve(end - begin);
+  for (std::size_t i = begin ; i < end ; ++i)
+  {
+    if (!move_group::setFromIKWithSolver(solver, state, jmg, poses[i], 1, 0.0, constraint))
+      break;
+    chain->push_back(robot_state::RobotStatePtr(new robot_state::RobotState(state)));
+  }
+}
+
+// same as solveCartesianChain(), with arguments passed by pointer so it can be bound to a thread
+void solveCartesianChainThread(const kinematics::KinematicsBasePtr *solver, const robot_state::RobotState *seed, const robot_model::JointModelGroup *jmg,
+                               const EigenSTL::vector_Affine3d *poses, std::size_t begin, std::size_t end,
+                               const robot_state::GroupStateValidityCallbackFn *constraint, std::vector<robot_state::RobotStatePtr> *chain)
+{
+  solveCartesianChain(*solver, *seed, jmg, *poses, begin, end, *constraint, chain);
+}
+
+double averageStepDistance(const std::vector<robot_state::RobotStatePtr> &chain, const robot_model::JointModelGroup *jmg)
+{
+  if (chain.size() < 2)
+    return 0.0;
+  double total = 0.0;
+  for (std::size_t i = 1 ; i < chain.size() ; ++i)
+    total += chain[i]->distance(*chain[i - 1], jmg);
+  return total / (double)(chain.size() - 1);
+}
+
+/* Compute a Cartesian path through the interpolated \e poses by splitting them into one chunk per solver; the chunks are solved in parallel.
+   The first pose of every chunk is solved serially first, each seeded by the previous one, so that the chunks are seeded along
+   the same IK branch. Chunks that are still not continuous with their predecessor (or could not be seeded) are re-solved serially
+   from the end of the predecessor. Returns false if the IK solvers cannot be used directly; in that case \e traj is not modified. */
+bool computeCartesianPathParallel(const robot_state::RobotState &start_state, const robot_model::JointModelGroup *jmg,
+                                  std::vector<robot_state::RobotStatePtr> &traj, const robot_model::LinkModel *link,
+                                  const EigenSTL::vector_Affine3d &poses, const std::vector<double> &progress, double jump_threshold,
+                                  const robot_state::GroupStateValidityCallbackFn &constraint,
+                                  const std::vector<kinematics::KinematicsBasePtr> &solvers, double &fraction)
+{
+  std::size_t num_chunks = solvers.size();
+  if (!link || num_chunks < 2 || poses.size() < num_chunks)
+    return false;
+
+  const kinematics::KinematicsBasePtr &solver = solvers[0];
+  if (!move_group::canSetFromIKWithSolver(solver, jmg, link->getName()))
+    return false;
+
+  std::vector<std::size_t> bounds(num_chunks + 1);
+  for (std::size_t k = 0 ; k <= num_chunks ; ++k)
+    bounds[k] = k * poses.size() / num_chunks;
+
+  // compute the seeds of all chunks
+  std::vector<robot_state::RobotStatePtr> seeds(num_chunks);
+  seeds[0].reset(new robot_state::RobotState(start_state));
+  for (std::size_t k = 1 ; k < num_chunks ; ++k)
+  {
+    robot_state::RobotStatePtr seed(new robot_state::RobotState(*seeds[k - 1]));
+    if (!move_group::setFromIKWithSolver(solver, *seed, jmg, poses[bounds[k]], 1, 0.0, constraint))
+      break;
+    seeds[k] = seed;
+  }
+
+  std::vector<std::vector<robot_state::RobotStatePtr> > chains(num_chunks);
+  {
+    boost::thread_group threads;
+    for (std::size_t k = 0 ; k < num_chunks ; ++k)
+      if (seeds[k])
+        threads.create_thread(boost::bind(&solveCartesianChainThread, &solvers[k], seeds[k].get(), jmg, &poses, bounds[k], bounds[k + 1],
+                                          &constraint, &chains[k]));
+    threads.join_all();
+  }
+
+  // stitch the chunks together, re-solving the ones that do not connect to their predecessor
+  double continuity_factor = jump_threshold > 0.0 ? jump_threshold : DEFAULT_CHUNK_CONTINUITY_FACTOR;
+  traj.clear();
+  traj.reserve(poses.size() + 1);
+  traj.push_back(robot_state::RobotStatePtr(new robot_state::RobotState(start_state)));
+  std::size_t solved = 0;
+  for (std::size_t k = 0 ; k < num_chunks ; ++k)
+  {
+    bool resolve = chains[k].empty();
+    if (!resolve && k > 0)
+    {
+      double step = std::max(averageStepDistance(chains[k - 1], jmg), averageStepDistance(chains[k], jmg));
+      resolve = chains[k].front()->distance(*traj.back(), jmg) > continuity_factor * step;
+    }
+    if (resolve)
+    {
+      ROS_DEBUG("Re-solving Cartesian path segment %u of %u serially", (unsigned int)k, (unsigned int)num_chunks);
+      solveCartesianChain(solver, *traj.back(), jmg, poses, bounds[k], bounds[k + 1], constraint, &chains[k]);
+    }
+    traj.insert(traj.end(), chains[k].begin(), chains[k].end());
+    solved += chains[k].size();
+    if (chains[k].size() < bounds[k + 1] - bounds[k])
+      break;
+  }
+  fraction = solved > 0 ? progress[solved - 1] : 0.0;
+
+  // truncate the path at the first jump in joint space, as RobotState::computeCartesianPath() does
+  if (jump_threshold > 0.0 && traj.size() > 1)
+  {
+    std::vector<double> dist_vector(traj.size() - 1);
+    double total_dist = 0.0;
+    for (std::size_t i = 1 ; i < traj.size() ; ++i)
+    {
+      dist_vector[i - 1] = traj[i]->distance(*traj[i - 1], jmg);
+      total_dist += dist_vector[i - 1];
+    }
+    double thres = jump_threshold * (total_dist / (double)dist_vector.size());
+    for (std::size_t i = 0 ; i < dist_vector.size() ; ++i)
+      if (dist_vector[i] > thres)
+      {
+        ROS_DEBUG("Truncating Cartesian path due to detected jump in joint-space distance");
+        fraction *= (double)i / (double)dist_vector.size();
+        traj.resize(i);
+        break;
+      }
+  }
+
+  return true;
+}
+
+/* Compute the durations of the segments of \e trajectory so that \e link moves at most at \e eef_speed (if positive),
+   and the joints of the group stay within their velocity and acceleration limits. Velocities and accelerations are
+   filled in for every waypoint as well. At most \e max_acceleration_passes passes are made to bring accelerations within limits. */
+void computeTimeStamps(robot_trajectory::RobotTrajectory &trajectory, const robot_model::LinkModel *link, double eef_speed,
+                       unsigned int max_acceleration_passes)
+{
+  const std::size_t num_points = trajectory.getWayPointCount();
+  const robot_model::JointModelGroup *jmg = trajectory.getGroup();
+  if (num_points == 0 || !jmg)
+    return;
+
+  const std::vector<std::string> &vars = jmg->getVariableNames();
+  const std::vector<int> &idx = jmg->getVariableIndexList();
+  std::vector<double> max_velocity(vars.size(), 0.0);
+  std::vector<double> max_acceleration(vars.size(), 0.0);
+  for (std::size_t j = 0 ; j < vars.size() ; ++j)
+  {
+    const robot_model::VariableBounds &b = trajectory.getRobotModel()->getVariableBounds(vars[j]);
+    if (b.velocity_bounded_)
+      max_velocity[j] = std::min(fabs(b.max_velocity_), fabs(b.min_velocity_));
+    if (b.acceleration_bounded_)
+      max_acceleration[j] = std::min(fabs(b.max_acceleration_), fabs(b.min_acceleration_));
+  }
+
+  // durations[i] is the time it takes to go from waypoint i - 1 to waypoint i
+  std::vector<double> durations(num_points, 0.0);
+  for (std::size_t i = 1 ; i < num_points ; ++i)
+  {
+    const robot_state::RobotState &prev = trajectory.getWayPoint(i - 1);
+    const robot_state::RobotState &curr = trajectory.getWayPoint(i);
+    double dt = 0.0;
+    if (eef_speed > 0.0 && link)
+      dt = (curr.getGlobalLinkTransform(link).translation() - prev.getGlobalLinkTransform(link).translation()).norm() / eef_speed;
+    for (std::size_t j = 0 ; j < vars.size() ; ++j)
+      if (max_velocity[j] > 0.0)
+        dt = std::max(dt, fabs(curr.getVariablePosition(idx[j]) - prev.getVariablePosition(idx[j])) / max_velocity[j]);
+    durations[i] = dt > std::numeric_limits<double>::epsilon() ? dt : DEFAULT_SEGMENT_DURATION;
+  }
+
+  // stretch the segments around waypoints where acceleration limits are exceeded; stretching a segment by a factor f
+  // scales the acceleration at its ends by 1/f^2
+  bool changed = true;
+  for (unsigned int pass = 0 ; changed && pass < max_acceleration_passes ; ++pass)
+  {
+    changed = false;
+    for (std::size_t i = 0 ; i < num_points ; ++i)
+    {
+      double dt_in = i > 0 ? durations[i] : 0.0;
+      double dt_out = i + 1 < num_points ? durations[i + 1] : 0.0;
+      if (dt_in + dt_out <= 0.0)
+        continue;
+      double dt_avg = (dt_in > 0.0 && dt_out > 0.0) ? (dt_in + dt_out) / 2.0 : dt_in + dt_out;
+      double scale = 1.0;
+      for (std::size_t j = 0 ; j < vars.size() ; ++j)
+      {
+        if (max_acceleration[j] <= 0.0)
+          continue;
+        double q = trajectory.getWayPoint(i).getVariablePosition(idx[j]);
+        double v_in = i > 0 ? (q - trajectory.getWayPoint(i - 1).getVariablePosition(idx[j])) / dt_in : 0.0;
+        double v_out = i + 1 < num_points ? (trajectory.getWayPoint(i + 1).getVariablePosition(idx[j]) - q) / dt_out : 0.0;
+        double acc = fabs(v_out - v_in) / dt_avg;
+        if (acc > max_acceleration[j])
+          scale = std::max(scale, sqrt(acc / max_acceleration[j]));
+      }
+      if (scale > 1.0 + std::numeric_limits<float>::epsilon())
+      {
+        if (i > 0)
+          durations[i] *= scale;
+        if (i + 1 < num_points)
+          durations[i + 1] *= scale;
+        changed = true;
+      }
+    }
+  }
+  if (changed)
+    ROS_WARN("Accelerations along the Cartesian path may exceed the joint limits: they were still being reduced after %u passes "
+             "(see the 'cartesian_path_max_acceleration_passes' parameter)", max_acceleration_passes);
+
+  // store the timing, velocities and accelerations in the trajectory
+  for (std::size_t i = 0 ; i < num_points ; ++i)
+  {
+    trajectory.setWayPointDurationFromPrevious(i, durations[i]);
+    robot_state::RobotStatePtr state = trajectory.getWayPointPtr(i);
+    for (std::size_t j = 0 ; j < vars.size() ; ++j)
+    {
+      double q = state->getVariablePosition(idx[j]);
+      double v_in = i > 0 ? (q - trajectory.getWayPoint(i - 1).getVariablePosition(idx[j])) / durations[i] : 0.0;
+      double v_out = i + 1 < num_points ? (trajectory.getWayPoint(i + 1).getVariablePosition(idx[j]) - q) / durations[i + 1] : 0.0;
+      double dt = i > 0 && i + 1 < num_points ? (durations[i] + durations[i + 1]) / 2.0 : (i > 0 ? durations[i] : (num_points > 1 ? durations[i + 1] : 0.0));
+      state->setVariableVelocity(idx[j], i > 0 && i + 1 < num_points ? (v_in + v_out) / 2.0 : 0.0);
+      state->setVariableAcceleration(idx[j], dt > 0.0 ? (v_out - v_in) / dt : 0.0);
+    }
+  }
+}
 }
 
 bool move_group::MoveGroupCartesianPathService::computeService(moveit_msgs::GetCartesianPath::Request &req, moveit_msgs::GetCartesianPath::Response &res)
@@ -133,12 +416,27 @@ bool move_group::MoveGroupCartesianPathService::computeService(moveit_msgs::GetC
           ROS_INFO("Attempting to follow %u waypoints for link '%s' using a step of %lf m and jump threshold %lf (in %s reference frame)",
                    (unsigned int)waypoints.size(), link_name.c_str(), req.max_step, req.jump_threshold, global_frame ? "global" : "link");
           std::vector<robot_state::RobotStatePtr> traj;
-          res.fraction = start_state.computeCartesianPath(jmg, traj, start_state.getLinkModel(link_name), waypoints, global_frame, req.max_step, req.jump_threshold, constraint_fn);
+          const robot_model::LinkModel *link = start_state.getLinkModel(link_name);
+          // only paths long enough to give every thread MIN_POSES_PER_THREAD poses are solved in parallel
+          EigenSTL::vector_Affine3d poses;
+          std::vector<double> progress;
+          std::vector<kinematics::KinematicsBasePtr> solvers;
+          if (link && num_threads_ > 1)
+          {
+            interpolateCartesianPath(start_state.getGlobalLinkTransform(link), waypoints, global_frame, req.max_step, poses, progress);
+            std::size_t num_chunks = std::min<std::size_t>(num_threads_, poses.size() / MIN_POSES_PER_THREAD);
+            if (num_chunks > 1)
+              solvers_.acquire(jmg, num_chunks, solvers);
+          }
+          if (!computeCartesianPathParallel(start_state, jmg, traj, link, poses, progress, req.jump_threshold, constraint_fn, solvers, res.fraction))
+            res.fraction = start_state.computeCartesianPath(jmg, traj, link, waypoints, global_frame, req.max_step, req.jump_threshold, constraint_fn);
+          solvers_.release(jmg, solvers);
           robot_state::robotStateToRobotStateMsg(start_state, res.start_state);
           
           robot_trajectory::RobotTrajectory rt(context_->planning_scene_monitor_->getRobotModel(), req.group_name);
           for (std::size_t i = 0 ; i < traj.size() ; ++i)
-            rt.addSuffixWayPoint(traj[i], 0.2); // \todo make 0.2 a param; better: compute time stemps based on eef distance and param m/s speed for eef;
+            rt.addSuffixWayPoint(traj[i], 0.0);
+          computeTimeStamps(rt, link, eef_speed_, max_acceleration_passes_);
           rt.getRobotTrajectoryMsg(res.solution);
           ROS_INFO("Computed Cartesian path with %u points (followed %lf%% of requested trajectory)", (unsigned int)traj.size(), res.fraction * 100.0);
           if (display_computed_paths_ && rt.getWayPointCount() > 0)
@@ -39,6 +39,7 @@
 
 #include <moveit/move_group/move_group_capability.h>
 #include <moveit_msgs/GetCartesianPath.h>
+#include "kinematics_solver_utils.h"
 
 namespace move_group
 {
@@ -58,6 +59,18 @@ private:
   ros::ServiceServer cartesian_path_service_;
   ros::Publisher display_path_;
   bool display_computed_paths_;
+
+  /// The maximum speed (m/s) of the link following the Cartesian path; if 0, timing is limited only by the joint limits
+  double eef_speed_;
+
+  /// The number of threads used to solve IK along the path; if 0, the number of hardware threads is used
+  unsigned int num_threads_;
+
+  /// The maximum number of passes made to bring accelerations along a path within the joint limits
+  unsigned int max_acceleration_passes_;
+
+  /// The solver instances used by the threads that solve IK along a path, kept across requests
+  KinematicsSolverCache solvers_;
 };
 
 }
@@ -57,6 +57,7 @@ bool move_group::ClearOctomapService::clearOctomap(std_srvs::Empty::Request &req
 
   ROS_INFO("Clearing octomap...");
   context_->planning_scene_monitor_->clearOctomap();
+  context_->planning_scene_monitor_->triggerSceneUpdateEvent(planning_scene_monitor::PlanningSceneMonitor::UPDATE_GEOMETRY);
   ROS_INFO("Octomap cleared.");
   return true;
 }
@@ -36,23 +36,111 @@
 
 #include "get_planning_scene_service_capability.h"
 #include <moveit/move_group/capability_names.h>
+#include <boost/bind.hpp>
 
 move_group::MoveGroupGetPlanningSceneService::MoveGroupGetPlanningSceneService():
   MoveGroupCapability("GetPlanningSceneService")
 {
+  for (int i = 0 ; i < UPDATE_CATEGORY_COUNT ; ++i)
+    versions_[i] = 0;
 }
 
 void move_group::MoveGroupGetPlanningSceneService::initialize()
 {
+  context_->planning_scene_monitor_->addUpdateCallback(boost::bind(&MoveGroupGetPlanningSceneService::sceneUpdate, this, _1));
   get_scene_service_ = root_node_handle_.advertiseService(GET_PLANNING_SCENE_SERVICE_NAME, &MoveGroupGetPlanningSceneService::getPlanningSceneService, this);
 }
 
-bool move_group::MoveGroupGetPlanningSceneService::getPlanningSceneService(moveit_msgs::GetPlanningScene::Request &req, moveit_msgs::GetPlanningScene::Response &res)
+namespace
+{
+// the bit of UPDATE_SCENE not covered by the state, transforms and geometry bits
+static const unsigned int OTHER_SCENE_UPDATES = 8;
+
+// the update categories (as SceneUpdateType bits) that can change the part of the scene described by a component mask
+unsigned int getRelevantUpdates(uint32_t components)
+{
+  typedef moveit_msgs::PlanningSceneComponents C;
+  static const uint32_t KNOWN_COMPONENTS = C::SCENE_SETTINGS | C::ROBOT_STATE | C::ROBOT_STATE_ATTACHED_OBJECTS | C::WORLD_OBJECT_NAMES |
+    C::WORLD_OBJECT_GEOMETRY | C::OCTOMAP | C::TRANSFORMS | C::ALLOWED_COLLISION_MATRIX | C::LINK_PADDING_AND_SCALING | C::OBJECT_COLORS;
+
+  // be conservative about components we do not know about
+  if (components & ~KNOWN_COMPONENTS)
+    return planning_scene_monitor::PlanningSceneMonitor::UPDATE_SCENE;
+
+  unsigned int relevant = 0;
+  if (components & (C::ROBOT_STATE | C::ROBOT_STATE_ATTACHED_OBJECTS))
+    relevant |= planning_scene_monitor::PlanningSceneMonitor::UPDATE_STATE | planning_scene_monitor::PlanningSceneMonitor::UPDATE_GEOMETRY;
+  if (components & (C::WORLD_OBJECT_NAMES | C::WORLD_OBJECT_GEOMETRY | C::OCTOMAP | C::OBJECT_COLORS))
+    relevant |= planning_scene_monitor::PlanningSceneMonitor::UPDATE_GEOMETRY;
+  if (components & C::TRANSFORMS)
+    relevant |= planning_scene_monitor::PlanningSceneMonitor::UPDATE_TRANSFORMS;
+  // everything else (name, allowed collision matrix, padding, colors) changes with full scene updates
+  if (components & (C::SCENE_SETTINGS | C::ALLOWED_COLLISION_MATRIX | C::LINK_PADDING_AND_SCALING | C::OBJECT_COLORS))
+    relevant |= OTHER_SCENE_UPDATES;
+  return relevant;
+}
+}
+
+void move_group::MoveGroupGetPlanningSceneService::sceneUpdate(planning_scene_monitor::PlanningSceneMonitor::SceneUpdateType update_type)
+{
+  unsigned int bits = update_type;
+  // an update of unspecified type could have changed anything that is not otherwise categorized
+  if (bits == planning_scene_monitor::PlanningSceneMonitor::UPDATE_NONE)
+    bits = OTHER_SCENE_UPDATES;
+
+  boost::mutex::scoped_lock slock(cache_lock_);
+  for (int i = 0 ; i < UPDATE_CATEGORY_COUNT ; ++i)
+    if (bits & (1 << i))
+      ++versions_[i];
+}
+
+bool move_group::MoveGroupGetPlanningSceneService::getPlanningSceneService(moveit_msgs::GetPlanningScene::Request &req, SerializedGetPlanningSceneResponse &res)
 {
   if (req.components.components & moveit_msgs::PlanningSceneComponents::TRANSFORMS)
     context_->planning_scene_monitor_->updateFrameTransforms();
-  planning_scene_monitor::LockedPlanningSceneRO ps(context_->planning_scene_monitor_);
-  ps->getPlanningSceneMsg(res.scene, req.components);
+
+  const uint32_t components = req.components.components;
+  const unsigned int relevant = getRelevantUpdates(components);
+
+  // if the scene did not change in a way that matters for the requested components, reuse the previous response
+  {
+    boost::mutex::scoped_lock slock(cache_lock_);
+    std::map<uint32_t, CachedResponse>::const_iterator it = cache_.find(components);
+    if (it != cache_.end())
+    {
+      bool valid = true;
+      for (int i = 0 ; i < UPDATE_CATEGORY_COUNT && valid ; ++i)
+        if ((relevant & (1 << i)) && it->second.versions_[i] != versions_[i])
+          valid = false;
+      if (valid)
+      {
+        res = it->second.response_;
+        return true;
+      }
+    }
+  }
+
+  CachedResponse entry;
+  moveit_msgs::GetPlanningScene::Response response;
+  {
+    planning_scene_monitor::LockedPlanningSceneRO ps(context_->planning_scene_monitor_);
+    // updates are announced after the scene is modified, so versions read here are never newer than the scene content
+    {
+      boost::mutex::scoped_lock slock(cache_lock_);
+      for (int i = 0 ; i < UPDATE_CATEGORY_COUNT ; ++i)
+        entry.versions_[i] = versions_[i];
+    }
+    ps->getPlanningSceneMsg(response.scene, req.components);
+  }
+
+  entry.response_.size_ = ros::serialization::serializationLength(response);
+  entry.response_.data_.reset(new uint8_t[entry.response_.size_]);
+  ros::serialization::OStream stream(entry.response_.data_.get(), entry.response_.size_);
+  ros::serialization::serialize(stream, response);
+  res = entry.response_;
+
+  boost::mutex::scoped_lock slock(cache_lock_);
+  cache_[components] = entry;
   return true;
 }
 
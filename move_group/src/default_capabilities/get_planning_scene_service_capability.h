@@ -39,10 +39,25 @@
 
 #include <moveit/move_group/move_group_capability.h>
 #include <moveit_msgs/GetPlanningScene.h>
+#include <boost/shared_array.hpp>
+#include <cstring>
+#include <boost/thread/mutex.hpp>
+#include <map>
 
 namespace move_group
 {
 
+/** \brief A GetPlanningScene response that is already serialized. Responses are sent by copying the buffer. */
+struct SerializedGetPlanningSceneResponse
+{
+  SerializedGetPlanningSceneResponse() : size_(0)
+  {
+  }
+
+  boost::shared_array<uint8_t> data_;
+  uint32_t size_;
+};
+
 class MoveGroupGetPlanningSceneService : public MoveGroupCapability
 {
 public:
@@ -53,11 +68,145 @@ public:
 
 private:
 
-  bool getPlanningSceneService(moveit_msgs::GetPlanningScene::Request &req, moveit_msgs::GetPlanningScene::Response &res);
+  /* the updates of the planning scene are grouped in these categories; category i corresponds to bit (1 << i) of planning_scene_monitor::PlanningSceneMonitor::SceneUpdateType */
+  enum UpdateCategory
+    {
+      STATE_UPDATES = 0,
+      TRANSFORMS_UPDATES = 1,
+      GEOMETRY_UPDATES = 2,
+      OTHER_UPDATES = 3,
+      UPDATE_CATEGORY_COUNT = 4
+    };
+
+  struct CachedResponse
+  {
+    SerializedGetPlanningSceneResponse response_;
+    unsigned int versions_[UPDATE_CATEGORY_COUNT];
+  };
+
+  bool getPlanningSceneService(moveit_msgs::GetPlanningScene::Request &req, SerializedGetPlanningSceneResponse &res);
+  void sceneUpdate(planning_scene_monitor::PlanningSceneMonitor::SceneUpdateType update_type);
 
   ros::ServiceServer get_scene_service_;
+
+  /* responses per requested component mask, along with the version of the scene (for each update category) they were computed at */
+  std::map<uint32_t, CachedResponse> cache_;
+  unsigned int versions_[UPDATE_CATEGORY_COUNT];
+  boost::mutex cache_lock_;
+};
+
+}
+
+namespace ros
+{
+namespace message_traits
+{
+
+template<>
+struct MD5Sum<move_group::SerializedGetPlanningSceneResponse>
+{
+  static const char* value()
+  {
+    return MD5Sum<moveit_msgs::GetPlanningSceneResponse>::value();
+  }
+
+  static const char* value(const move_group::SerializedGetPlanningSceneResponse&)
+  {
+    return value();
+  }
+};
+
+template<>
+struct DataType<move_group::SerializedGetPlanningSceneResponse>
+{
+  static const char* value()
+  {
+    return DataType<moveit_msgs::GetPlanningSceneResponse>::value();
+  }
+
+  static const char* value(const move_group::SerializedGetPlanningSceneResponse&)
+  {
+    return value();
+  }
+};
+
+template<>
+struct Definition<move_group::SerializedGetPlanningSceneResponse>
+{
+  static const char* value()
+  {
+    return Definition<moveit_msgs::GetPlanningSceneResponse>::value();
+  }
+
+  static const char* value(const move_group::SerializedGetPlanningSceneResponse&)
+  {
+    return value();
+  }
+};
+
+}
+
+namespace service_traits
+{
+
+template<>
+struct MD5Sum<move_group::SerializedGetPlanningSceneResponse>
+{
+  static const char* value()
+  {
+    return MD5Sum<moveit_msgs::GetPlanningSceneResponse>::value();
+  }
+
+  static const char* value(const move_group::SerializedGetPlanningSceneResponse&)
+  {
+    return value();
+  }
 };
 
+template<>
+struct DataType<move_group::SerializedGetPlanningSceneResponse>
+{
+  static const char* value()
+  {
+    return DataType<moveit_msgs::GetPlanningSceneResponse>::value();
+  }
+
+  static const char* value(const move_group::SerializedGetPlanningSceneResponse&)
+  {
+    return value();
+  }
+};
+
+}
+
+namespace serialization
+{
+
+template<>
+struct Serializer<move_group::SerializedGetPlanningSceneResponse>
+{
+  template<typename Stream>
+  inline static void write(Stream& stream, const move_group::SerializedGetPlanningSceneResponse& m)
+  {
+    if (m.size_ > 0)
+      memcpy(stream.advance(m.size_), m.data_.get(), m.size_);
+  }
+
+  template<typename Stream>
+  inline static void read(Stream& stream, move_group::SerializedGetPlanningSceneResponse& m)
+  {
+    m.size_ = stream.getLength();
+    m.data_.reset(new uint8_t[m.size_]);
+    memcpy(m.data_.get(), stream.advance(m.size_), m.size_);
+  }
+
+  inline static uint32_t serializedLength(const move_group::SerializedGetPlanningSceneResponse& m)
+  {
+    return m.size_;
+  }
+};
+
+}
 }
 
 #endif
@@ -35,10 +35,13 @@
 /* Author: Ioan Sucan */
 
 #include "kinematics_service_capability.h"
+#include "kinematics_solver_utils.h"
 #include <moveit/robot_state/conversions.h>
 #include <moveit/kinematic_constraints/utils.h>
 #include <eigen_conversions/eigen_msg.h>
 #include <moveit/move_group/capability_names.h>
+#include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
 
 move_group::MoveGroupKinematicsService::MoveGroupKinematicsService():
   MoveGroupCapability("KinematicsService")
@@ -49,6 +52,7 @@ void move_group::MoveGroupKinematicsService::initialize()
 {
   fk_service_ = root_node_handle_.advertiseService(FK_SERVICE_NAME, &MoveGroupKinematicsService::computeFKService, this);
   ik_service_ = root_node_handle_.advertiseService(IK_SERVICE_NAME, &MoveGroupKinematicsService::computeIKService, this);
+  ik_batch_service_ = root_node_handle_.advertiseService(IK_BATCH_SERVICE_NAME, &MoveGroupKinematicsService::computeIKBatchService, this);
 }
 
 namespace
@@ -139,6 +143,143 @@ void move_group::MoveGroupKinematicsService::computeIK(moveit_msgs::PositionIKRe
     error_code.val = moveit_msgs::MoveItErrorCodes::INVALID_GROUP_NAME;
 }
 
+bool move_group::MoveGroupKinematicsService::computeIKWithSolver(const kinematics::KinematicsBasePtr &solver,
+                                                                 moveit_msgs::PositionIKRequest &req,
+                                                                 moveit_msgs::RobotState &solution,
+                                                                 moveit_msgs::MoveItErrorCodes &error_code,
+                                                                 robot_state::RobotState &rs,
+                                                                 const robot_state::GroupStateValidityCallbackFn &constraint) const
+{
+  if (req.pose_stamped_vector.size() > 1)
+    return false;
+
+  // only the tip of the solver can be handled directly; the caller reports other requests as unsupported
+  geometry_msgs::PoseStamped req_pose = req.pose_stamped_vector.empty() ? req.pose_stamped : req.pose_stamped_vector[0];
+  std::string ik_link = req.pose_stamped_vector.empty() ? (req.ik_link_names.empty() ? "" : req.ik_link_names[0]) : req.ik_link_name;
+  const robot_state::JointModelGroup *jmg = rs.getJointModelGroup(req.group_name);
+  if (!canSetFromIKWithSolver(solver, jmg, ik_link))
+    return false;
+
+  robot_state::robotStateMsgToRobotState(req.robot_state, rs);
+  const std::string &default_frame = context_->planning_scene_monitor_->getRobotModel()->getModelFrame();
+  if (performTransform(req_pose, default_frame))
+  {
+    Eigen::Affine3d pose;
+    tf::poseMsgToEigen(req_pose.pose, pose);
+    if (setFromIKWithSolver(solver, rs, jmg, pose, req.attempts, req.timeout.toSec(), constraint))
+    {
+      robot_state::robotStateToRobotStateMsg(rs, solution, false);
+      error_code.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+    }
+    else
+      error_code.val = moveit_msgs::MoveItErrorCodes::NO_IK_SOLUTION;
+  }
+  else
+    error_code.val = moveit_msgs::MoveItErrorCodes::FRAME_TRANSFORM_FAILURE;
+  return true;
+}
+
+void move_group::MoveGroupKinematicsService::computeIKBatchThread(moveit_ros_move_group::GetPositionIKBatch::Request *req,
+                                                                  moveit_ros_move_group::GetPositionIKBatch::Response *res,
+                                                                  const planning_scene::PlanningScene *scene,
+                                                                  std::size_t *next_request, boost::mutex *next_request_lock)
+{
+  // each thread works with its own robot state and its own kinematics solver instances, taken from the ones kept by
+  // the capability and returned when the thread is done
+  robot_state::RobotState rs = scene->getCurrentState();
+  std::map<const robot_model::JointModelGroup*, kinematics::KinematicsBasePtr> solvers;
+
+  while (true)
+  {
+    std::size_t index;
+    {
+      boost::mutex::scoped_lock slock(*next_request_lock);
+      if (*next_request >= req->ik_requests.size())
+        break;
+      index = (*next_request)++;
+    }
+
+    ros::WallTime start = ros::WallTime::now();
+    moveit_msgs::PositionIKRequest &ik_request = req->ik_requests[index];
+    const robot_model::JointModelGroup *jmg = rs.getJointModelGroup(ik_request.group_name);
+    if (!jmg)
+    {
+      res->error_codes[index].val = moveit_msgs::MoveItErrorCodes::INVALID_GROUP_NAME;
+      res->solve_times[index] = (ros::WallTime::now() - start).toSec();
+      continue;
+    }
+
+    std::map<const robot_model::JointModelGroup*, kinematics::KinematicsBasePtr>::iterator it = solvers.find(jmg);
+    if (it == solvers.end())
+      it = solvers.insert(std::make_pair(jmg, batch_solvers_.acquire(jmg))).first;
+
+    rs = scene->getCurrentState();
+    robot_state::GroupStateValidityCallbackFn constraint;
+    boost::scoped_ptr<kinematic_constraints::KinematicConstraintSet> kset;
+    if (!kinematic_constraints::isEmpty(ik_request.constraints))
+    {
+      kset.reset(new kinematic_constraints::KinematicConstraintSet(scene->getRobotModel()));
+      kset->add(ik_request.constraints, scene->getTransforms());
+    }
+    if (ik_request.avoid_collisions || (kset && !kset->empty()))
+      constraint = boost::bind(&isIKSolutionValid, ik_request.avoid_collisions ? scene : NULL,
+                               (kset && !kset->empty()) ? kset.get() : NULL, _1, _2, _3);
+
+    // the instance shared through the joint model group is not thread safe, so requests the solver owned by this
+    // thread cannot handle are reported as failures instead of being forwarded to the shared instance
+    if (!computeIKWithSolver(it->second, ik_request, res->solutions[index], res->error_codes[index], rs, constraint))
+    {
+      if (!it->second)
+        ROS_ERROR("Unable to allocate a kinematics solver for group '%s'; IK request %u is not solved",
+                  ik_request.group_name.c_str(), (unsigned int)index);
+      else
+        ROS_ERROR("IK request %u for group '%s' specifies multiple poses or a link other than the solver tip ('%s'); "
+                  "such requests are not supported in batch mode", (unsigned int)index, ik_request.group_name.c_str(),
+                  it->second->getTipFrame().c_str());
+      res->error_codes[index].val = moveit_msgs::MoveItErrorCodes::FAILURE;
+    }
+    res->solve_times[index] = (ros::WallTime::now() - start).toSec();
+  }
+
+  for (std::map<const robot_model::JointModelGroup*, kinematics::KinematicsBasePtr>::const_iterator it = solvers.begin() ; it != solvers.end() ; ++it)
+    batch_solvers_.release(it->first, it->second);
+}
+
+bool move_group::MoveGroupKinematicsService::computeIKBatchService(moveit_ros_move_group::GetPositionIKBatch::Request &req,
+                                                                   moveit_ros_move_group::GetPositionIKBatch::Response &res)
+{
+  res.solutions.resize(req.ik_requests.size());
+  res.error_codes.resize(req.ik_requests.size());
+  res.solve_times.resize(req.ik_requests.size(), 0.0);
+  if (req.ik_requests.empty())
+    return true;
+
+  context_->planning_scene_monitor_->updateFrameTransforms();
+
+  // all requests are solved against the same copy of the scene, so the monitor does not need to stay locked
+  planning_scene::PlanningScenePtr scene = planning_scene::PlanningScene::clone(planning_scene_monitor::LockedPlanningSceneRO(context_->planning_scene_monitor_));
+
+  std::size_t num_threads = req.num_threads > 0 ? req.num_threads : boost::thread::hardware_concurrency();
+  num_threads = std::max<std::size_t>(1, std::min(num_threads, req.ik_requests.size()));
+
+  ROS_DEBUG("Solving %u IK requests using %u threads", (unsigned int)req.ik_requests.size(), (unsigned int)num_threads);
+
+  std::size_t next_request = 0;
+  boost::mutex next_request_lock;
+  if (num_threads == 1)
+    computeIKBatchThread(&req, &res, scene.get(), &next_request, &next_request_lock);
+  else
+  {
+    boost::thread_group threads;
+    for (std::size_t i = 0 ; i < num_threads ; ++i)
+      threads.create_thread(boost::bind(&MoveGroupKinematicsService::computeIKBatchThread, this, &req, &res,
+                                        scene.get(), &next_request, &next_request_lock));
+    threads.join_all();
+  }
+
+  return true;
+}
+
 bool move_group::MoveGroupKinematicsService::computeIKService(moveit_msgs::GetPositionIK::Request &req, moveit_msgs::GetPositionIK::Response &res)
 {
   context_->planning_scene_monitor_->updateFrameTransforms();
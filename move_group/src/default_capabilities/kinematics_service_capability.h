@@ -40,6 +40,10 @@
 #include <moveit/move_group/move_group_capability.h>
 #include <moveit_msgs/GetPositionIK.h>
 #include <moveit_msgs/GetPositionFK.h>
+#include <moveit_ros_move_group/GetPositionIKBatch.h>
+#include <moveit/kinematics_base/kinematics_base.h>
+#include "kinematics_solver_utils.h"
+#include <boost/thread/mutex.hpp>
 
 namespace move_group
 {
@@ -56,13 +60,28 @@ private:
 
   bool computeIKService(moveit_msgs::GetPositionIK::Request &req, moveit_msgs::GetPositionIK::Response &res);
   bool computeFKService(moveit_msgs::GetPositionFK::Request &req, moveit_msgs::GetPositionFK::Response &res);
+  bool computeIKBatchService(moveit_ros_move_group::GetPositionIKBatch::Request &req, moveit_ros_move_group::GetPositionIKBatch::Response &res);
 
   void computeIK(moveit_msgs::PositionIKRequest &req, moveit_msgs::RobotState &solution, moveit_msgs::MoveItErrorCodes &error_code,
                  robot_state::RobotState &rs, const robot_state::GroupStateValidityCallbackFn &constraint = robot_state::GroupStateValidityCallbackFn()) const;
 
+  /** \brief Solve a single-pose IK request using the kinematics solver instance \e solver (owned by the calling thread),
+      rather than the instance shared through the joint model group. Returns false if the request cannot be handled this way
+      (e.g., the IK link is not the tip of the solver); in that case no output is modified. */
+  bool computeIKWithSolver(const kinematics::KinematicsBasePtr &solver, moveit_msgs::PositionIKRequest &req,
+                           moveit_msgs::RobotState &solution, moveit_msgs::MoveItErrorCodes &error_code,
+                           robot_state::RobotState &rs, const robot_state::GroupStateValidityCallbackFn &constraint) const;
+
+  void computeIKBatchThread(moveit_ros_move_group::GetPositionIKBatch::Request *req,
+                            moveit_ros_move_group::GetPositionIKBatch::Response *res,
+                            const planning_scene::PlanningScene *scene, std::size_t *next_request, boost::mutex *next_request_lock);
+
   ros::ServiceServer fk_service_;
   ros::ServiceServer ik_service_;
+  ros::ServiceServer ik_batch_service_;
 
+  /// The solver instances used by the threads of batch requests, kept across requests
+  KinematicsSolverCache batch_solvers_;
 };
 
 }
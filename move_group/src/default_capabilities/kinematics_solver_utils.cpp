@@ -0,0 +1,183 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "kinematics_solver_utils.h"
+#include <eigen_conversions/eigen_msg.h>
+#include <limits>
+
+namespace move_group
+{
+
+namespace
+{
+void ikCallbackFnAdapter(robot_state::RobotState *state, const robot_model::JointModelGroup *jmg,
+                         const std::vector<unsigned int> &bij, const robot_state::GroupStateValidityCallbackFn &constraint,
+                         const geometry_msgs::Pose &, const std::vector<double> &ik_sol, moveit_msgs::MoveItErrorCodes &error_code)
+{
+  std::vector<double> solution(bij.size());
+  for (std::size_t i = 0 ; i < bij.size() ; ++i)
+    solution[bij[i]] = ik_sol[i];
+  if (constraint(state, jmg, &solution[0]))
+    error_code.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+  else
+    error_code.val = moveit_msgs::MoveItErrorCodes::NO_IK_SOLUTION;
+}
+}
+
+kinematics::KinematicsBasePtr allocKinematicsSolverInstance(const robot_model::JointModelGroup *jmg)
+{
+  kinematics::KinematicsBasePtr solver;
+  if (jmg)
+  {
+    const robot_model::SolverAllocatorFn &allocator = jmg->getGroupKinematics().first.allocator_;
+    if (allocator)
+      solver = allocator(jmg);
+  }
+  return solver;
+}
+
+void KinematicsSolverCache::acquire(const robot_model::JointModelGroup *jmg, std::size_t count,
+                                    std::vector<kinematics::KinematicsBasePtr> &solvers)
+{
+  solvers.clear();
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    std::vector<kinematics::KinematicsBasePtr> &idle = idle_[jmg->getName()];
+    while (solvers.size() < count && !idle.empty())
+    {
+      solvers.push_back(idle.back());
+      idle.pop_back();
+    }
+  }
+
+  // allocating solvers can be expensive, so this is done without holding the lock
+  while (solvers.size() < count)
+  {
+    kinematics::KinematicsBasePtr solver = allocKinematicsSolverInstance(jmg);
+    if (!solver)
+    {
+      release(jmg, solvers);
+      solvers.clear();
+      return;
+    }
+    solvers.push_back(solver);
+  }
+}
+
+kinematics::KinematicsBasePtr KinematicsSolverCache::acquire(const robot_model::JointModelGroup *jmg)
+{
+  std::vector<kinematics::KinematicsBasePtr> solvers;
+  acquire(jmg, 1, solvers);
+  return solvers.empty() ? kinematics::KinematicsBasePtr() : solvers[0];
+}
+
+void KinematicsSolverCache::release(const robot_model::JointModelGroup *jmg, const std::vector<kinematics::KinematicsBasePtr> &solvers)
+{
+  if (solvers.empty())
+    return;
+  boost::mutex::scoped_lock slock(lock_);
+  std::vector<kinematics::KinematicsBasePtr> &idle = idle_[jmg->getName()];
+  idle.insert(idle.end(), solvers.begin(), solvers.end());
+}
+
+void KinematicsSolverCache::release(const robot_model::JointModelGroup *jmg, const kinematics::KinematicsBasePtr &solver)
+{
+  if (solver)
+    release(jmg, std::vector<kinematics::KinematicsBasePtr>(1, solver));
+}
+
+bool canSetFromIKWithSolver(const kinematics::KinematicsBaseConstPtr &solver, const robot_model::JointModelGroup *jmg, const std::string &ik_link)
+{
+  if (!solver || !jmg || jmg->getKinematicsSolverJointBijection().empty())
+    return false;
+  return ik_link.empty() || robot_state::Transforms::sameFrame(ik_link, solver->getTipFrame());
+}
+
+bool setFromIKWithSolver(const kinematics::KinematicsBaseConstPtr &solver, robot_state::RobotState &state, const robot_model::JointModelGroup *jmg,
+                         const Eigen::Affine3d &pose, unsigned int attempts, double timeout,
+                         const robot_state::GroupStateValidityCallbackFn &constraint)
+{
+  const std::vector<unsigned int> &bij = jmg->getKinematicsSolverJointBijection();
+
+  // bring the pose to the frame the solver operates in
+  Eigen::Affine3d ik_pose = pose;
+  std::string ik_frame = solver->getBaseFrame();
+  if (!ik_frame.empty() && ik_frame[0] == '/')
+    ik_frame = ik_frame.substr(1);
+  if (!robot_state::Transforms::sameFrame(ik_frame, state.getRobotModel()->getModelFrame()))
+  {
+    const robot_model::LinkModel *lm = state.getLinkModel(ik_frame);
+    if (!lm)
+      return false;
+    ik_pose = state.getGlobalLinkTransform(lm).inverse() * pose;
+  }
+  geometry_msgs::Pose ik_query;
+  tf::poseEigenToMsg(ik_pose, ik_query);
+
+  if (timeout < std::numeric_limits<double>::epsilon())
+    timeout = jmg->getDefaultIKTimeout();
+  if (attempts == 0)
+    attempts = jmg->getDefaultIKAttempts();
+
+  kinematics::KinematicsBase::IKCallbackFn ik_callback;
+  if (constraint)
+    ik_callback = boost::bind(&ikCallbackFnAdapter, &state, jmg, boost::cref(bij), boost::cref(constraint), _1, _2, _3);
+
+  std::vector<double> initial_values;
+  std::vector<double> seed(bij.size());
+  std::vector<double> ik_sol;
+  for (unsigned int st = 0 ; st < attempts ; ++st)
+  {
+    // the first attempt starts from the current state; later attempts start from random states
+    if (st > 0)
+      state.setToRandomPositions(jmg);
+    state.copyJointGroupPositions(jmg, initial_values);
+    for (std::size_t i = 0 ; i < bij.size() ; ++i)
+      seed[i] = initial_values[bij[i]];
+
+    moveit_msgs::MoveItErrorCodes error_code;
+    if (solver->searchPositionIK(ik_query, seed, timeout, ik_sol, ik_callback, error_code) &&
+        error_code.val == moveit_msgs::MoveItErrorCodes::SUCCESS)
+    {
+      for (std::size_t i = 0 ; i < bij.size() ; ++i)
+        initial_values[bij[i]] = ik_sol[i];
+      state.setJointGroupPositions(jmg, initial_values);
+      state.update();
+      return true;
+    }
+  }
+  return false;
+}
+
+}
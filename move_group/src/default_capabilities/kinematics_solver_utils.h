@@ -0,0 +1,91 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_MOVE_GROUP_KINEMATICS_SOLVER_UTILS_
+#define MOVEIT_MOVE_GROUP_KINEMATICS_SOLVER_UTILS_
+
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/kinematics_base/kinematics_base.h>
+#include <boost/thread/mutex.hpp>
+#include <map>
+
+namespace move_group
+{
+
+/** \brief Allocate a kinematics solver instance for \e jmg that is not shared with the joint model group (or anyone else).
+    The allocator the group was configured with is used. An empty pointer is returned if the group has no solver. */
+kinematics::KinematicsBasePtr allocKinematicsSolverInstance(const robot_model::JointModelGroup *jmg);
+
+/** \brief Kinematics solver instances that are kept across requests. Each instance is used by one thread at a time:
+    instances are acquired for the duration of a computation and released afterwards, so later requests reuse them
+    instead of allocating new ones. */
+class KinematicsSolverCache
+{
+public:
+
+  /** \brief Get \e count instances for \e jmg that no one else is using. Released instances are reused; new ones are
+      only allocated (with allocKinematicsSolverInstance()) when not enough are idle. If a solver cannot be allocated,
+      \e solvers is left empty. */
+  void acquire(const robot_model::JointModelGroup *jmg, std::size_t count, std::vector<kinematics::KinematicsBasePtr> &solvers);
+
+  /** \brief Get one instance for \e jmg that no one else is using, or an empty pointer if none can be allocated */
+  kinematics::KinematicsBasePtr acquire(const robot_model::JointModelGroup *jmg);
+
+  /** \brief Make instances obtained with acquire() available again */
+  void release(const robot_model::JointModelGroup *jmg, const std::vector<kinematics::KinematicsBasePtr> &solvers);
+
+  /** \brief Make an instance obtained with acquire() available again */
+  void release(const robot_model::JointModelGroup *jmg, const kinematics::KinematicsBasePtr &solver);
+
+private:
+
+  /// The instances not in use, per group
+  std::map<std::string, std::vector<kinematics::KinematicsBasePtr> > idle_;
+  boost::mutex lock_;
+};
+
+/** \brief Check if \e solver can be used directly (through setFromIKWithSolver()) to compute IK for link \e ik_link
+    of group \e jmg. An empty \e ik_link refers to the tip of the solver. */
+bool canSetFromIKWithSolver(const kinematics::KinematicsBaseConstPtr &solver, const robot_model::JointModelGroup *jmg, const std::string &ik_link);
+
+/** \brief Equivalent of RobotState::setFromIK() for a single pose of the solver's tip, using \e solver instead of the instance
+    shared through the joint model group. \e pose is expressed in the model frame. Kinematics solvers are not required to be
+    thread safe, so this allows IK to be computed for the same group from multiple threads, as long as each uses its own solver. */
+bool setFromIKWithSolver(const kinematics::KinematicsBaseConstPtr &solver, robot_state::RobotState &state, const robot_model::JointModelGroup *jmg,
+                         const Eigen::Affine3d &pose, unsigned int attempts = 0, double timeout = 0.0,
+                         const robot_state::GroupStateValidityCallbackFn &constraint = robot_state::GroupStateValidityCallbackFn());
+
+}
+
+#endif
@@ -0,0 +1,122 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "query_world_objects_service_capability.h"
+#include <moveit/move_group/capability_names.h>
+#include <boost/bind.hpp>
+#include <fnmatch.h>
+#include <set>
+
+namespace
+{
+bool acceptEntry(const planning_scene::PlanningScene *scene, const moveit_ros_move_group::QueryWorldObjects::Request *req,
+                 const std::set<std::string> *ids, const Eigen::AlignedBox3d *region, const move_group::WorldObjectIndex::Entry &e)
+{
+  if (!ids->empty() && ids->find(e.id_) == ids->end())
+    return false;
+  if (!req->id_pattern.empty() && fnmatch(req->id_pattern.c_str(), e.id_.c_str(), 0) != 0)
+    return false;
+  if (req->with_type && (!scene->hasObjectType(e.id_) || scene->getObjectType(e.id_).key.empty()))
+    return false;
+  if (region && !(e.has_pose_ && region->contains(e.origins_)))
+    return false;
+  return true;
+}
+}
+
+move_group::MoveGroupQueryWorldObjectsService::MoveGroupQueryWorldObjectsService():
+  MoveGroupCapability("QueryWorldObjectsService")
+{
+}
+
+void move_group::MoveGroupQueryWorldObjectsService::initialize()
+{
+  attachIndex();
+  query_world_objects_service_ = root_node_handle_.advertiseService(QUERY_WORLD_OBJECTS_SERVICE_NAME, &MoveGroupQueryWorldObjectsService::queryWorldObjectsService, this);
+}
+
+void move_group::MoveGroupQueryWorldObjectsService::attachIndex()
+{
+  boost::mutex::scoped_lock slock(attach_lock_);
+  {
+    planning_scene_monitor::LockedPlanningSceneRO ps(context_->planning_scene_monitor_);
+    if (index_.isAttachedTo(ps->getWorld().get()))
+      return;
+  }
+  // the world of the scene changed (or this is the first call); the observer is registered while the world cannot be modified
+  planning_scene_monitor::LockedPlanningSceneRW ps(context_->planning_scene_monitor_);
+  index_.attach(ps->getWorldNonConst());
+  ROS_DEBUG("Indexing the collision world of the planning scene for object queries");
+}
+
+bool move_group::MoveGroupQueryWorldObjectsService::queryWorldObjectsService(moveit_ros_move_group::QueryWorldObjects::Request &req,
+                                                                             moveit_ros_move_group::QueryWorldObjects::Response &res)
+{
+  attachIndex();
+
+  const std::set<std::string> ids(req.ids.begin(), req.ids.end());
+  const Eigen::AlignedBox3d region(Eigen::Vector3d(req.roi_min.x, req.roi_min.y, req.roi_min.z),
+                                   Eigen::Vector3d(req.roi_max.x, req.roi_max.y, req.roi_max.z));
+
+  // the scene stays locked during the query so object types are consistent with the indexed objects
+  planning_scene_monitor::LockedPlanningSceneRO ps(context_->planning_scene_monitor_);
+  const planning_scene::PlanningScene *scene = static_cast<const planning_scene::PlanningSceneConstPtr&>(ps).get();
+  std::vector<WorldObjectIndex::Entry> entries;
+  if (req.nearest_count > 0)
+    index_.queryNearest(Eigen::Vector3d(req.nearest_point.x, req.nearest_point.y, req.nearest_point.z), req.nearest_count,
+                        boost::bind(&acceptEntry, scene, &req, &ids, req.use_roi ? &region : NULL, _1),
+                        entries, res.distances);
+  else if (req.use_roi)
+    index_.queryRegion(region.min(), region.max(),
+                       boost::bind(&acceptEntry, scene, &req, &ids, (const Eigen::AlignedBox3d*)NULL, _1),
+                       entries);
+  else
+    index_.queryAll(boost::bind(&acceptEntry, scene, &req, &ids, (const Eigen::AlignedBox3d*)NULL, _1),
+                    entries);
+
+  res.ids.resize(entries.size());
+  res.poses.resize(entries.size());
+  res.type_keys.resize(entries.size());
+  for (std::size_t i = 0 ; i < entries.size() ; ++i)
+  {
+    res.ids[i] = entries[i].id_;
+    res.poses[i] = entries[i].pose_;
+    if (ps->hasObjectType(entries[i].id_))
+      res.type_keys[i] = ps->getObjectType(entries[i].id_).key;
+  }
+  return true;
+}
+
+#include <class_loader/class_loader.h>
+CLASS_LOADER_REGISTER_CLASS(move_group::MoveGroupQueryWorldObjectsService, move_group::MoveGroupCapability)
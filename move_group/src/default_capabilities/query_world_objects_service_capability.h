@@ -0,0 +1,69 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_MOVE_GROUP_QUERY_WORLD_OBJECTS_SERVICE_CAPABILITY_
+#define MOVEIT_MOVE_GROUP_QUERY_WORLD_OBJECTS_SERVICE_CAPABILITY_
+
+#include <moveit/move_group/move_group_capability.h>
+#include <moveit_ros_move_group/QueryWorldObjects.h>
+#include "world_object_index.h"
+#include <boost/thread/mutex.hpp>
+
+namespace move_group
+{
+
+class MoveGroupQueryWorldObjectsService : public MoveGroupCapability
+{
+public:
+
+  MoveGroupQueryWorldObjectsService();
+
+  virtual void initialize();
+
+private:
+
+  bool queryWorldObjectsService(moveit_ros_move_group::QueryWorldObjects::Request &req, moveit_ros_move_group::QueryWorldObjects::Response &res);
+
+  /* make sure the index follows the world of the current planning scene */
+  void attachIndex();
+
+  ros::ServiceServer query_world_objects_service_;
+
+  WorldObjectIndex index_;
+  boost::mutex attach_lock_;
+};
+
+}
+
+#endif
@@ -0,0 +1,357 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "world_object_index.h"
+#include <geometric_shapes/shapes.h>
+#include <geometric_shapes/shape_operations.h>
+#include <eigen_conversions/eigen_msg.h>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <queue>
+
+namespace
+{
+static const std::size_t MAX_LEAF_SIZE = 4;
+
+bool isPrimitive(shapes::ShapeType type)
+{
+  return type == shapes::SPHERE || type == shapes::BOX || type == shapes::CYLINDER || type == shapes::CONE;
+}
+
+// the box that encloses a shape placed at a pose; false if the shape is not bounded (or not supported)
+bool computeShapeBounds(const shapes::Shape *shape, const Eigen::Affine3d &pose, Eigen::AlignedBox3d &box)
+{
+  if (shape->type == shapes::MESH)
+  {
+    const shapes::Mesh *mesh = static_cast<const shapes::Mesh*>(shape);
+    box.setEmpty();
+    for (unsigned int i = 0 ; i < mesh->vertex_count ; ++i)
+      box.extend(pose * Eigen::Vector3d(mesh->vertices[3 * i], mesh->vertices[3 * i + 1], mesh->vertices[3 * i + 2]));
+    return !box.isEmpty();
+  }
+  if (isPrimitive(shape->type))
+  {
+    // primitives are centered at their origin
+    Eigen::Vector3d half = pose.rotation().cwiseAbs() * (shapes::computeShapeExtents(shape) / 2.0);
+    box = Eigen::AlignedBox3d(pose.translation() - half, pose.translation() + half);
+    return true;
+  }
+  return false;
+}
+
+struct NearestItem
+{
+  NearestItem(double distance, int node, std::size_t entry) :
+    distance_(distance), node_(node), entry_(entry)
+  {
+  }
+
+  // the priority queue keeps the largest element on top, so we invert the order
+  bool operator<(const NearestItem &other) const
+  {
+    return distance_ > other.distance_;
+  }
+
+  double distance_;
+
+  // the node to expand, or -1 if this item is the entry at entry_
+  int node_;
+  std::size_t entry_;
+};
+
+}
+
+move_group::WorldObjectIndex::WorldObjectIndex() :
+  dirty_(false)
+{
+}
+
+move_group::WorldObjectIndex::~WorldObjectIndex()
+{
+  detach();
+}
+
+void move_group::WorldObjectIndex::attach(const collision_detection::WorldPtr &world)
+{
+  detach();
+  if (!world)
+    return;
+  world_ = world;
+  observer_handle_ = world_->addObserver(boost::bind(&WorldObjectIndex::worldChanged, this, _1, _2));
+  world_->notifyObserverAllObjects(observer_handle_, collision_detection::World::CREATE);
+}
+
+void move_group::WorldObjectIndex::detach()
+{
+  if (world_)
+  {
+    world_->removeObserver(observer_handle_);
+    world_.reset();
+  }
+  boost::mutex::scoped_lock slock(lock_);
+  entries_.clear();
+  entry_index_.clear();
+  order_.clear();
+  nodes_.clear();
+  dirty_ = false;
+}
+
+void move_group::WorldObjectIndex::worldChanged(const collision_detection::World::ObjectConstPtr &obj, collision_detection::World::Action action)
+{
+  boost::mutex::scoped_lock slock(lock_);
+  if (action & collision_detection::World::DESTROY)
+    removeEntry(obj->id_);
+  else
+    updateEntry(*obj);
+  dirty_ = true;
+}
+
+void move_group::WorldObjectIndex::updateEntry(const collision_detection::World::Object &obj)
+{
+  std::map<std::string, std::size_t>::const_iterator it = entry_index_.find(obj.id_);
+  std::size_t index;
+  if (it == entry_index_.end())
+  {
+    index = entries_.size();
+    entries_.resize(index + 1);
+    entry_index_[obj.id_] = index;
+  }
+  else
+    index = it->second;
+
+  Entry &e = entries_[index];
+  e.id_ = obj.id_;
+  e.bounds_.setEmpty();
+  e.origins_.setEmpty();
+  e.box_.setEmpty();
+  e.has_pose_ = false;
+  e.pose_ = geometry_msgs::Pose();
+  e.pose_.orientation.w = 1.0;
+
+  bool has_mesh = false;
+  for (std::size_t i = 0 ; i < obj.shapes_.size() ; ++i)
+  {
+    const Eigen::Affine3d &pose = obj.shape_poses_[i];
+    Eigen::AlignedBox3d shape_box;
+    if (computeShapeBounds(obj.shapes_[i].get(), pose, shape_box))
+      e.bounds_.extend(shape_box);
+    else
+      e.bounds_.extend(pose.translation());
+
+    shapes::ShapeType type = obj.shapes_[i]->type;
+    if (type == shapes::MESH || isPrimitive(type))
+    {
+      e.origins_.extend(pose.translation());
+      // same choice of pose as the one reported by PlanningSceneInterface::getObjectPoses()
+      if (!has_mesh && (type == shapes::MESH || !e.has_pose_))
+      {
+        tf::poseEigenToMsg(pose, e.pose_);
+        has_mesh = type == shapes::MESH;
+      }
+      e.has_pose_ = true;
+    }
+  }
+  e.box_ = e.bounds_;
+  if (e.has_pose_)
+    e.box_.extend(e.origins_);
+}
+
+void move_group::WorldObjectIndex::removeEntry(const std::string &id)
+{
+  std::map<std::string, std::size_t>::iterator it = entry_index_.find(id);
+  if (it == entry_index_.end())
+    return;
+  std::size_t index = it->second;
+  entry_index_.erase(it);
+
+  // move the last entry in the place of the removed one
+  std::size_t last = entries_.size() - 1;
+  if (index != last)
+  {
+    std::swap(entries_[index], entries_[last]);
+    entry_index_[entries_[index].id_] = index;
+  }
+  entries_.pop_back();
+}
+
+void move_group::WorldObjectIndex::ensureTree()
+{
+  if (dirty_)
+  {
+    buildTree();
+    dirty_ = false;
+  }
+}
+
+void move_group::WorldObjectIndex::buildTree()
+{
+  nodes_.clear();
+  order_.resize(entries_.size());
+  for (std::size_t i = 0 ; i < order_.size() ; ++i)
+    order_[i] = i;
+  if (!order_.empty())
+  {
+    nodes_.reserve(2 * (order_.size() / MAX_LEAF_SIZE + 1));
+    buildNode(0, order_.size());
+  }
+}
+
+namespace
+{
+struct CenterLess
+{
+  CenterLess(const std::vector<move_group::WorldObjectIndex::Entry> &entries, int axis) :
+    entries_(entries), axis_(axis)
+  {
+  }
+
+  bool operator()(std::size_t a, std::size_t b) const
+  {
+    return entries_[a].box_.center()[axis_] < entries_[b].box_.center()[axis_];
+  }
+
+  const std::vector<move_group::WorldObjectIndex::Entry> &entries_;
+  int axis_;
+};
+}
+
+int move_group::WorldObjectIndex::buildNode(std::size_t begin, std::size_t end)
+{
+  int index = nodes_.size();
+  nodes_.push_back(Node());
+  Eigen::AlignedBox3d box, centers;
+  for (std::size_t i = begin ; i < end ; ++i)
+  {
+    box.extend(entries_[order_[i]].box_);
+    centers.extend(entries_[order_[i]].box_.center());
+  }
+  nodes_[index].box_ = box;
+  nodes_[index].begin_ = begin;
+  nodes_[index].end_ = end;
+  nodes_[index].left_ = -1;
+  nodes_[index].right_ = -1;
+
+  if (end - begin > MAX_LEAF_SIZE)
+  {
+    // split at the median along the axis on which the centers are spread the most
+    int axis;
+    centers.sizes().maxCoeff(&axis);
+    std::size_t mid = (begin + end) / 2;
+    std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end, CenterLess(entries_, axis));
+    int left = buildNode(begin, mid);
+    int right = buildNode(mid, end);
+    nodes_[index].left_ = left;
+    nodes_[index].right_ = right;
+  }
+  return index;
+}
+
+void move_group::WorldObjectIndex::queryRegion(const Eigen::Vector3d &min, const Eigen::Vector3d &max, const EntryFilterFn &filter, std::vector<Entry> &result)
+{
+  result.clear();
+  boost::mutex::scoped_lock slock(lock_);
+  ensureTree();
+  if (nodes_.empty())
+    return;
+
+  const Eigen::AlignedBox3d region(min, max);
+  std::vector<int> stack(1, 0);
+  while (!stack.empty())
+  {
+    const Node &n = nodes_[stack.back()];
+    stack.pop_back();
+    if (!n.box_.intersects(region))
+      continue;
+    if (n.left_ >= 0)
+    {
+      stack.push_back(n.left_);
+      stack.push_back(n.right_);
+      continue;
+    }
+    for (std::size_t i = n.begin_ ; i < n.end_ ; ++i)
+    {
+      const Entry &e = entries_[order_[i]];
+      if (e.has_pose_ && region.contains(e.origins_) && (!filter || filter(e)))
+        result.push_back(e);
+    }
+  }
+}
+
+void move_group::WorldObjectIndex::queryNearest(const Eigen::Vector3d &point, std::size_t count, const EntryFilterFn &filter,
+                                                std::vector<Entry> &result, std::vector<double> &distances)
+{
+  result.clear();
+  distances.clear();
+  boost::mutex::scoped_lock slock(lock_);
+  ensureTree();
+  if (nodes_.empty() || count == 0)
+    return;
+
+  // best-first search: a node is expanded only when no closer entry remains
+  std::priority_queue<NearestItem> queue;
+  queue.push(NearestItem(nodes_[0].box_.exteriorDistance(point), 0, 0));
+  while (!queue.empty() && result.size() < count)
+  {
+    NearestItem item = queue.top();
+    queue.pop();
+    if (item.node_ < 0)
+    {
+      result.push_back(entries_[item.entry_]);
+      distances.push_back(item.distance_);
+      continue;
+    }
+    const Node &n = nodes_[item.node_];
+    if (n.left_ >= 0)
+    {
+      queue.push(NearestItem(nodes_[n.left_].box_.exteriorDistance(point), n.left_, 0));
+      queue.push(NearestItem(nodes_[n.right_].box_.exteriorDistance(point), n.right_, 0));
+    }
+    else
+      for (std::size_t i = n.begin_ ; i < n.end_ ; ++i)
+      {
+        const Entry &e = entries_[order_[i]];
+        if (!filter || filter(e))
+          queue.push(NearestItem(e.bounds_.exteriorDistance(point), -1, order_[i]));
+      }
+  }
+}
+
+void move_group::WorldObjectIndex::queryAll(const EntryFilterFn &filter, std::vector<Entry> &result)
+{
+  result.clear();
+  boost::mutex::scoped_lock slock(lock_);
+  for (std::size_t i = 0 ; i < entries_.size() ; ++i)
+    if (!filter || filter(entries_[i]))
+      result.push_back(entries_[i]);
+}
@@ -0,0 +1,145 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_MOVE_GROUP_WORLD_OBJECT_INDEX_
+#define MOVEIT_MOVE_GROUP_WORLD_OBJECT_INDEX_
+
+#include <moveit/collision_detection/world.h>
+#include <geometry_msgs/Pose.h>
+#include <Eigen/Geometry>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/noncopyable.hpp>
+#include <vector>
+#include <map>
+
+namespace move_group
+{
+
+/** \brief A bounding volume hierarchy over the objects of a collision world, used to answer region and nearest-object queries.
+    The entries are updated incrementally from the observer callbacks of the world; the hierarchy itself is rebuilt on the first query after a change. */
+class WorldObjectIndex : private boost::noncopyable
+{
+public:
+
+  /** \brief The indexed information about one object */
+  struct Entry
+  {
+    /** \brief The id of the object */
+    std::string id_;
+
+    /** \brief The axis-aligned bounding box of the shapes of the object (planes and octrees contribute only their origin) */
+    Eigen::AlignedBox3d bounds_;
+
+    /** \brief The axis-aligned box of the origins of the mesh and primitive shapes of the object */
+    Eigen::AlignedBox3d origins_;
+
+    /** \brief The pose of the first mesh of the object or, if there are no meshes, of the first primitive */
+    geometry_msgs::Pose pose_;
+
+    /** \brief True if the object has at least one mesh or primitive shape (pose_ and origins_ are only valid then) */
+    bool has_pose_;
+
+    /** \brief The union of bounds_ and origins_, the box used to build the hierarchy */
+    Eigen::AlignedBox3d box_;
+  };
+
+  /** \brief Decide whether an entry should be part of the result of a query */
+  typedef boost::function<bool(const Entry&)> EntryFilterFn;
+
+  WorldObjectIndex();
+  ~WorldObjectIndex();
+
+  /** \brief Index the objects of \e world and follow its changes from now on. The world must not be modified concurrently with this call. */
+  void attach(const collision_detection::WorldPtr &world);
+
+  /** \brief Stop following the changes of the attached world (if any) and clear the index */
+  void detach();
+
+  /** \brief Check if the index follows the changes of \e world */
+  bool isAttachedTo(const collision_detection::World *world) const
+  {
+    return world_.get() == world;
+  }
+
+  /** \brief Get the entries of the objects with all their mesh and primitive origins within the box [\e min, \e max] that are accepted by \e filter (if specified) */
+  void queryRegion(const Eigen::Vector3d &min, const Eigen::Vector3d &max, const EntryFilterFn &filter, std::vector<Entry> &result);
+
+  /** \brief Get at most \e count entries accepted by \e filter (if specified), in increasing order of the distance from \e point to their bounds.
+      The distances are returned in \e distances */
+  void queryNearest(const Eigen::Vector3d &point, std::size_t count, const EntryFilterFn &filter, std::vector<Entry> &result, std::vector<double> &distances);
+
+  /** \brief Get all the entries accepted by \e filter (if specified) */
+  void queryAll(const EntryFilterFn &filter, std::vector<Entry> &result);
+
+private:
+
+  struct Node
+  {
+    Eigen::AlignedBox3d box_;
+
+    /* the range of order_ covered by this node */
+    std::size_t begin_;
+    std::size_t end_;
+
+    /* the index of the children in nodes_; -1 for leaves */
+    int left_;
+    int right_;
+  };
+
+  void worldChanged(const collision_detection::World::ObjectConstPtr &obj, collision_detection::World::Action action);
+  void updateEntry(const collision_detection::World::Object &obj);
+  void removeEntry(const std::string &id);
+
+  void buildTree();
+  int buildNode(std::size_t begin, std::size_t end);
+  void ensureTree();
+
+  boost::mutex lock_;
+
+  collision_detection::WorldPtr world_;
+  collision_detection::World::ObserverHandle observer_handle_;
+
+  std::vector<Entry> entries_;
+  std::map<std::string, std::size_t> entry_index_;
+
+  /* indices into entries_, grouped such that each node covers a contiguous range */
+  std::vector<std::size_t> order_;
+  std::vector<Node> nodes_;
+  bool dirty_;
+};
+
+}
+
+#endif
@@ -66,6 +66,9 @@ public:
 
   ~MoveGroupExe()
   {
+    // capabilities (and the plan execution of the context) register scene update callbacks that point into objects and
+    // plugin libraries about to go away; the monitor outlives them, so the callbacks are removed first
+    context_->planning_scene_monitor_->clearUpdateCallbacks();
     capabilities_.clear();
     context_.reset();
     capability_plugin_loader_.reset();
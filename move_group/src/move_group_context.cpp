@@ -39,6 +39,7 @@
 #include <moveit/planning_pipeline/planning_pipeline.h>
 #include <moveit/plan_execution/plan_execution.h>
 #include <moveit/plan_execution/plan_with_sensing.h>
+#include <pluginlib/class_loader.h>
 
 move_group::MoveGroupContext::MoveGroupContext(const planning_scene_monitor::PlanningSceneMonitorPtr &planning_scene_monitor,
                            bool allow_trajectory_execution, bool debug) :
@@ -63,6 +64,29 @@ move_group::MoveGroupContext::MoveGroupContext(const planning_scene_monitor::Pla
 
   if (debug_)
     planning_pipeline_->publishReceivedRequests(true);
+
+  // plans cached by the pipeline can also be kept in a persistent storage (e.g., moveit_warehouse/PlanCacheStorage,
+  // provided by moveit_ros_warehouse), so they are available after a restart
+  std::string plan_cache_storage;
+  ros::NodeHandle("~").param("plan_cache_storage", plan_cache_storage, std::string());
+  if (!plan_cache_storage.empty())
+  {
+    if (!planning_pipeline_->getCachePlans())
+      ROS_WARN("Parameter 'plan_cache_storage' is set, but plans are not cached (see parameter 'cache_plans')");
+    else
+      try
+      {
+        // the library of an unmanaged instance stays loaded after the class loader is destroyed
+        pluginlib::ClassLoader<planning_pipeline::PlanCache::Storage> loader("moveit_ros_planning", "planning_pipeline::PlanCache::Storage");
+        planning_pipeline::PlanCache::StoragePtr storage(loader.createUnmanagedInstance(plan_cache_storage));
+        planning_pipeline_->getPlanCache()->setStorage(storage);
+        ROS_INFO("Cached motion plans are stored using '%s'", plan_cache_storage.c_str());
+      }
+      catch(std::runtime_error &ex)
+      {
+        ROS_ERROR("Unable to set up the storage '%s' for cached plans: %s", plan_cache_storage.c_str(), ex.what());
+      }
+  }
 }
 
 move_group::MoveGroupContext::~MoveGroupContext()
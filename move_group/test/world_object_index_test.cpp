@@ -0,0 +1,232 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include "../src/default_capabilities/world_object_index.h"
+#include <geometric_shapes/shapes.h>
+#include <random_numbers/random_numbers.h>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <set>
+
+namespace
+{
+
+// enough objects for the hierarchy to have several levels
+const std::size_t OBJECT_COUNT = 300;
+
+Eigen::Affine3d randomPose(random_numbers::RandomNumberGenerator &rng)
+{
+  double q[4];
+  rng.quaternion(q);
+  Eigen::Affine3d pose(Eigen::Quaterniond(q[3], q[0], q[1], q[2]));
+  pose.translation() = Eigen::Vector3d(rng.uniformReal(-5.0, 5.0), rng.uniformReal(-5.0, 5.0), rng.uniformReal(0.0, 2.0));
+  return pose;
+}
+
+shapes::ShapeConstPtr randomShape(random_numbers::RandomNumberGenerator &rng)
+{
+  if (rng.uniform01() < 0.5)
+    return shapes::ShapeConstPtr(new shapes::Box(rng.uniformReal(0.05, 0.5), rng.uniformReal(0.05, 0.5), rng.uniformReal(0.05, 0.5)));
+  return shapes::ShapeConstPtr(new shapes::Sphere(rng.uniformReal(0.05, 0.3)));
+}
+
+// objects of one or two shapes, so the origins of an object do not all coincide
+void fillWorld(const collision_detection::WorldPtr &world, random_numbers::RandomNumberGenerator &rng)
+{
+  for (std::size_t i = 0 ; i < OBJECT_COUNT ; ++i)
+  {
+    std::string id = "object_" + boost::lexical_cast<std::string>(i);
+    Eigen::Affine3d pose = randomPose(rng);
+    world->addToObject(id, randomShape(rng), pose);
+    if (i % 3 == 0)
+    {
+      Eigen::Affine3d offset(Eigen::Translation3d(rng.uniformReal(-0.3, 0.3), rng.uniformReal(-0.3, 0.3), rng.uniformReal(-0.3, 0.3)));
+      world->addToObject(id, randomShape(rng), pose * offset);
+    }
+  }
+}
+
+std::set<std::string> ids(const std::vector<move_group::WorldObjectIndex::Entry> &entries)
+{
+  std::set<std::string> result;
+  for (std::size_t i = 0 ; i < entries.size() ; ++i)
+    result.insert(entries[i].id_);
+  return result;
+}
+
+// the queries, answered by looking at every entry
+std::set<std::string> bruteForceRegion(const std::vector<move_group::WorldObjectIndex::Entry> &entries,
+                                       const Eigen::Vector3d &min, const Eigen::Vector3d &max)
+{
+  Eigen::AlignedBox3d region(min, max);
+  std::set<std::string> result;
+  for (std::size_t i = 0 ; i < entries.size() ; ++i)
+    if (entries[i].has_pose_ && region.contains(entries[i].origins_))
+      result.insert(entries[i].id_);
+  return result;
+}
+
+std::vector<double> bruteForceNearest(const std::vector<move_group::WorldObjectIndex::Entry> &entries,
+                                      const Eigen::Vector3d &point, std::size_t count)
+{
+  std::vector<double> distances;
+  for (std::size_t i = 0 ; i < entries.size() ; ++i)
+    distances.push_back(entries[i].bounds_.exteriorDistance(point));
+  std::sort(distances.begin(), distances.end());
+  distances.resize(std::min(count, distances.size()));
+  return distances;
+}
+
+void expectSameAsBruteForce(move_group::WorldObjectIndex &index, random_numbers::RandomNumberGenerator &rng)
+{
+  std::vector<move_group::WorldObjectIndex::Entry> all;
+  index.queryAll(move_group::WorldObjectIndex::EntryFilterFn(), all);
+
+  for (int t = 0 ; t < 50 ; ++t)
+  {
+    Eigen::Vector3d a(rng.uniformReal(-6.0, 6.0), rng.uniformReal(-6.0, 6.0), rng.uniformReal(-1.0, 3.0));
+    Eigen::Vector3d b(rng.uniformReal(-6.0, 6.0), rng.uniformReal(-6.0, 6.0), rng.uniformReal(-1.0, 3.0));
+    Eigen::Vector3d min = a.cwiseMin(b), max = a.cwiseMax(b);
+    std::vector<move_group::WorldObjectIndex::Entry> region;
+    index.queryRegion(min, max, move_group::WorldObjectIndex::EntryFilterFn(), region);
+    EXPECT_EQ(region.size(), ids(region).size());
+    EXPECT_EQ(bruteForceRegion(all, min, max), ids(region));
+
+    Eigen::Vector3d point(rng.uniformReal(-7.0, 7.0), rng.uniformReal(-7.0, 7.0), rng.uniformReal(-2.0, 4.0));
+    std::size_t count = rng.uniformInteger(1, 20);
+    std::vector<move_group::WorldObjectIndex::Entry> nearest;
+    std::vector<double> distances;
+    index.queryNearest(point, count, move_group::WorldObjectIndex::EntryFilterFn(), nearest, distances);
+    std::vector<double> expected = bruteForceNearest(all, point, count);
+    ASSERT_EQ(expected.size(), distances.size());
+    ASSERT_EQ(nearest.size(), distances.size());
+    for (std::size_t i = 0 ; i < expected.size() ; ++i)
+    {
+      EXPECT_NEAR(expected[i], distances[i], 1e-12);
+      EXPECT_NEAR(nearest[i].bounds_.exteriorDistance(point), distances[i], 1e-12);
+    }
+  }
+}
+
+bool hasEvenNumber(const move_group::WorldObjectIndex::Entry &e)
+{
+  return (e.id_[e.id_.size() - 1] - '0') % 2 == 0;
+}
+
+}
+
+TEST(WorldObjectIndex, MatchesBruteForce)
+{
+  random_numbers::RandomNumberGenerator rng(11);
+  collision_detection::WorldPtr world(new collision_detection::World());
+  fillWorld(world, rng);
+
+  move_group::WorldObjectIndex index;
+  index.attach(world);
+  std::vector<move_group::WorldObjectIndex::Entry> all;
+  index.queryAll(move_group::WorldObjectIndex::EntryFilterFn(), all);
+  EXPECT_EQ(OBJECT_COUNT, all.size());
+  expectSameAsBruteForce(index, rng);
+}
+
+TEST(WorldObjectIndex, MatchesBruteForceAfterChanges)
+{
+  random_numbers::RandomNumberGenerator rng(13);
+  collision_detection::WorldPtr world(new collision_detection::World());
+  fillWorld(world, rng);
+
+  move_group::WorldObjectIndex index;
+  index.attach(world);
+  expectSameAsBruteForce(index, rng);
+
+  // the index follows the world: move some objects, remove others and add new ones
+  for (std::size_t i = 0 ; i < OBJECT_COUNT ; i += 4)
+  {
+    std::string id = "object_" + boost::lexical_cast<std::string>(i);
+    collision_detection::World::ObjectConstPtr obj = world->getObject(id);
+    world->moveShapeInObject(id, obj->shapes_[0], randomPose(rng));
+  }
+  for (std::size_t i = 1 ; i < OBJECT_COUNT ; i += 5)
+    world->removeObject("object_" + boost::lexical_cast<std::string>(i));
+  for (std::size_t i = 0 ; i < 20 ; ++i)
+    world->addToObject("added_" + boost::lexical_cast<std::string>(i), randomShape(rng), randomPose(rng));
+
+  std::vector<move_group::WorldObjectIndex::Entry> all;
+  index.queryAll(move_group::WorldObjectIndex::EntryFilterFn(), all);
+  EXPECT_EQ(world->size(), all.size());
+  expectSameAsBruteForce(index, rng);
+}
+
+TEST(WorldObjectIndex, ComputesBoundsOfShapes)
+{
+  collision_detection::WorldPtr world(new collision_detection::World());
+  Eigen::Affine3d pose(Eigen::Translation3d(1.0, 2.0, 3.0));
+  world->addToObject("box", shapes::ShapeConstPtr(new shapes::Box(0.2, 0.4, 0.6)), pose);
+
+  move_group::WorldObjectIndex index;
+  index.attach(world);
+  std::vector<move_group::WorldObjectIndex::Entry> all;
+  index.queryAll(move_group::WorldObjectIndex::EntryFilterFn(), all);
+  ASSERT_EQ(1u, all.size());
+  EXPECT_TRUE(all[0].has_pose_);
+  EXPECT_TRUE(all[0].bounds_.min().isApprox(Eigen::Vector3d(0.9, 1.8, 2.7)));
+  EXPECT_TRUE(all[0].bounds_.max().isApprox(Eigen::Vector3d(1.1, 2.2, 3.3)));
+  EXPECT_DOUBLE_EQ(1.0, all[0].pose_.position.x);
+  EXPECT_DOUBLE_EQ(0.5, all[0].bounds_.exteriorDistance(Eigen::Vector3d(1.6, 2.0, 3.0)));
+}
+
+TEST(WorldObjectIndex, AppliesFilters)
+{
+  random_numbers::RandomNumberGenerator rng(17);
+  collision_detection::WorldPtr world(new collision_detection::World());
+  fillWorld(world, rng);
+
+  move_group::WorldObjectIndex index;
+  index.attach(world);
+  std::vector<move_group::WorldObjectIndex::Entry> region, nearest;
+  std::vector<double> distances;
+  index.queryRegion(Eigen::Vector3d(-10.0, -10.0, -10.0), Eigen::Vector3d(10.0, 10.0, 10.0), &hasEvenNumber, region);
+  index.queryNearest(Eigen::Vector3d::Zero(), OBJECT_COUNT, &hasEvenNumber, nearest, distances);
+  EXPECT_EQ(OBJECT_COUNT / 2, region.size());
+  EXPECT_EQ(OBJECT_COUNT / 2, nearest.size());
+  for (std::size_t i = 0 ; i < nearest.size() ; ++i)
+    EXPECT_TRUE(hasEvenNumber(nearest[i]));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,63 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_KDL_KINEMATICS_PLUGIN_CHAIN_SEGMENT_FRAMES
+#define MOVEIT_KDL_KINEMATICS_PLUGIN_CHAIN_SEGMENT_FRAMES
+
+#include <kdl/chain.hpp>
+#include <kdl/frames.hpp>
+#include <utility>
+#include <vector>
+
+namespace kdl_kinematics_plugin
+{
+
+/**
+ * @brief Compute the frames of several segments of a chain in one pass along it. The frame of segment number s is
+ * the one ChainFkSolverPos_recursive::JntToCart() computes for segment number s, i.e., the frame at the end of the
+ * first s segments (number 0 is the base).
+ * @param chain The chain
+ * @param joint_angles The values of all the joints in the chain
+ * @param segments Pairs of segment number and the index in frames the frame of that segment is written to, sorted by
+ * segment number; segment numbers must not exceed the number of segments of the chain
+ * @param frames The output frames
+ */
+void computeSegmentFrames(const KDL::Chain &chain,
+                          const double *joint_angles,
+                          const std::vector<std::pair<int, std::size_t> > &segments,
+                          KDL::Frame *frames);
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef KDLCHAINIKSOLVERPOS_LMA_JL_Mimic_HPP
+#define KDLCHAINIKSOLVERPOS_LMA_JL_Mimic_HPP
+
+#include "kdl/chainiksolver.hpp"
+#include "kdl/chainfksolverpos_recursive.hpp"
+#include "kdl/chainjnttojacsolver.hpp"
+
+#include <moveit/kdl_kinematics_plugin/joint_mimic.hpp>
+
+#include <Eigen/Cholesky>
+#include <vector>
+
+namespace KDL
+{
+
+/**
+ * Inverse position kinematics for a KDL::Chain based on damped least squares (Levenberg-Marquardt) steps:
+ * (J^T J + lambda * (diag(J^T J) + I)) dq = J^T e. The damping lambda is lowered after every step that reduces
+ * the error and raised after every step that does not, so the solver behaves like Gauss-Newton away from
+ * singularities and like gradient descent near them. Steps are clamped to the joint limits.
+ *
+ * Mimic joints and locked redundant joints are handled as in ChainIkSolverVel_pinv_mimic: the Jacobian is reduced
+ * to the active DOFs, and the columns of locked joints are zeroed, so they do not move. All storage is allocated in
+ * the constructor.
+ *
+ * @ingroup KinematicFamily
+ */
+class ChainIkSolverPos_LMA_JL_Mimic : public ChainIkSolverPos
+{
+public:
+  /**
+   * @param chain the chain to calculate the inverse position for
+   * @param q_min the minimum joint positions
+   * @param q_max the maximum joint positions
+   * @param num_mimic_joints the number of joints that are setup to follow other joints
+   * @param num_redundant_joints the number of redundant dofs
+   * @param maxiter the maximum number of iterations (accepted or rejected steps)
+   * @param eps the precision for the position, used to end the iterations
+   * @param position_ik true to solve only for the 3 dof end-effector position
+   */
+  ChainIkSolverPos_LMA_JL_Mimic(const Chain& chain, const JntArray& q_min, const JntArray& q_max,
+                                int num_mimic_joints = 0, int num_redundant_joints = 0,
+                                unsigned int maxiter = 500, double eps = 1e-5, bool position_ik = false);
+
+  ~ChainIkSolverPos_LMA_JL_Mimic();
+
+  /**
+   * @return 0 if the pose was reached within eps, -3 if the maximum number of iterations was exceeded or the
+   * damping grew so large that no progress could be made (a restart from another configuration is needed)
+   */
+  virtual int CartToJnt(const JntArray& q_init, const Frame& p_in, JntArray& q_out);
+
+  /** @brief See ChainIkSolverVel_pinv_mimic::setMimicJoints() */
+  bool setMimicJoints(const std::vector<kdl_kinematics_plugin::JointMimic>& mimic_joints);
+
+  /** @brief See ChainIkSolverVel_pinv_mimic::setRedundantJointsMapIndex() */
+  bool setRedundantJointsMapIndex(const std::vector<unsigned int>& redundant_joints_map_index);
+
+  void lockRedundantJoints()
+  {
+    redundant_joints_locked = true;
+  }
+
+  void unlockRedundantJoints()
+  {
+    redundant_joints_locked = false;
+  }
+
+  /** @brief The number of iterations (accepted and rejected steps) the last call to CartToJnt() made */
+  unsigned int getLastIterationCount() const
+  {
+    return last_iterations;
+  }
+
+private:
+
+  /** @brief Compute the pose error at q into twist and return its squared norm */
+  double computeError(const JntArray& q, const Frame& p_in, Twist& twist);
+
+  const Chain chain;
+  JntArray q_min;
+  JntArray q_max;
+  ChainFkSolverPos_recursive fksolver;
+  ChainJntToJacSolver jnt2jac;
+  unsigned int maxiter;
+  double eps;
+  bool position_ik;
+
+  std::vector<kdl_kinematics_plugin::JointMimic> mimic_joints;
+  unsigned int num_mimic_joints;
+  unsigned int num_redundant_joints;
+  std::vector<unsigned int> locked_joints_map_index;
+  std::vector<unsigned int> redundant_columns; // the active DOFs that are not in locked_joints_map_index
+  bool redundant_joints_locked;
+  unsigned int last_iterations;
+
+  // storage for the iterations
+  Frame f;
+  Twist delta_twist;
+  Twist delta_twist_new;
+  JntArray q_temp;
+  JntArray q_new;
+  Jacobian jac;
+  Eigen::MatrixXd jac_reduced;
+  Eigen::MatrixXd jtj;
+  Eigen::VectorXd jte;
+  Eigen::VectorXd error;
+  Eigen::VectorXd step_reduced;
+  Eigen::LDLT<Eigen::MatrixXd> ldlt;
+};
+
+}
+
+#endif
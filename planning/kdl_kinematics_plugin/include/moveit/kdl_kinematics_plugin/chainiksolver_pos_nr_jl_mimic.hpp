@@ -74,6 +74,12 @@ public:
 
   bool setMimicJoints(const std::vector<kdl_kinematics_plugin::JointMimic>& mimic_joints);
 
+  /** @brief The number of Newton-Raphson iterations the last call to CartToJnt() made */
+  unsigned int getLastIterationCount() const
+  {
+    return last_iterations;
+  }
+
 private:
   const Chain chain;
   JntArray q_min;//These are the limits for the "reduced" state consisting of only active DOFs
@@ -92,6 +98,7 @@ private:
   void qToqMimic(const JntArray& q, JntArray& q_result); //Convert from the "reduced" state (only active DOFs) to the "full" state
   void qMimicToq(const JntArray& q, JntArray& q_result); //Convert from the "full" state to the "reduced" state
   bool position_ik;
+  unsigned int last_iterations;
 
 };
 
@@ -43,6 +43,10 @@
 
 // System
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
 
 // ROS msgs
 #include <geometry_msgs/PoseStamped.h>
@@ -57,8 +61,10 @@
 #include <kdl/chainiksolverpos_nr_jl.hpp>
 #include <kdl/chainfksolverpos_recursive.hpp>
 #include <moveit/kdl_kinematics_plugin/chainiksolver_pos_nr_jl_mimic.hpp>
+#include <moveit/kdl_kinematics_plugin/chainiksolver_pos_lma_jl_mimic.hpp>
 #include <moveit/kdl_kinematics_plugin/chainiksolver_vel_pinv_mimic.hpp>
 #include <moveit/kdl_kinematics_plugin/joint_mimic.hpp>
+#include <moveit/kdl_kinematics_plugin/chain_segment_frames.hpp>
 
 // MoveIt!
 #include <moveit/kinematics_base/kinematics_base.h>
@@ -79,6 +85,8 @@ namespace kdl_kinematics_plugin
      */
     KDLKinematicsPlugin();
 
+    virtual ~KDLKinematicsPlugin();
+
     virtual bool getPositionIK(const geometry_msgs::Pose &ik_pose,
                                const std::vector<double> &ik_seed_state,
                                std::vector<double> &solution,
@@ -121,6 +129,20 @@ namespace kdl_kinematics_plugin
                                const std::vector<double> &joint_angles,
                                std::vector<geometry_msgs::Pose> &poses) const;
 
+    /**
+     * @brief Compute the poses of a set of links for many joint configurations. The link names are looked up once,
+     * and each configuration is evaluated in a single pass along the chain. This is not part of KinematicsBase, so
+     * callers that know they hold this plugin (e.g., the reachability maps of pick and place) use it directly.
+     * @param link_names The links to compute poses for
+     * @param joint_angles The configurations, one after the other (getJointNames().size() values each)
+     * @param poses Filled with the link poses: the pose of link_names[l] for configuration c is at c * link_names.size() + l
+     * @return False if a link is not in the chain (its poses are not set) or the number of joint angles is not a
+     * multiple of the dimension
+     */
+    bool getPositionFKBatch(const std::vector<std::string> &link_names,
+                            const std::vector<double> &joint_angles,
+                            std::vector<geometry_msgs::Pose> &poses) const;
+
     virtual bool initialize(const std::string &robot_description,
                             const std::string &group_name,
                             const std::string &base_name,
@@ -167,7 +189,88 @@ namespace kdl_kinematics_plugin
 
   private:
 
-    bool timedOut(const ros::WallTime &start_time, double duration) const;
+    /**
+     * @brief The solvers and buffers a call to searchPositionIK needs. Workspaces are kept in a pool and reused
+     * across calls, so the search does not allocate memory and concurrent calls each use their own workspace.
+     */
+    struct SolverWorkspace
+    {
+      SolverWorkspace(const KDLKinematicsPlugin &plugin);
+
+      KDL::ChainFkSolverPos_recursive fk_solver_;
+      KDL::ChainIkSolverVel_pinv_mimic ik_solver_vel_;
+      KDL::ChainIkSolverPos_NR_JL_Mimic ik_solver_pos_;
+
+      /** Only constructed if the plugin uses the Levenberg-Marquardt solver */
+      boost::scoped_ptr<KDL::ChainIkSolverPos_LMA_JL_Mimic> ik_solver_lma_;
+
+      /** The position solver the search uses (ik_solver_pos_ or ik_solver_lma_) */
+      KDL::ChainIkSolverPos *ik_solver_;
+
+      /** @brief Lock or unlock the redundant joints in all the solvers of this workspace */
+      void setRedundantJointsLocked(bool locked);
+
+      KDL::JntArray jnt_seed_state_;
+      KDL::JntArray jnt_pos_in_;
+      KDL::JntArray jnt_pos_out_;
+
+      /** Buffers for sampling random configurations */
+      std::vector<double> values_;
+      std::vector<double> near_;
+      std::vector<double> consistency_limits_mimic_;
+      random_numbers::RandomNumberGenerator rng_;
+
+      /** The configuration of the plugin (including the redundant joints) the solvers were constructed for */
+      unsigned int workspace_version_;
+
+      /** False if the redundant joints could not be configured */
+      bool valid_;
+    };
+    typedef boost::shared_ptr<SolverWorkspace> SolverWorkspacePtr;
+
+    /** @brief Get a workspace from the pool, or construct one if the pool is empty */
+    SolverWorkspacePtr acquireWorkspace() const;
+
+    /** @brief Return a workspace to the pool, unless the plugin was configured again since the workspace was constructed */
+    void releaseWorkspace(const SolverWorkspacePtr &workspace) const;
+
+    /** @brief State shared by the threads of a parallel search */
+    struct SharedSearch;
+
+    /** @brief Search for a solution starting at the configuration stored in \e workspace (jnt_pos_in_), restarting
+     *  from random configurations until \e deadline or until \e max_attempts attempts were made (0 for no limit).
+     *  If \e shared is not NULL, the search also ends when another thread of the same parallel search is done, and
+     *  calls to the solution callback are serialized. The search allocates no memory. */
+    bool searchWithWorkspace(SolverWorkspace &workspace,
+                             const geometry_msgs::Pose &ik_pose,
+                             const KDL::Frame &pose_desired,
+                             const ros::WallTime &deadline,
+                             unsigned int max_attempts,
+                             std::vector<double> &solution,
+                             const IKCallbackFn &solution_callback,
+                             moveit_msgs::MoveItErrorCodes &error_code,
+                             const std::vector<double> &consistency_limits,
+                             const kinematics::KinematicsQueryOptions &options,
+                             SharedSearch *shared) const;
+
+    /** @brief Search from parallel_seeds_ seeds at the same time: the seed stored in \e workspace and random ones.
+     *  Depending on parallel_seed_closest_, the first solution found is returned or, once every thread found a
+     *  solution or timed out, the solution closest to the seed */
+    bool searchInParallel(const SolverWorkspacePtr &workspace,
+                          const geometry_msgs::Pose &ik_pose,
+                          const KDL::Frame &pose_desired,
+                          const ros::WallTime &deadline,
+                          std::vector<double> &solution,
+                          const IKCallbackFn &solution_callback,
+                          moveit_msgs::MoveItErrorCodes &error_code,
+                          const std::vector<double> &consistency_limits,
+                          const kinematics::KinematicsQueryOptions &options) const;
+
+    /** @brief The function run by each thread of a parallel search */
+    void searchThread(SharedSearch *shared, std::size_t index) const;
+
+    /** @brief Threads that run the random-seed part of parallel searches; they live as long as the plugin */
+    class SearchThreadPool;
 
 
     /** @brief Check whether the solution lies within the consistency limit of the seed state
@@ -185,15 +288,22 @@ namespace kdl_kinematics_plugin
 
     int getKDLSegmentIndex(const std::string &name) const;
 
-    void getRandomConfiguration(KDL::JntArray &jnt_array, bool lock_redundancy) const;
+    /** @brief Look up the segments of the requested links, sorted along the chain. Links that are not in the chain
+     *  are left out, and false is returned */
+    bool getRequestedSegments(const std::vector<std::string> &link_names,
+                              std::vector<std::pair<int, std::size_t> > &segments) const;
+
+    void getRandomConfiguration(SolverWorkspace &workspace, KDL::JntArray &jnt_array, bool lock_redundancy) const;
 
     /** @brief Get a random configuration within joint limits close to the seed state
+     *  @param workspace The workspace whose buffers and random number generator are used
      *  @param seed_state Seed state
      *  @param redundancy Index of the redundant joint within the chain
      *  @param consistency_limit The returned state will contain a value for the redundant joint in the range [seed_state(redundancy_limit)-consistency_limit,seed_state(redundancy_limit)+consistency_limit]
      *  @param jnt_array Returned random configuration
      */
-    void getRandomConfiguration(const KDL::JntArray& seed_state,
+    void getRandomConfiguration(SolverWorkspace &workspace,
+                                const KDL::JntArray& seed_state,
                                 const std::vector<double> &consistency_limits,
                                 KDL::JntArray &jnt_array,
                                 bool lock_redundancy) const;
@@ -208,26 +318,48 @@ namespace kdl_kinematics_plugin
 
     KDL::Chain kdl_chain_;
 
+    /** The index of each segment of the chain as used by the FK solver (i.e., plus one), by segment name */
+    std::map<std::string, int> segment_index_;
+
     unsigned int dimension_; /** Dimension of the group */
 
     KDL::JntArray joint_min_, joint_max_; /** Joint limits */
 
     mutable random_numbers::RandomNumberGenerator random_number_generator_;
 
-    robot_model::RobotModelPtr robot_model_;
+    /** The model of the robot; its groups own their solvers, so only a weak reference is kept */
+    boost::weak_ptr<const robot_model::RobotModel> robot_model_;
 
-    robot_state::RobotStatePtr state_, state_2_;
+    /** The model this solver constructed itself, if the loader did not provide one */
+    robot_model::RobotModelConstPtr own_robot_model_;
 
     int num_possible_redundant_joints_;
     std::vector<unsigned int> redundant_joints_map_index_;
 
     // Storage required for when the set of redundant joints is reset
     bool position_ik_; //whether this solver is only being used for position ik
-    robot_model::JointModelGroup* joint_model_group_;
+    const robot_model::JointModelGroup* joint_model_group_;
     double max_solver_iterations_;
     double epsilon_;
+
+    /** The number of seeds searched from in parallel; 1 means searching sequentially */
+    unsigned int parallel_seeds_;
+
+    /** If true, a parallel search returns the solution closest to the seed among those found by its threads,
+     *  instead of the first one found */
+    bool parallel_seed_closest_;
+
+    /** The threads parallel searches run on; only created if parallel_seeds_ > 1 */
+    boost::scoped_ptr<SearchThreadPool> search_threads_;
+
+    /** Use the damped least squares (Levenberg-Marquardt) position solver instead of Newton-Raphson */
+    bool use_lma_solver_;
     std::vector<JointMimic> mimic_joints_;
 
+    mutable std::vector<SolverWorkspacePtr> workspaces_;
+    mutable boost::mutex workspaces_lock_;
+    unsigned int workspace_version_;
+
   };
 }
 
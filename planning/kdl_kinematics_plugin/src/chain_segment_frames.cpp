@@ -0,0 +1,61 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/kdl_kinematics_plugin/chain_segment_frames.hpp>
+
+void kdl_kinematics_plugin::computeSegmentFrames(const KDL::Chain &chain,
+                                                 const double *joint_angles,
+                                                 const std::vector<std::pair<int, std::size_t> > &segments,
+                                                 KDL::Frame *frames)
+{
+  // same as ChainFkSolverPos_recursive, but the frames of all requested segments are emitted along the way
+  KDL::Frame p_out = KDL::Frame::Identity();
+  std::size_t next = 0;
+  for( ; next < segments.size() && segments[next].first == 0; ++next)
+    frames[segments[next].second] = p_out;
+  if(next == segments.size())
+    return;
+
+  unsigned int j = 0;
+  for(int i=0; i < segments.back().first; i++)
+  {
+    const KDL::Segment &segment = chain.getSegment(i);
+    if(segment.getJoint().getType() != KDL::Joint::None)
+      p_out = p_out * segment.pose(joint_angles[j++]);
+    else
+      p_out = p_out * segment.pose(0.0);
+    for( ; next < segments.size() && segments[next].first == i + 1; ++next)
+      frames[segments[next].second] = p_out;
+  }
+}
@@ -0,0 +1,236 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/kdl_kinematics_plugin/chainiksolver_pos_lma_jl_mimic.hpp>
+#include <ros/console.h>
+#include <algorithm>
+#include <cmath>
+
+namespace KDL
+{
+
+namespace
+{
+// the damping starts small (Gauss-Newton like steps) and is scaled by this factor after every step
+const double LAMBDA_INITIAL = 1e-3;
+const double LAMBDA_FACTOR = 10.0;
+const double LAMBDA_MIN = 1e-9;
+
+// beyond this damping the steps are too small to make progress, and a restart is more useful
+const double LAMBDA_MAX = 1e9;
+}
+
+ChainIkSolverPos_LMA_JL_Mimic::ChainIkSolverPos_LMA_JL_Mimic(const Chain& _chain,
+                                                             const JntArray& _q_min,
+                                                             const JntArray& _q_max,
+                                                             int _num_mimic_joints,
+                                                             int _num_redundant_joints,
+                                                             unsigned int _maxiter,
+                                                             double _eps,
+                                                             bool _position_ik)
+  : chain(_chain),
+    q_min(_q_min),
+    q_max(_q_max),
+    fksolver(chain),
+    jnt2jac(chain),
+    maxiter(_maxiter),
+    eps(_eps),
+    position_ik(_position_ik),
+    num_mimic_joints(_num_mimic_joints),
+    num_redundant_joints(_num_redundant_joints),
+    redundant_joints_locked(false),
+    last_iterations(0),
+    q_temp(chain.getNrOfJoints()),
+    q_new(chain.getNrOfJoints()),
+    jac(chain.getNrOfJoints()),
+    jac_reduced(Eigen::MatrixXd::Zero(6, chain.getNrOfJoints() - _num_mimic_joints)),
+    jtj(Eigen::MatrixXd::Zero(chain.getNrOfJoints() - _num_mimic_joints, chain.getNrOfJoints() - _num_mimic_joints)),
+    jte(Eigen::VectorXd::Zero(chain.getNrOfJoints() - _num_mimic_joints)),
+    error(Eigen::VectorXd::Zero(6)),
+    step_reduced(Eigen::VectorXd::Zero(chain.getNrOfJoints() - _num_mimic_joints)),
+    ldlt(chain.getNrOfJoints() - _num_mimic_joints)
+{
+  mimic_joints.resize(chain.getNrOfJoints());
+  for(std::size_t i=0; i < mimic_joints.size(); ++i)
+    mimic_joints[i].reset(i);
+}
+
+ChainIkSolverPos_LMA_JL_Mimic::~ChainIkSolverPos_LMA_JL_Mimic()
+{
+}
+
+bool ChainIkSolverPos_LMA_JL_Mimic::setMimicJoints(const std::vector<kdl_kinematics_plugin::JointMimic>& _mimic_joints)
+{
+  if(_mimic_joints.size() != chain.getNrOfJoints())
+  {
+    ROS_ERROR_NAMED("kdl","Mimic Joint info should be same size as number of joints in chain: %d", chain.getNrOfJoints());
+    return false;
+  }
+
+  for(std::size_t i=0; i < _mimic_joints.size(); ++i)
+    if(_mimic_joints[i].map_index >= chain.getNrOfJoints() - num_mimic_joints)
+    {
+      ROS_ERROR_NAMED("kdl","Mimic Joint index should be less than number of active joints in chain: %d", chain.getNrOfJoints() - num_mimic_joints);
+      return false;
+    }
+  mimic_joints = _mimic_joints;
+  return true;
+}
+
+bool ChainIkSolverPos_LMA_JL_Mimic::setRedundantJointsMapIndex(const std::vector<unsigned int>& redundant_joints_map_index)
+{
+  unsigned int active = chain.getNrOfJoints() - num_mimic_joints;
+  if(redundant_joints_map_index.size() != active - num_redundant_joints)
+  {
+    ROS_ERROR_NAMED("kdl","Map index size: %d does not match expected size. No. of joints: %d, num_mimic_joints: %d, num_redundant_joints: %d",
+                    (int) redundant_joints_map_index.size(), (int) chain.getNrOfJoints(), (int) num_mimic_joints, (int) num_redundant_joints);
+    return false;
+  }
+
+  std::vector<bool> kept(active, false);
+  for(std::size_t i=0; i < redundant_joints_map_index.size(); ++i)
+  {
+    if(redundant_joints_map_index[i] >= active)
+      return false;
+    kept[redundant_joints_map_index[i]] = true;
+  }
+  locked_joints_map_index = redundant_joints_map_index;
+  redundant_columns.clear();
+  for(unsigned int i=0; i < active; ++i)
+    if(!kept[i])
+      redundant_columns.push_back(i);
+  return true;
+}
+
+double ChainIkSolverPos_LMA_JL_Mimic::computeError(const JntArray& q, const Frame& p_in, Twist& twist)
+{
+  fksolver.JntToCart(q, f);
+  twist = diff(f, p_in);
+  double e = 0.0;
+  for(int i=0; i < (position_ik ? 3 : 6); ++i)
+    e += twist(i) * twist(i);
+  return e;
+}
+
+int ChainIkSolverPos_LMA_JL_Mimic::CartToJnt(const JntArray& q_init, const Frame& p_in, JntArray& q_out)
+{
+  q_temp = q_init;
+  double lambda = LAMBDA_INITIAL;
+  double err = computeError(q_temp, p_in, delta_twist);
+
+  unsigned int i;
+  for(i=0; i < maxiter; ++i)
+  {
+    if(position_ik)
+    {
+      if(fabs(delta_twist(0)) < eps && fabs(delta_twist(1)) < eps && fabs(delta_twist(2)) < eps)
+        break;
+    }
+    else
+    {
+      if(Equal(delta_twist,Twist::Zero(),eps))
+        break;
+    }
+
+    // the Jacobian of the active DOFs: mimic joints contribute to the joint they follow, locked joints not at all
+    jnt2jac.JntToJac(q_temp, jac);
+    jac_reduced.setZero();
+    for(std::size_t j=0; j < chain.getNrOfJoints(); ++j)
+      jac_reduced.col(mimic_joints[j].map_index) += mimic_joints[j].multiplier * jac.data.col(j);
+    if(redundant_joints_locked)
+      for(std::size_t j=0; j < redundant_columns.size(); ++j)
+        jac_reduced.col(redundant_columns[j]).setZero();
+    if(position_ik)
+      jac_reduced.bottomRows(3).setZero();
+
+    for(int j=0; j < 6; ++j)
+      error(j) = (position_ik && j >= 3) ? 0.0 : delta_twist(j);
+    jtj.noalias() = jac_reduced.transpose() * jac_reduced;
+    jte.noalias() = jac_reduced.transpose() * error;
+
+    // damped step; retried with more damping until it reduces the error
+    bool accepted = false;
+    while(!accepted && i < maxiter)
+    {
+      for(int j=0; j < jtj.rows(); ++j)
+        jtj(j, j) += lambda * (jtj(j, j) + 1.0);
+      ldlt.compute(jtj);
+      step_reduced = ldlt.solve(jte);
+      for(int j=0; j < jtj.rows(); ++j)
+        jtj(j, j) = (jtj(j, j) - lambda) / (1.0 + lambda);
+
+      // apply the step to all joints and clamp it to the joint limits
+      for(std::size_t j=0; j < chain.getNrOfJoints(); ++j)
+        q_new(j) = q_temp(j) + mimic_joints[j].multiplier * step_reduced(mimic_joints[j].map_index);
+      for(std::size_t j=0; j < q_min.rows(); ++j)
+      {
+        if(q_new(j) < q_min(j))
+          q_new(j) = q_min(j);
+        else
+          if(q_new(j) > q_max(j))
+            q_new(j) = q_max(j);
+      }
+
+      double err_new = computeError(q_new, p_in, delta_twist_new);
+      if(err_new < err)
+      {
+        q_temp = q_new;
+        delta_twist = delta_twist_new;
+        err = err_new;
+        lambda = std::max(lambda / LAMBDA_FACTOR, LAMBDA_MIN);
+        accepted = true;
+      }
+      else
+      {
+        lambda *= LAMBDA_FACTOR;
+        if(lambda > LAMBDA_MAX)
+        {
+          q_out = q_temp;
+          last_iterations = i;
+          return -3;
+        }
+        ++i;
+      }
+    }
+  }
+
+  q_out = q_temp;
+  last_iterations = i;
+  if(i < maxiter)
+    return 0;
+  else
+    return -3;
+}
+
+}
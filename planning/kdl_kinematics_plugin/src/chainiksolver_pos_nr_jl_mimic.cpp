@@ -50,7 +50,8 @@ ChainIkSolverPos_NR_JL_Mimic::ChainIkSolverPos_NR_JL_Mimic(const Chain& _chain,
     delta_q(_chain.getNrOfJoints()),
     maxiter(_maxiter),
     eps(_eps),
-    position_ik(_position_ik)
+    position_ik(_position_ik),
+    last_iterations(0)
 {
   mimic_joints.resize(chain.getNrOfJoints());
   for(std::size_t i=0; i < mimic_joints.size(); ++i)
@@ -121,10 +122,8 @@ int ChainIkSolverPos_NR_JL_Mimic::CartToJntAdvanced(const JntArray& q_init, cons
   //  qToqMimic(q_init,q_temp);
 
   q_temp = q_init;
-  ROS_DEBUG_STREAM_NAMED("kdl","Input:");
-  for(std::size_t i=0; i < q_out.rows(); ++i)
-    ROS_DEBUG_NAMED("kdl","%d: %f",(int) i,q_out(i));
 
+  // nothing is logged per iteration: this loop is the innermost loop of IK
   unsigned int i;
   for(i=0;i<maxiter;++i)
   {
@@ -142,22 +141,10 @@ int ChainIkSolverPos_NR_JL_Mimic::CartToJntAdvanced(const JntArray& q_init, cons
         break;
     }
 
-    ROS_DEBUG_STREAM_NAMED("kdl","delta_twist");
-    for(std::size_t i=0; i < 6; ++i)
-      ROS_DEBUG_NAMED("kdl","%d: %f",(int) i, delta_twist(i));
-
     iksolver.CartToJnt(q_temp,delta_twist,delta_q);
 
     Add(q_temp,delta_q,q_temp);
 
-    ROS_DEBUG_STREAM_NAMED("kdl","delta_q");
-    for(std::size_t i=0; i < delta_q.rows(); ++i)
-      ROS_DEBUG_NAMED("kdl","%d: %f",(int) i, delta_q(i));
-
-    ROS_DEBUG_STREAM_NAMED("kdl","q_temp");
-    for(std::size_t i=0; i < q_temp.rows(); ++i)
-      ROS_DEBUG_NAMED("kdl","%d: %f",(int) i, q_temp(i));
-
     for(std::size_t j=0; j<q_min.rows(); ++j)
     {
       //      if(mimic_joints[j].active)
@@ -180,13 +167,7 @@ int ChainIkSolverPos_NR_JL_Mimic::CartToJntAdvanced(const JntArray& q_init, cons
 
   //  qMimicToq(q_temp, q_out);
   q_out = q_temp;
-  ROS_DEBUG_STREAM_NAMED("kdl","Full Solution:");
-  for(std::size_t i=0; i < q_temp.rows(); ++i)
-    ROS_DEBUG_NAMED("kdl","%d: %f",(int) i,q_temp(i));
-
-  ROS_DEBUG_STREAM_NAMED("kdl","Actual Solution:");
-  for(std::size_t i=0; i < q_out.rows(); ++i)
-    ROS_DEBUG_NAMED("kdl","%d: %f",(int) i,q_out(i));
+  last_iterations = i;
 
   if(i!=maxiter)
     return 0;
@@ -46,6 +46,13 @@
 #include <srdfdom/model.h>
 
 #include <moveit/rdf_loader/rdf_loader.h>
+#include <moveit/kinematics_plugin_loader/kinematics_plugin_loader.h>
+
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <deque>
+#include <limits>
 
 //register KDLKinematics as a KinematicsBase implementation
 CLASS_LOADER_REGISTER_CLASS(kdl_kinematics_plugin::KDLKinematicsPlugin, kinematics::KinematicsBase)
@@ -53,19 +60,196 @@ CLASS_LOADER_REGISTER_CLASS(kdl_kinematics_plugin::KDLKinematicsPlugin, kinemati
 namespace kdl_kinematics_plugin
 {
 
-  KDLKinematicsPlugin::KDLKinematicsPlugin():active_(false) {}
+  KDLKinematicsPlugin::KDLKinematicsPlugin():active_(false), parallel_seeds_(1), parallel_seed_closest_(false), use_lma_solver_(false), workspace_version_(0) {}
+
+class KDLKinematicsPlugin::SearchThreadPool
+{
+public:
+
+  SearchThreadPool(std::size_t thread_count) : stop_(false)
+  {
+    for (std::size_t i = 0 ; i < thread_count ; ++i)
+      threads_.create_thread(boost::bind(&SearchThreadPool::worker, this));
+  }
+
+  ~SearchThreadPool()
+  {
+    {
+      boost::mutex::scoped_lock slock(lock_);
+      stop_ = true;
+    }
+    task_available_.notify_all();
+    threads_.join_all();
+  }
+
+  /** \brief Run \e tasks on the threads of the pool and \e local_task on the calling thread, and wait until all of them
+      are done. Tasks of concurrent calls are queued, so a call may wait for the tasks of another one to finish */
+  void run(const std::vector<boost::function<void()> > &tasks, const boost::function<void()> &local_task)
+  {
+    std::size_t pending = tasks.size();
+    boost::condition_variable done;
+    {
+      boost::mutex::scoped_lock slock(lock_);
+      for (std::size_t i = 0 ; i < tasks.size() ; ++i)
+        tasks_.push_back(boost::bind(&SearchThreadPool::runTask, this, tasks[i], &pending, &done));
+    }
+    task_available_.notify_all();
+    local_task();
+    boost::mutex::scoped_lock slock(lock_);
+    while (pending > 0)
+      done.wait(slock);
+  }
+
+private:
+
+  void runTask(const boost::function<void()> &task, std::size_t *pending, boost::condition_variable *done)
+  {
+    task();
+    boost::mutex::scoped_lock slock(lock_);
+    if (--(*pending) == 0)
+      done->notify_all();
+  }
+
+  void worker()
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    while (true)
+    {
+      while (tasks_.empty() && !stop_)
+        task_available_.wait(slock);
+      if (stop_)
+        return;
+      boost::function<void()> task = tasks_.front();
+      tasks_.pop_front();
+      slock.unlock();
+      task();
+      slock.lock();
+    }
+  }
+
+  boost::thread_group threads_;
+  std::deque<boost::function<void()> > tasks_;
+  boost::mutex lock_;
+  boost::condition_variable task_available_;
+  bool stop_;
+};
+
+KDLKinematicsPlugin::~KDLKinematicsPlugin()
+{
+}
+
+struct KDLKinematicsPlugin::SharedSearch
+{
+  SharedSearch() : winner_(-1), stop_(false)
+  {
+  }
+
+  const geometry_msgs::Pose *ik_pose_;
+  KDL::Frame pose_desired_;
+  ros::WallTime deadline_;
+  const IKCallbackFn *solution_callback_;
+  const std::vector<double> *consistency_limits_;
+  const kinematics::KinematicsQueryOptions *options_;
+
+  /** One workspace, solution and error code per thread */
+  std::vector<SolverWorkspacePtr> workspaces_;
+  std::vector<std::vector<double> > solutions_;
+  std::vector<moveit_msgs::MoveItErrorCodes> error_codes_;
+
+  /** The thread that found a solution first, or -1 */
+  int winner_;
+
+  /** Serializes the calls to the solution callback, which need not be thread safe, and protects winner_ */
+  boost::mutex lock_;
+
+  /** Set when the search can end */
+  boost::atomic<bool> stop_;
+};
+
+KDLKinematicsPlugin::SolverWorkspace::SolverWorkspace(const KDLKinematicsPlugin &plugin) :
+  fk_solver_(plugin.kdl_chain_),
+  ik_solver_vel_(plugin.kdl_chain_, plugin.joint_model_group_->getMimicJointModels().size(), plugin.redundant_joint_indices_.size(), plugin.position_ik_),
+  ik_solver_pos_(plugin.kdl_chain_, plugin.joint_min_, plugin.joint_max_, fk_solver_, ik_solver_vel_,
+                 plugin.max_solver_iterations_, plugin.epsilon_, plugin.position_ik_),
+  jnt_seed_state_(plugin.dimension_),
+  jnt_pos_in_(plugin.dimension_),
+  jnt_pos_out_(plugin.dimension_),
+  values_(plugin.dimension_, 0.0),
+  near_(plugin.dimension_, 0.0),
+  workspace_version_(plugin.workspace_version_),
+  valid_(true)
+{
+  consistency_limits_mimic_.reserve(plugin.dimension_);
+  ik_solver_vel_.setMimicJoints(plugin.mimic_joints_);
+  ik_solver_pos_.setMimicJoints(plugin.mimic_joints_);
+  if (!plugin.redundant_joint_indices_.empty() && !ik_solver_vel_.setRedundantJointsMapIndex(plugin.redundant_joints_map_index_))
+  {
+    ROS_ERROR_NAMED("kdl","Could not set redundant joints");
+    valid_ = false;
+  }
+  ik_solver_ = &ik_solver_pos_;
+  if (plugin.use_lma_solver_)
+  {
+    ik_solver_lma_.reset(new KDL::ChainIkSolverPos_LMA_JL_Mimic(plugin.kdl_chain_, plugin.joint_min_, plugin.joint_max_,
+                                                                plugin.joint_model_group_->getMimicJointModels().size(),
+                                                                plugin.redundant_joint_indices_.size(),
+                                                                plugin.max_solver_iterations_, plugin.epsilon_, plugin.position_ik_));
+    ik_solver_lma_->setMimicJoints(plugin.mimic_joints_);
+    if (!plugin.redundant_joint_indices_.empty() && !ik_solver_lma_->setRedundantJointsMapIndex(plugin.redundant_joints_map_index_))
+    {
+      ROS_ERROR_NAMED("kdl","Could not set redundant joints");
+      valid_ = false;
+    }
+    ik_solver_ = ik_solver_lma_.get();
+  }
+}
+
+void KDLKinematicsPlugin::SolverWorkspace::setRedundantJointsLocked(bool locked)
+{
+  if (locked)
+  {
+    ik_solver_vel_.lockRedundantJoints();
+    if (ik_solver_lma_)
+      ik_solver_lma_->lockRedundantJoints();
+  }
+  else
+  {
+    ik_solver_vel_.unlockRedundantJoints();
+    if (ik_solver_lma_)
+      ik_solver_lma_->unlockRedundantJoints();
+  }
+}
+
+KDLKinematicsPlugin::SolverWorkspacePtr KDLKinematicsPlugin::acquireWorkspace() const
+{
+  {
+    boost::mutex::scoped_lock slock(workspaces_lock_);
+    if (!workspaces_.empty())
+    {
+      SolverWorkspacePtr workspace = workspaces_.back();
+      workspaces_.pop_back();
+      return workspace;
+    }
+  }
+  return SolverWorkspacePtr(new SolverWorkspace(*this));
+}
 
-void KDLKinematicsPlugin::getRandomConfiguration(KDL::JntArray &jnt_array, bool lock_redundancy) const
+void KDLKinematicsPlugin::releaseWorkspace(const SolverWorkspacePtr &workspace) const
 {
-  std::vector<double> jnt_array_vector(dimension_, 0.0);
-  state_->setToRandomPositions(joint_model_group_);
-  state_->copyJointGroupPositions(joint_model_group_, &jnt_array_vector[0]);
+  boost::mutex::scoped_lock slock(workspaces_lock_);
+  if (workspace->workspace_version_ == workspace_version_)
+    workspaces_.push_back(workspace);
+}
+
+void KDLKinematicsPlugin::getRandomConfiguration(SolverWorkspace &workspace, KDL::JntArray &jnt_array, bool lock_redundancy) const
+{
+  joint_model_group_->getVariableRandomPositions(workspace.rng_, workspace.values_);
   for (std::size_t i = 0; i < dimension_; ++i)
   {
     if (lock_redundancy)
       if (isRedundantJoint(i))
         continue;
-    jnt_array(i) = jnt_array_vector[i];
+    jnt_array(i) = workspace.values_[i];
   }
 }
 
@@ -77,18 +261,20 @@ bool KDLKinematicsPlugin::isRedundantJoint(unsigned int index) const
   return false;
 }
 
-void KDLKinematicsPlugin::getRandomConfiguration(const KDL::JntArray &seed_state,
+void KDLKinematicsPlugin::getRandomConfiguration(SolverWorkspace &workspace,
+                                                 const KDL::JntArray &seed_state,
                                                  const std::vector<double> &consistency_limits,
                                                  KDL::JntArray &jnt_array,
                                                  bool lock_redundancy) const
 {
-  std::vector<double> values(dimension_, 0.0);
-  std::vector<double> near(dimension_, 0.0);
+  std::vector<double> &values = workspace.values_;
+  std::vector<double> &near = workspace.near_;
   for (std::size_t i = 0 ; i < dimension_; ++i)
     near[i] = seed_state(i);
 
   // Need to resize the consistency limits to remove mimic joints
-  std::vector<double> consistency_limits_mimic;
+  std::vector<double> &consistency_limits_mimic = workspace.consistency_limits_mimic_;
+  consistency_limits_mimic.clear();
   for(std::size_t i = 0; i < dimension_; ++i)
   {
     if(!mimic_joints_[i].active)
@@ -96,7 +282,7 @@ void KDLKinematicsPlugin::getRandomConfiguration(const KDL::JntArray &seed_state
     consistency_limits_mimic.push_back(consistency_limits[i]);
   }
 
-  joint_model_group_->getVariableRandomPositionsNearBy(state_->getRandomNumberGenerator(), values, near, consistency_limits_mimic);
+  joint_model_group_->getVariableRandomPositionsNearBy(workspace.rng_, values, near, consistency_limits_mimic);
   
   for (std::size_t i = 0; i < dimension_; ++i)
   {
@@ -133,19 +319,28 @@ bool KDLKinematicsPlugin::initialize(const std::string &robot_description,
   setValues(robot_description, group_name, base_frame, tip_frame, search_discretization);
 
   ros::NodeHandle private_handle("~");
-  rdf_loader::RDFLoader rdf_loader(robot_description_);
-  const boost::shared_ptr<srdf::Model> &srdf = rdf_loader.getSRDF();
-  const boost::shared_ptr<urdf::ModelInterface>& urdf_model = rdf_loader.getURDF();
 
-  if (!urdf_model || !srdf)
+  // use the model the loader already built, if there is one; parsing the robot description is slow
+  robot_model::RobotModelConstPtr robot_model = kinematics_plugin_loader::getRobotModelForInitialization();
+  own_robot_model_.reset();
+  if (!robot_model)
   {
-    ROS_ERROR_NAMED("kdl","URDF and SRDF must be loaded for KDL kinematics solver to work.");
-    return false;
-  }
+    rdf_loader::RDFLoader rdf_loader(robot_description_);
+    const boost::shared_ptr<srdf::Model> &srdf = rdf_loader.getSRDF();
+    const boost::shared_ptr<urdf::ModelInterface>& urdf_model = rdf_loader.getURDF();
 
-  robot_model_.reset(new robot_model::RobotModel(urdf_model, srdf));
+    if (!urdf_model || !srdf)
+    {
+      ROS_ERROR_NAMED("kdl","URDF and SRDF must be loaded for KDL kinematics solver to work.");
+      return false;
+    }
 
-  robot_model::JointModelGroup* joint_model_group = robot_model_->getJointModelGroup(group_name);
+    own_robot_model_.reset(new robot_model::RobotModel(urdf_model, srdf));
+    robot_model = own_robot_model_;
+  }
+  robot_model_ = robot_model;
+
+  const robot_model::JointModelGroup* joint_model_group = robot_model->getJointModelGroup(group_name);
   if (!joint_model_group)
     return false;
   
@@ -162,7 +357,7 @@ bool KDLKinematicsPlugin::initialize(const std::string &robot_description,
 
   KDL::Tree kdl_tree;
 
-  if (!kdl_parser::treeFromUrdfModel(*urdf_model, kdl_tree))
+  if (!kdl_parser::treeFromUrdfModel(*robot_model->getURDF(), kdl_tree))
   {
     ROS_ERROR_NAMED("kdl","Could not initialize tree object");
     return false;
@@ -172,6 +367,9 @@ bool KDLKinematicsPlugin::initialize(const std::string &robot_description,
     ROS_ERROR_NAMED("kdl","Could not initialize chain object");
     return false;
   }
+  segment_index_.clear();
+  for(unsigned int i=0; i < kdl_chain_.getNrOfSegments(); i++)
+    segment_index_[kdl_chain_.getSegment(i).getName()] = i+1;
 
   dimension_ = joint_model_group->getActiveJointModels().size() + joint_model_group->getMimicJointModels().size();
   for (std::size_t i=0; i < joint_model_group->getJointModels().size(); ++i)
@@ -212,6 +410,12 @@ bool KDLKinematicsPlugin::initialize(const std::string &robot_description,
   private_handle.param("max_solver_iterations", max_solver_iterations, 500);
   private_handle.param("epsilon", epsilon, 1e-5);
   private_handle.param(group_name+"/position_only_ik", position_ik, false);
+  int parallel_seeds;
+  std::string parallel_seed_selection;
+  private_handle.param(group_name+"/parallel_seeds", parallel_seeds, 1);
+  private_handle.param(group_name+"/parallel_seed_selection", parallel_seed_selection, std::string("first"));
+  std::string solver_type;
+  private_handle.param(group_name+"/solver_type", solver_type, std::string("newton_raphson"));
   ROS_DEBUG_NAMED("kdl","Looking in private handle: %s for param name: %s",
             private_handle.getNamespace().c_str(),
             (group_name+"/position_only_ik").c_str());
@@ -219,6 +423,33 @@ bool KDLKinematicsPlugin::initialize(const std::string &robot_description,
   if(position_ik)
     ROS_INFO_NAMED("kdl","Using position only ik");
 
+  if (parallel_seed_selection != "first" && parallel_seed_selection != "closest")
+  {
+    ROS_WARN_NAMED("kdl","Unknown parallel seed selection '%s'; expected 'first' or 'closest'. Assuming 'first'", parallel_seed_selection.c_str());
+    parallel_seed_selection = "first";
+  }
+  if (solver_type == "levenberg_marquardt")
+  {
+    use_lma_solver_ = true;
+    ROS_INFO_NAMED("kdl","Using the Levenberg-Marquardt position solver");
+  }
+  else
+  {
+    if (solver_type != "newton_raphson")
+      ROS_WARN_NAMED("kdl","Unknown solver type '%s'; expected 'newton_raphson' or 'levenberg_marquardt'. Assuming 'newton_raphson'", solver_type.c_str());
+    use_lma_solver_ = false;
+  }
+  parallel_seeds_ = parallel_seeds > 1 ? parallel_seeds : 1;
+  parallel_seed_closest_ = parallel_seed_selection == "closest";
+  // the calling thread searches from the given seed; the others are kept for the lifetime of the plugin
+  search_threads_.reset();
+  if (parallel_seeds_ > 1)
+  {
+    search_threads_.reset(new SearchThreadPool(parallel_seeds_ - 1));
+    ROS_INFO_NAMED("kdl","Searching from %u seeds in parallel, returning the %s solution", parallel_seeds_,
+                   parallel_seed_closest_ ? "closest" : "first");
+  }
+
   num_possible_redundant_joints_ = kdl_chain_.getNrOfJoints() - joint_model_group->getMimicJointModels().size() - (position_ik? 3:6);
 
   // Check for mimic joints
@@ -229,7 +460,7 @@ bool KDLKinematicsPlugin::initialize(const std::string &robot_description,
   unsigned int joint_counter = 0;
   for (std::size_t i = 0; i < kdl_chain_.getNrOfSegments(); ++i)
   {
-    const robot_model::JointModel *jm = robot_model_->getJointModel(kdl_chain_.segments[i].getJoint().getName());
+    const robot_model::JointModel *jm = robot_model->getJointModel(kdl_chain_.segments[i].getJoint().getName());
     
     //first check whether it belongs to the set of active joints in the group
     if (jm->getMimic() == NULL && jm->getVariableCount() > 0)
@@ -272,16 +503,19 @@ bool KDLKinematicsPlugin::initialize(const std::string &robot_description,
   }
   mimic_joints_ = mimic_joints;
 
-  // Setup the joint state groups that we need
-  state_.reset(new robot_state::RobotState(robot_model_));
-  state_2_.reset(new robot_state::RobotState(robot_model_));
-
   // Store things for when the set of redundant joints may change
   position_ik_ = position_ik;
   joint_model_group_ = joint_model_group;
   max_solver_iterations_ = max_solver_iterations;
   epsilon_ = epsilon;
 
+  // workspaces constructed for a previous configuration must not be reused
+  {
+    boost::mutex::scoped_lock slock(workspaces_lock_);
+    ++workspace_version_;
+    workspaces_.clear();
+  }
+
   active_ = true;
   ROS_DEBUG_NAMED("kdl","KDL solver initialized");
   return true;
@@ -342,6 +576,13 @@ bool KDLKinematicsPlugin::setRedundantJoints(const std::vector<unsigned int> &re
 
   redundant_joints_map_index_ = redundant_joints_map_index;
   redundant_joint_indices_ = redundant_joints;
+
+  // the velocity solver depends on the number of redundant joints, so workspaces need to be constructed again
+  {
+    boost::mutex::scoped_lock slock(workspaces_lock_);
+    ++workspace_version_;
+    workspaces_.clear();
+  }
   return true;
 }
 
@@ -356,19 +597,8 @@ int KDLKinematicsPlugin::getJointIndex(const std::string &name) const
 
 int KDLKinematicsPlugin::getKDLSegmentIndex(const std::string &name) const
 {
-  int i=0;
-  while (i < (int)kdl_chain_.getNrOfSegments()) {
-    if (kdl_chain_.getSegment(i).getName() == name) {
-      return i+1;
-    }
-    i++;
-  }
-  return -1;
-}
-
-bool KDLKinematicsPlugin::timedOut(const ros::WallTime &start_time, double duration) const
-{
-  return ((ros::WallTime::now()-start_time).toSec() >= duration);
+  std::map<std::string, int>::const_iterator it = segment_index_.find(name);
+  return it == segment_index_.end() ? -1 : it->second;
 }
 
 bool KDLKinematicsPlugin::getPositionIK(const geometry_msgs::Pose &ik_pose,
@@ -476,7 +706,7 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::Pose &ik_pose,
                                            const std::vector<double> &consistency_limits,
                                            const kinematics::KinematicsQueryOptions &options) const
 {
-  ros::WallTime n1 = ros::WallTime::now();
+  ros::WallTime deadline = ros::WallTime::now() + ros::WallDuration(timeout);
   if(!active_)
   {
     ROS_ERROR_NAMED("kdl","kinematics not active");
@@ -498,25 +728,21 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::Pose &ik_pose,
     return false;
   }
 
-  KDL::JntArray jnt_seed_state(dimension_);
-  KDL::JntArray jnt_pos_in(dimension_);
-  KDL::JntArray jnt_pos_out(dimension_);
-
-  KDL::ChainFkSolverPos_recursive fk_solver(kdl_chain_);
-  KDL::ChainIkSolverVel_pinv_mimic ik_solver_vel(kdl_chain_, joint_model_group_->getMimicJointModels().size(), redundant_joint_indices_.size(), position_ik_);
-  KDL::ChainIkSolverPos_NR_JL_Mimic ik_solver_pos(kdl_chain_, joint_min_, joint_max_, fk_solver, ik_solver_vel, max_solver_iterations_, epsilon_, position_ik_);
-  ik_solver_vel.setMimicJoints(mimic_joints_);
-  ik_solver_pos.setMimicJoints(mimic_joints_);
-
-  if ((redundant_joint_indices_.size() > 0) && !ik_solver_vel.setRedundantJointsMapIndex(redundant_joints_map_index_))
+  // the group used while searching belongs to the model, which must outlive the search
+  robot_model::RobotModelConstPtr robot_model = robot_model_.lock();
+  if (!robot_model)
   {
-    ROS_ERROR_NAMED("kdl","Could not set redundant joints");
+    ROS_ERROR_NAMED("kdl","The robot model this solver was initialized for no longer exists");
+    error_code.val = error_code.NO_IK_SOLUTION;
     return false;
   }
 
-  if(options.lock_redundant_joints)
+  SolverWorkspacePtr workspace = acquireWorkspace();
+  if (!workspace->valid_)
   {
-    ik_solver_vel.lockRedundantJoints();
+    releaseWorkspace(workspace);
+    error_code.val = error_code.NO_IK_SOLUTION;
+    return false;
   }
 
   solution.resize(dimension_);
@@ -532,73 +758,224 @@ bool KDLKinematicsPlugin::searchPositionIK(const geometry_msgs::Pose &ik_pose,
                    ik_pose.orientation.y << " " <<
                    ik_pose.orientation.z << " " <<
                    ik_pose.orientation.w);
-  //Do the IK
   for(unsigned int i=0; i < dimension_; i++)
-    jnt_seed_state(i) = ik_seed_state[i];
-  jnt_pos_in = jnt_seed_state;
+    workspace->jnt_seed_state_(i) = ik_seed_state[i];
+  workspace->jnt_pos_in_ = workspace->jnt_seed_state_;
+
+  bool result;
+  if (parallel_seeds_ > 1)
+    result = searchInParallel(workspace, ik_pose, pose_desired, deadline, solution, solution_callback,
+                              error_code, consistency_limits, options);
+  else
+    result = searchWithWorkspace(*workspace, ik_pose, pose_desired, deadline, 0, solution, solution_callback,
+                                 error_code, consistency_limits, options, NULL);
+  releaseWorkspace(workspace);
+  return result;
+}
 
+bool KDLKinematicsPlugin::searchWithWorkspace(SolverWorkspace &workspace,
+                                              const geometry_msgs::Pose &ik_pose,
+                                              const KDL::Frame &pose_desired,
+                                              const ros::WallTime &deadline,
+                                              unsigned int max_attempts,
+                                              std::vector<double> &solution,
+                                              const IKCallbackFn &solution_callback,
+                                              moveit_msgs::MoveItErrorCodes &error_code,
+                                              const std::vector<double> &consistency_limits,
+                                              const kinematics::KinematicsQueryOptions &options,
+                                              SharedSearch *shared) const
+{
+  KDL::JntArray &jnt_seed_state = workspace.jnt_seed_state_;
+  KDL::JntArray &jnt_pos_in = workspace.jnt_pos_in_;
+  KDL::JntArray &jnt_pos_out = workspace.jnt_pos_out_;
+
+  workspace.setRedundantJointsLocked(options.lock_redundant_joints);
+
+  //Do the IK; nothing in this loop allocates memory, and only the clock is queried once per restart
   unsigned int counter(0);
   while(1)
   {
-    //    ROS_DEBUG_NAMED("kdl","Iteration: %d, time: %f, Timeout: %f",counter,(ros::WallTime::now()-n1).toSec(),timeout);
-    counter++;
-    if(timedOut(n1,timeout))
+    if(ros::WallTime::now() >= deadline)
     {
-      ROS_DEBUG_NAMED("kdl","IK timed out");
+      ROS_DEBUG_NAMED("kdl","IK timed out after %u restarts", counter);
       error_code.val = error_code.TIMED_OUT;
-      ik_solver_vel.unlockRedundantJoints();
+      workspace.setRedundantJointsLocked(false);
       return false;
     }
-    int ik_valid = ik_solver_pos.CartToJnt(jnt_pos_in, pose_desired, jnt_pos_out);
-    ROS_DEBUG_NAMED("kdl","IK valid: %d", ik_valid);
+    if((max_attempts > 0 && counter >= max_attempts) || (shared && shared->stop_))
+    {
+      error_code.val = error_code.NO_IK_SOLUTION;
+      workspace.setRedundantJointsLocked(false);
+      return false;
+    }
+    counter++;
+    int ik_valid = workspace.ik_solver_->CartToJnt(jnt_pos_in, pose_desired, jnt_pos_out);
     if(!consistency_limits.empty())
     {
-      getRandomConfiguration(jnt_seed_state, consistency_limits, jnt_pos_in, options.lock_redundant_joints);
+      getRandomConfiguration(workspace, jnt_seed_state, consistency_limits, jnt_pos_in, options.lock_redundant_joints);
       if( (ik_valid < 0 && !options.return_approximate_solution) || !checkConsistency(jnt_seed_state, consistency_limits, jnt_pos_out))
-      {
-        ROS_DEBUG_NAMED("kdl","Could not find IK solution: does not match consistency limits");
         continue;
-      }
     }
     else
     {
-      getRandomConfiguration(jnt_pos_in, options.lock_redundant_joints);
-      ROS_DEBUG_NAMED("kdl","New random configuration");
-      for(unsigned int j=0; j < dimension_; j++)
-        ROS_DEBUG_NAMED("kdl","%d %f", j, jnt_pos_in(j));
-
+      getRandomConfiguration(workspace, jnt_pos_in, options.lock_redundant_joints);
       if(ik_valid < 0 && !options.return_approximate_solution)
-      {
-        ROS_DEBUG_NAMED("kdl","Could not find IK solution");
         continue;
-      }
     }
-    ROS_DEBUG_NAMED("kdl","Found IK solution");
     for(unsigned int j=0; j < dimension_; j++)
       solution[j] = jnt_pos_out(j);
     if(!solution_callback.empty())
-      solution_callback(ik_pose,solution,error_code);
+    {
+      if (shared)
+      {
+        boost::mutex::scoped_lock slock(shared->lock_);
+        if (shared->stop_)
+          continue;
+        solution_callback(ik_pose,solution,error_code);
+        // no other thread may call the callback once the first solution was accepted
+        if (error_code.val == error_code.SUCCESS && !parallel_seed_closest_)
+          shared->stop_ = true;
+      }
+      else
+        solution_callback(ik_pose,solution,error_code);
+    }
     else
       error_code.val = error_code.SUCCESS;
 
     if(error_code.val == error_code.SUCCESS)
     {
       ROS_DEBUG_STREAM_NAMED("kdl","Solved after " << counter << " iterations");
-      ik_solver_vel.unlockRedundantJoints();
+      workspace.setRedundantJointsLocked(false);
       return true;
     }
   }
-  ROS_DEBUG_NAMED("kdl","An IK that satisifes the constraints and is collision free could not be found");
-  error_code.val = error_code.NO_IK_SOLUTION;
-  ik_solver_vel.unlockRedundantJoints();
-  return false;
+}
+
+void KDLKinematicsPlugin::searchThread(SharedSearch *shared, std::size_t index) const
+{
+  if (searchWithWorkspace(*shared->workspaces_[index], *shared->ik_pose_, shared->pose_desired_, shared->deadline_, 0,
+                          shared->solutions_[index], *shared->solution_callback_, shared->error_codes_[index],
+                          *shared->consistency_limits_, *shared->options_, shared))
+  {
+    boost::mutex::scoped_lock slock(shared->lock_);
+    if (shared->winner_ < 0)
+      shared->winner_ = index;
+    if (!parallel_seed_closest_)
+      shared->stop_ = true;
+  }
+}
+
+bool KDLKinematicsPlugin::searchInParallel(const SolverWorkspacePtr &workspace,
+                                           const geometry_msgs::Pose &ik_pose,
+                                           const KDL::Frame &pose_desired,
+                                           const ros::WallTime &deadline,
+                                           std::vector<double> &solution,
+                                           const IKCallbackFn &solution_callback,
+                                           moveit_msgs::MoveItErrorCodes &error_code,
+                                           const std::vector<double> &consistency_limits,
+                                           const kinematics::KinematicsQueryOptions &options) const
+{
+  // most poses are solved from the given seed right away; only start threads for the ones that are not
+  if (searchWithWorkspace(*workspace, ik_pose, pose_desired, deadline, 1, solution, solution_callback,
+                          error_code, consistency_limits, options, NULL))
+    return true;
+  if (error_code.val == error_code.TIMED_OUT)
+    return false;
+
+  SharedSearch shared;
+  shared.ik_pose_ = &ik_pose;
+  shared.pose_desired_ = pose_desired;
+  shared.deadline_ = deadline;
+  shared.solution_callback_ = &solution_callback;
+  shared.consistency_limits_ = &consistency_limits;
+  shared.options_ = &options;
+  shared.workspaces_.resize(parallel_seeds_);
+  shared.solutions_.resize(parallel_seeds_, std::vector<double>(dimension_, 0.0));
+  shared.error_codes_.resize(parallel_seeds_);
+
+  // the first thread continues from where the attempt above left off; the others start at random configurations
+  shared.workspaces_[0] = workspace;
+  for (std::size_t i = 1 ; i < parallel_seeds_ ; ++i)
+  {
+    shared.workspaces_[i] = acquireWorkspace();
+    SolverWorkspace &ws = *shared.workspaces_[i];
+    ws.jnt_seed_state_ = workspace->jnt_seed_state_;
+    ws.jnt_pos_in_ = workspace->jnt_seed_state_;
+    if (consistency_limits.empty())
+      getRandomConfiguration(ws, ws.jnt_pos_in_, options.lock_redundant_joints);
+    else
+      getRandomConfiguration(ws, ws.jnt_seed_state_, consistency_limits, ws.jnt_pos_in_, options.lock_redundant_joints);
+  }
+
+  std::vector<boost::function<void()> > tasks;
+  tasks.reserve(parallel_seeds_ - 1);
+  for (std::size_t i = 1 ; i < parallel_seeds_ ; ++i)
+    if (shared.workspaces_[i]->valid_)
+      tasks.push_back(boost::bind(&KDLKinematicsPlugin::searchThread, this, &shared, i));
+
+  // the calling thread continues from the given seed while the pool searches from the random ones
+  search_threads_->run(tasks, boost::bind(&KDLKinematicsPlugin::searchThread, this, &shared, 0));
+
+  for (std::size_t i = 1 ; i < parallel_seeds_ ; ++i)
+    releaseWorkspace(shared.workspaces_[i]);
+
+  // pick the first solution found, or the one closest to the seed
+  int best = shared.winner_;
+  if (parallel_seed_closest_)
+  {
+    double best_distance = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0 ; i < parallel_seeds_ ; ++i)
+      if (shared.error_codes_[i].val == error_code.SUCCESS)
+      {
+        double d = 0.0;
+        for (unsigned int j = 0 ; j < dimension_ ; ++j)
+        {
+          double diff = shared.solutions_[i][j] - workspace->jnt_seed_state_(j);
+          d += diff * diff;
+        }
+        if (d < best_distance)
+        {
+          best = i;
+          best_distance = d;
+        }
+      }
+  }
+
+  if (best < 0)
+  {
+    error_code.val = shared.error_codes_[0].val;
+    return false;
+  }
+  solution = shared.solutions_[best];
+  error_code.val = error_code.SUCCESS;
+  return true;
+}
+
+bool KDLKinematicsPlugin::getRequestedSegments(const std::vector<std::string> &link_names,
+                                               std::vector<std::pair<int, std::size_t> > &segments) const
+{
+  segments.clear();
+  segments.reserve(link_names.size());
+  bool valid = true;
+  for(std::size_t i=0; i < link_names.size(); i++)
+  {
+    int index = getKDLSegmentIndex(link_names[i]);
+    if(index < 0)
+    {
+      ROS_ERROR_NAMED("kdl","Could not compute FK for %s",link_names[i].c_str());
+      valid = false;
+    }
+    else
+      segments.push_back(std::make_pair(index, i));
+  }
+  std::sort(segments.begin(), segments.end());
+  return valid;
 }
 
 bool KDLKinematicsPlugin::getPositionFK(const std::vector<std::string> &link_names,
                                         const std::vector<double> &joint_angles,
                                         std::vector<geometry_msgs::Pose> &poses) const
 {
-  ros::WallTime n1 = ros::WallTime::now();
   if(!active_)
   {
     ROS_ERROR_NAMED("kdl","kinematics not active");
@@ -611,30 +988,45 @@ bool KDLKinematicsPlugin::getPositionFK(const std::vector<std::string> &link_nam
     return false;
   }
 
-  KDL::Frame p_out;
-  geometry_msgs::PoseStamped pose;
-  tf::Stamped<tf::Pose> tf_pose;
-
-  KDL::JntArray jnt_pos_in(dimension_);
-  for(unsigned int i=0; i < dimension_; i++)
+  std::vector<std::pair<int, std::size_t> > segments;
+  bool valid = getRequestedSegments(link_names, segments);
+  if(!segments.empty())
   {
-    jnt_pos_in(i) = joint_angles[i];
+    std::vector<KDL::Frame> frames(link_names.size());
+    computeSegmentFrames(kdl_chain_, &joint_angles[0], segments, &frames[0]);
+    for(std::size_t i=0; i < segments.size(); i++)
+      tf::poseKDLToMsg(frames[segments[i].second], poses[segments[i].second]);
   }
+  return valid;
+}
 
-  KDL::ChainFkSolverPos_recursive fk_solver(kdl_chain_);
+bool KDLKinematicsPlugin::getPositionFKBatch(const std::vector<std::string> &link_names,
+                                             const std::vector<double> &joint_angles,
+                                             std::vector<geometry_msgs::Pose> &poses) const
+{
+  if(!active_)
+  {
+    ROS_ERROR_NAMED("kdl","kinematics not active");
+    return false;
+  }
+  if(dimension_ == 0 || joint_angles.size() % dimension_ != 0)
+  {
+    ROS_ERROR_NAMED("kdl","Joint angles vector must have a size that is a multiple of: %d",dimension_);
+    return false;
+  }
+  std::size_t configuration_count = joint_angles.size() / dimension_;
+  poses.resize(configuration_count * link_names.size());
 
-  bool valid = true;
-  for(unsigned int i=0; i < poses.size(); i++)
+  std::vector<std::pair<int, std::size_t> > segments;
+  bool valid = getRequestedSegments(link_names, segments);
+  if(!segments.empty())
   {
-    ROS_DEBUG_NAMED("kdl","End effector index: %d",getKDLSegmentIndex(link_names[i]));
-    if(fk_solver.JntToCart(jnt_pos_in,p_out,getKDLSegmentIndex(link_names[i])) >=0)
+    std::vector<KDL::Frame> frames(link_names.size());
+    for(std::size_t c=0; c < configuration_count; c++)
     {
-      tf::poseKDLToMsg(p_out,poses[i]);
-    }
-    else
-    {
-      ROS_ERROR_NAMED("kdl","Could not compute FK for %s",link_names[i].c_str());
-      valid = false;
+      computeSegmentFrames(kdl_chain_, &joint_angles[c * dimension_], segments, &frames[0]);
+      for(std::size_t i=0; i < segments.size(); i++)
+        tf::poseKDLToMsg(frames[segments[i].second], poses[c * link_names.size() + segments[i].second]);
     }
   }
   return valid;
@@ -0,0 +1,123 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/kdl_kinematics_plugin/chain_segment_frames.hpp>
+#include <kdl/chainfksolverpos_recursive.hpp>
+#include <random_numbers/random_numbers.h>
+#include <algorithm>
+
+// A chain with fixed segments at the start, in the middle and at the end, as produced for links without joints
+static KDL::Chain makeChain()
+{
+  KDL::Chain chain;
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::None), KDL::Frame(KDL::Vector(0.0, 0.1, 0.2))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotZ), KDL::Frame(KDL::Vector(0.0, 0.0, 0.3))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotY), KDL::Frame(KDL::Vector(0.0, 0.0, 0.4))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::None), KDL::Frame(KDL::Rotation::RPY(0.1, 0.2, 0.3), KDL::Vector(0.1, 0.0, 0.0))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::TransX), KDL::Frame(KDL::Vector(0.0, 0.0, 0.1))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotX), KDL::Frame(KDL::Vector(0.0, 0.2, 0.0))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::None), KDL::Frame(KDL::Vector(0.0, 0.0, 0.05))));
+  return chain;
+}
+
+static void expectSameAsRecursiveSolver(const KDL::Chain &chain, const KDL::JntArray &q,
+                                        const std::vector<std::pair<int, std::size_t> > &segments)
+{
+  std::vector<KDL::Frame> frames(segments.size());
+  kdl_kinematics_plugin::computeSegmentFrames(chain, q.data.data(), segments, &frames[0]);
+
+  KDL::ChainFkSolverPos_recursive fk(chain);
+  for (std::size_t i = 0 ; i < segments.size() ; ++i)
+  {
+    KDL::Frame expected;
+    ASSERT_GE(fk.JntToCart(q, expected, segments[i].first), 0);
+    EXPECT_TRUE(KDL::Equal(expected, frames[segments[i].second], 1e-12)) << "segment " << segments[i].first;
+  }
+}
+
+TEST(ChainSegmentFrames, MatchesRecursiveSolverForEverySegment)
+{
+  KDL::Chain chain = makeChain();
+  std::vector<std::pair<int, std::size_t> > segments;
+  for (unsigned int s = 0 ; s <= chain.getNrOfSegments() ; ++s)
+    segments.push_back(std::make_pair((int)s, (std::size_t)s));
+
+  random_numbers::RandomNumberGenerator rng(3);
+  KDL::JntArray q(chain.getNrOfJoints());
+  for (int t = 0 ; t < 100 ; ++t)
+  {
+    for (unsigned int i = 0 ; i < q.rows() ; ++i)
+      q(i) = rng.uniformReal(-3.0, 3.0);
+    expectSameAsRecursiveSolver(chain, q, segments);
+  }
+}
+
+TEST(ChainSegmentFrames, MatchesRecursiveSolverForSomeSegments)
+{
+  // the frames are written in the order of the request, which differs from the order along the chain, and a segment
+  // can be requested more than once
+  KDL::Chain chain = makeChain();
+  std::vector<std::pair<int, std::size_t> > segments;
+  segments.push_back(std::make_pair(2, 3));
+  segments.push_back(std::make_pair(4, 0));
+  segments.push_back(std::make_pair(4, 2));
+  segments.push_back(std::make_pair(6, 1));
+  std::sort(segments.begin(), segments.end());
+
+  random_numbers::RandomNumberGenerator rng(5);
+  KDL::JntArray q(chain.getNrOfJoints());
+  for (int t = 0 ; t < 100 ; ++t)
+  {
+    for (unsigned int i = 0 ; i < q.rows() ; ++i)
+      q(i) = rng.uniformReal(-3.0, 3.0);
+    expectSameAsRecursiveSolver(chain, q, segments);
+  }
+}
+
+TEST(ChainSegmentFrames, ComputesTheBaseFrame)
+{
+  KDL::Chain chain = makeChain();
+  KDL::JntArray q(chain.getNrOfJoints());
+  std::vector<std::pair<int, std::size_t> > segments(1, std::make_pair(0, 0));
+  KDL::Frame frame(KDL::Vector(1.0, 1.0, 1.0));
+  kdl_kinematics_plugin::computeSegmentFrames(chain, q.data.data(), segments, &frame);
+  EXPECT_TRUE(KDL::Equal(KDL::Frame::Identity(), frame));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
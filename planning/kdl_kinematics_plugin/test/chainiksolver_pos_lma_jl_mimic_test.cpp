@@ -0,0 +1,191 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/kdl_kinematics_plugin/chainiksolver_pos_lma_jl_mimic.hpp>
+#include <kdl/chainfksolverpos_recursive.hpp>
+#include <random_numbers/random_numbers.h>
+#include <cmath>
+
+// A spatial 6R arm, with joint limits narrower than a full turn
+static KDL::Chain makeArm()
+{
+  KDL::Chain chain;
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotZ), KDL::Frame(KDL::Vector(0.0, 0.0, 0.3))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotY), KDL::Frame(KDL::Vector(0.0, 0.0, 0.4))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotY), KDL::Frame(KDL::Vector(0.0, 0.0, 0.4))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotZ), KDL::Frame(KDL::Vector(0.0, 0.0, 0.1))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotY), KDL::Frame(KDL::Vector(0.0, 0.0, 0.1))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotZ), KDL::Frame(KDL::Vector(0.0, 0.0, 0.1))));
+  return chain;
+}
+
+static void setLimits(unsigned int n, double limit, KDL::JntArray &q_min, KDL::JntArray &q_max)
+{
+  q_min.resize(n);
+  q_max.resize(n);
+  for (unsigned int i = 0 ; i < n ; ++i)
+  {
+    q_min(i) = -limit;
+    q_max(i) = limit;
+  }
+}
+
+// A joint value within the limits of the test chains, away from the singular configurations at 0
+static double sampleJointValue(random_numbers::RandomNumberGenerator &rng)
+{
+  double value = rng.uniformReal(0.3, 1.5);
+  return rng.uniform01() < 0.5 ? -value : value;
+}
+
+static bool withinLimits(const KDL::JntArray &q, const KDL::JntArray &q_min, const KDL::JntArray &q_max)
+{
+  for (unsigned int i = 0 ; i < q.rows() ; ++i)
+    if (q(i) < q_min(i) || q(i) > q_max(i))
+      return false;
+  return true;
+}
+
+TEST(ChainIkSolverPosLMAJLMimic, ReachesPosesFromNearbySeeds)
+{
+  KDL::Chain chain = makeArm();
+  KDL::JntArray q_min, q_max;
+  setLimits(chain.getNrOfJoints(), 2.0, q_min, q_max);
+  KDL::ChainIkSolverPos_LMA_JL_Mimic solver(chain, q_min, q_max, 0, 0, 500, 1e-5);
+  KDL::ChainFkSolverPos_recursive fk(chain);
+
+  random_numbers::RandomNumberGenerator rng(42);
+  KDL::JntArray q_goal(chain.getNrOfJoints()), q_seed(chain.getNrOfJoints()), q_out(chain.getNrOfJoints());
+  for (int t = 0 ; t < 50 ; ++t)
+  {
+    for (unsigned int i = 0 ; i < chain.getNrOfJoints() ; ++i)
+    {
+      q_goal(i) = sampleJointValue(rng);
+      q_seed(i) = q_goal(i) + rng.uniformReal(-0.2, 0.2);
+    }
+    KDL::Frame goal, reached;
+    fk.JntToCart(q_goal, goal);
+
+    ASSERT_EQ(0, solver.CartToJnt(q_seed, goal, q_out));
+    EXPECT_GT(solver.getLastIterationCount(), 0u);
+    EXPECT_TRUE(withinLimits(q_out, q_min, q_max));
+    fk.JntToCart(q_out, reached);
+    EXPECT_TRUE(KDL::Equal(reached, goal, 1e-4));
+  }
+}
+
+TEST(ChainIkSolverPosLMAJLMimic, StaysWithinJointLimits)
+{
+  // a single joint that cannot turn far enough to reach the goal
+  KDL::Chain chain;
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotZ), KDL::Frame(KDL::Vector(0.5, 0.0, 0.0))));
+  KDL::JntArray q_min, q_max;
+  setLimits(1, 0.5, q_min, q_max);
+  KDL::ChainIkSolverPos_LMA_JL_Mimic solver(chain, q_min, q_max, 0, 0, 500, 1e-5);
+
+  KDL::JntArray q_seed(1), q_out(1);
+  q_seed(0) = 0.0;
+  KDL::Frame goal(KDL::Rotation::RotZ(1.0), KDL::Vector(0.5 * cos(1.0), 0.5 * sin(1.0), 0.0));
+  EXPECT_EQ(-3, solver.CartToJnt(q_seed, goal, q_out));
+  EXPECT_TRUE(withinLimits(q_out, q_min, q_max));
+  EXPECT_NEAR(0.5, q_out(0), 1e-6);
+  EXPECT_LE(solver.getLastIterationCount(), 500u);
+}
+
+TEST(ChainIkSolverPosLMAJLMimic, MovesMimicJointsWithTheirSource)
+{
+  // the last joint follows the one before it with a factor of -1 (a parallel gripper-like linkage); only the position
+  // is solved for, since the arm has three active joints
+  KDL::Chain chain;
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotZ), KDL::Frame(KDL::Vector(0.0, 0.0, 0.3))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotY), KDL::Frame(KDL::Vector(0.0, 0.0, 0.4))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotY), KDL::Frame(KDL::Vector(0.0, 0.0, 0.4))));
+  chain.addSegment(KDL::Segment(KDL::Joint(KDL::Joint::RotY), KDL::Frame(KDL::Vector(0.0, 0.0, 0.2))));
+
+  std::vector<kdl_kinematics_plugin::JointMimic> mimic_joints(4);
+  for (unsigned int i = 0 ; i < 3 ; ++i)
+  {
+    mimic_joints[i].reset(i);
+    mimic_joints[i].active = true;
+  }
+  mimic_joints[3].reset(2);
+  mimic_joints[3].multiplier = -1.0;
+
+  KDL::JntArray q_min, q_max;
+  setLimits(4, 2.0, q_min, q_max);
+  KDL::ChainIkSolverPos_LMA_JL_Mimic solver(chain, q_min, q_max, 1, 0, 500, 1e-5, true);
+  ASSERT_TRUE(solver.setMimicJoints(mimic_joints));
+  KDL::ChainFkSolverPos_recursive fk(chain);
+
+  random_numbers::RandomNumberGenerator rng(7);
+  KDL::JntArray q_goal(4), q_seed(4), q_out(4);
+  for (int t = 0 ; t < 50 ; ++t)
+  {
+    for (unsigned int i = 0 ; i < 3 ; ++i)
+    {
+      q_goal(i) = sampleJointValue(rng);
+      q_seed(i) = q_goal(i) + rng.uniformReal(-0.1, 0.1);
+    }
+    q_goal(3) = -q_goal(2);
+    q_seed(3) = -q_seed(2);
+    KDL::Frame goal, reached;
+    fk.JntToCart(q_goal, goal);
+
+    ASSERT_EQ(0, solver.CartToJnt(q_seed, goal, q_out));
+    EXPECT_NEAR(-q_out(2), q_out(3), 1e-9);
+    EXPECT_TRUE(withinLimits(q_out, q_min, q_max));
+    fk.JntToCart(q_out, reached);
+    EXPECT_NEAR(0.0, (reached.p - goal.p).Norm(), 1e-4);
+  }
+}
+
+TEST(ChainIkSolverPosLMAJLMimic, RejectsMimicMapsOutsideTheActiveJoints)
+{
+  KDL::Chain chain = makeArm();
+  KDL::JntArray q_min, q_max;
+  setLimits(chain.getNrOfJoints(), 2.0, q_min, q_max);
+  KDL::ChainIkSolverPos_LMA_JL_Mimic solver(chain, q_min, q_max, 1);
+
+  std::vector<kdl_kinematics_plugin::JointMimic> mimic_joints(chain.getNrOfJoints());
+  for (unsigned int i = 0 ; i < mimic_joints.size() ; ++i)
+    mimic_joints[i].reset(i);
+  EXPECT_FALSE(solver.setMimicJoints(mimic_joints));
+  EXPECT_FALSE(solver.setMimicJoints(std::vector<kdl_kinematics_plugin::JointMimic>(2)));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -45,6 +45,14 @@
 namespace kinematics_plugin_loader
 {
 
+/** \brief Get the model of the robot the calling thread is initializing a kinematics solver for. A KinematicsPluginLoader
+    sets this for the duration of KinematicsBase::initialize() when it allocates a solver for a group of a model passed
+    to KinematicsPluginLoader::registerRobotModel(), so the solver does not need to parse the URDF and SRDF and construct
+    a model of its own. Otherwise an empty pointer is returned.
+
+    The groups of the model own their solvers, so a solver must only keep a weak reference to the returned model. */
+robot_model::RobotModelConstPtr getRobotModelForInitialization();
+
 /** \brief Helper class for loading kinematics solvers */
 class KinematicsPluginLoader
 {
@@ -86,6 +94,23 @@ public:
   /** \brief Get a function pointer that allocates and initializes a kinematics solver. If not previously called, this function reads ROS parameters for the groups defined in the SRDF. */
   robot_model::SolverAllocatorFn getLoaderFunction(const boost::shared_ptr<srdf::Model> &srdf_model);
 
+  /** \brief Initialize the solvers allocated for the groups of \e model with \e model itself (see
+      getRobotModelForInitialization()). A loader can serve several models; only weak references to them are kept.
+      getLoaderFunction() must have been called before. */
+  void registerRobotModel(const robot_model::RobotModelConstPtr &model);
+
+  /** \brief Fill the solver pools of the \e groups, initializing all their solvers concurrently. getLoaderFunction()
+      must have been called before. A solver is checked out of each pool into \e solvers, in the order of \e groups;
+      an entry is empty if no solver could be allocated for that group. Releasing a solver returns it to its pool.
+
+      Each group of a model passed to registerRobotModel() has a pool that is filled with one solver for the group
+      itself (JointModelGroup keeps the first solver it is given) and ~kinematics_solver_pool_size (default 1) more.
+      The function returned by getLoaderFunction() checks solvers out of the pools without locking. When all the
+      solvers of a group are in use, another one is allocated and kept in the pool, up to twice the number of
+      cores; beyond that, solvers that are not kept are allocated. */
+  void allocateSolvers(const std::vector<const robot_model::JointModelGroup*> &groups,
+                       std::vector<kinematics::KinematicsBasePtr> &solvers);
+
   /** \brief Get the groups for which the function pointer returned by getLoaderFunction() can allocate a solver */
   const std::vector<std::string>& getKnownGroups() const
   {
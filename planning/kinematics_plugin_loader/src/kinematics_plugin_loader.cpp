@@ -38,7 +38,13 @@
 #include <moveit/rdf_loader/rdf_loader.h>
 #include <pluginlib/class_loader.h>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
 #include <sstream>
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <ros/ros.h>
@@ -47,8 +53,93 @@
 namespace kinematics_plugin_loader
 {
 
+namespace
+{
+// the model a solver is being initialized for, per thread, since solvers are initialized concurrently
+boost::thread_specific_ptr<robot_model::RobotModelConstPtr> INITIALIZING_MODEL;
+
+/** \brief Make \e model available through getRobotModelForInitialization() for as long as this object exists */
+struct ScopedInitializingModel
+{
+  ScopedInitializingModel(const robot_model::RobotModelConstPtr &model)
+  {
+    if (model)
+      INITIALIZING_MODEL.reset(new robot_model::RobotModelConstPtr(model));
+  }
+
+  ~ScopedInitializingModel()
+  {
+    INITIALIZING_MODEL.reset();
+  }
+};
+}
+
+robot_model::RobotModelConstPtr getRobotModelForInitialization()
+{
+  const robot_model::RobotModelConstPtr *model = INITIALIZING_MODEL.get();
+  return model ? *model : robot_model::RobotModelConstPtr();
+}
+
 class KinematicsPluginLoader::KinematicsLoaderImpl
 {
+  /** \brief States of the slots of a pool */
+  enum SlotState
+  {
+    SLOT_EMPTY,    // no solver was allocated for the slot yet
+    SLOT_CREATING, // a solver is being allocated for the slot
+    SLOT_IDLE,     // the solver of the slot is available
+    SLOT_IN_USE    // the solver of the slot is checked out
+  };
+
+  /** \brief A bounded set of solvers for a group, and the state of each of them. The first slots are filled when the
+      pool is created; the others are filled when all the existing solvers are in use, and their solvers are kept as well */
+  struct SolverPool
+  {
+    SolverPool(const robot_model::RobotModelConstPtr &model, std::size_t capacity) :
+      model_(model),
+      solvers_(capacity),
+      state_(new boost::atomic<int>[capacity]),
+      usable_(false)
+    {
+      for (std::size_t i = 0 ; i < capacity ; ++i)
+        state_[i] = SLOT_EMPTY;
+    }
+
+    /** \brief The model whose group the solvers are for; once it is destroyed, the pool is no longer used (another
+        model may be constructed at the same address) */
+    boost::weak_ptr<const robot_model::RobotModel> model_;
+
+    /** \brief The solver of each slot; only written by the thread that moved the slot to SLOT_CREATING */
+    std::vector<boost::shared_ptr<kinematics::KinematicsBase> > solvers_;
+    boost::scoped_array<boost::atomic<int> > state_;
+
+    /** \brief True if at least one solver could be allocated when the pool was created */
+    bool usable_;
+  };
+  typedef boost::shared_ptr<SolverPool> SolverPoolPtr;
+
+  /** \brief Pools are kept per group name of each model */
+  typedef std::pair<const robot_model::RobotModel*, std::string> PoolKey;
+  typedef std::map<PoolKey, SolverPoolPtr> SolverPoolMap;
+
+  /** \brief Deleter of checked out solvers: marks the solver as available again */
+  struct ReturnToPool
+  {
+    ReturnToPool(const SolverPoolPtr &pool, std::size_t index) :
+      pool_(pool),
+      index_(index)
+    {
+    }
+
+    void operator()(kinematics::KinematicsBase*)
+    {
+      pool_->state_[index_].store(SLOT_IDLE, boost::memory_order_release);
+    }
+
+    SolverPoolPtr pool_;
+    std::size_t index_;
+  };
+
 public:
   /**
    * \brief Pimpl Implementation of KinematicsLoader
@@ -56,15 +147,20 @@ public:
    * \param possible_kinematics_solvers
    * \param search_res
    * \param iksolver_to_tip_links - a map between each ik solver and a vector of custom-specified tip link(s)
+   * \param pool_size - the number of solvers kept ready for each group, in addition to the one the group keeps itself
    */
   KinematicsLoaderImpl(const std::string &robot_description,
                        const std::map<std::string, std::vector<std::string> > &possible_kinematics_solvers,
                        const std::map<std::string, std::vector<double> > &search_res,
-                       const std::map<std::string, std::vector<std::string> > &iksolver_to_tip_links) :
+                       const std::map<std::string, std::vector<std::string> > &iksolver_to_tip_links,
+                       unsigned int pool_size) :
     robot_description_(robot_description),
     possible_kinematics_solvers_(possible_kinematics_solvers),
     search_res_(search_res),
-    iksolver_to_tip_links_(iksolver_to_tip_links)
+    iksolver_to_tip_links_(iksolver_to_tip_links),
+    prefill_size_(1 + pool_size),
+    capacity_(1 + std::max<std::size_t>(pool_size, 2 * std::max(1u, boost::thread::hardware_concurrency()))),
+    pools_(new SolverPoolMap())
   {
     try
     {
@@ -129,20 +225,23 @@ public:
     }
 
     ROS_DEBUG("Received request to allocate kinematics solver for group '%s'", jmg->getName().c_str());
+    moveit::tools::Profiler::ScopedBlock prof_block("KinematicsPluginLoader::allocKinematicsSolver");
 
     if (kinematics_loader_ && jmg)
     {
       std::map<std::string, std::vector<std::string> >::const_iterator it = possible_kinematics_solvers_.find(jmg->getName());
       if (it != possible_kinematics_solvers_.end())
       {
-        // just to be sure, do not call the same pluginlib instance allocation function in parallel
-        boost::mutex::scoped_lock slock(lock_);
-
         for (std::size_t i = 0 ; !result && i < it->second.size() ; ++i)
         {
           try
           {
-            result.reset(kinematics_loader_->createUnmanagedInstance(it->second[i]));
+            {
+              // just to be sure, do not call the same pluginlib instance allocation function in parallel;
+              // the solvers themselves are initialized concurrently
+              boost::mutex::scoped_lock slock(lock_);
+              result.reset(kinematics_loader_->createUnmanagedInstance(it->second[i]));
+            }
             if (result)
             {
               const std::vector<const robot_model::LinkModel*> &links = jmg->getLinkModels();
@@ -157,6 +256,8 @@ public:
                 // choose search resolution
                 double search_res = search_res_.find(jmg->getName())->second[i]; // we know this exists, by construction
 
+                moveit::tools::Profiler::ScopedBlock prof_block_init("KinematicsPluginLoader::allocKinematicsSolver initialize");
+                ScopedInitializingModel initializing_model(findRobotModel(jmg));
                 if (!result->initialize(robot_description_, jmg->getName(),
                                         (base.empty() || base[0] != '/') ? base : base.substr(1) , tips, search_res))
                 {
@@ -192,26 +293,110 @@ public:
     return result;
   }
 
+  /** \brief Get a solver from the pool of the group, creating the pool if needed. If all the solvers in the pool are
+      in use, a solver is allocated and kept in the pool, as long as the pool is not full. If the pool is full, or the
+      model of the group was not registered (so there is no pool), a solver that is not kept is allocated */
   boost::shared_ptr<kinematics::KinematicsBase> allocKinematicsSolverWithCache(const robot_model::JointModelGroup *jmg)
   {
+    SolverPoolPtr pool = findPool(jmg);
+    if (!pool)
+      pool = createPools(std::vector<const robot_model::JointModelGroup*>(1, jmg))[0];
+    if (!pool)
+      return allocKinematicsSolver(jmg);
+    if (!pool->usable_)
+      return boost::shared_ptr<kinematics::KinematicsBase>();
+
+    boost::shared_ptr<kinematics::KinematicsBase> res = checkout(pool);
+    if (!res)
+      res = checkoutNew(pool, jmg);
+    if (!res)
+    {
+      ROS_WARN_THROTTLE(5, "All %u kinematics solvers kept for group '%s' are in use; allocating one that is not kept",
+                        (unsigned int)pool->solvers_.size(), jmg->getName().c_str());
+      res = allocKinematicsSolver(jmg);
+    }
+    return res;
+  }
+
+  /** \brief Create (and fill, concurrently) the pools of the groups that do not have one yet. The pools are returned in
+      the order of \e groups; the entry of a group is empty if its model was not registered */
+  std::vector<SolverPoolPtr> createPools(const std::vector<const robot_model::JointModelGroup*> &groups)
+  {
+    // only one thread creates pools at a time; the lookup of existing pools does not wait for this
+    boost::mutex::scoped_lock slock(pools_lock_);
+    std::vector<SolverPoolPtr> pools(groups.size());
+    std::vector<const robot_model::JointModelGroup*> fill_groups;
+    std::vector<SolverPoolPtr> fill_pools;
+    for (std::size_t i = 0 ; i < groups.size() ; ++i)
     {
-      boost::mutex::scoped_lock slock(lock_);
-      const std::vector<boost::shared_ptr<kinematics::KinematicsBase> > &vi = instances_[jmg];
-      for (std::size_t i = 0 ;  i < vi.size() ; ++i)
-        if (vi[i].unique())
+      pools[i] = findPool(groups[i]);
+      if (!pools[i])
+      {
+        std::vector<const robot_model::JointModelGroup*>::const_iterator it = std::find(fill_groups.begin(), fill_groups.end(), groups[i]);
+        if (it != fill_groups.end())
         {
-          ROS_DEBUG("Reusing cached kinematics solver for group '%s'", jmg->getName().c_str());
-          return vi[i]; // this is safe since the shared_ptr is copied on stack BEFORE the destructors in scope get called
+          pools[i] = fill_pools[it - fill_groups.begin()];
+          continue;
         }
+        robot_model::RobotModelConstPtr model = findRobotModel(groups[i]);
+        if (!model)
+        {
+          ROS_DEBUG("The model of group '%s' was not registered; its solvers are not kept", groups[i]->getName().c_str());
+          continue;
+        }
+        pools[i].reset(new SolverPool(model, capacity_));
+        fill_groups.push_back(groups[i]);
+        fill_pools.push_back(pools[i]);
+      }
+    }
+    if (fill_pools.empty())
+      return pools;
+
+    // allocate the initial solvers of all the new pools at once, since initialization of solvers is independent
+    std::size_t work = fill_pools.size() * prefill_size_;
+    std::size_t thread_count = std::min<std::size_t>(work, std::max(1u, boost::thread::hardware_concurrency()));
+    boost::atomic<std::size_t> next(0);
+    if (thread_count <= 1)
+      fillPoolsThread(&fill_groups, &fill_pools, &next);
+    else
+    {
+      boost::thread_group threads;
+      for (std::size_t i = 0 ; i < thread_count ; ++i)
+        threads.create_thread(boost::bind(&KinematicsLoaderImpl::fillPoolsThread, this, &fill_groups, &fill_pools, &next));
+      threads.join_all();
     }
 
-    boost::shared_ptr<kinematics::KinematicsBase> res = allocKinematicsSolver(jmg);
-
+    // publish a new version of the map of pools, without the pools of models that no longer exist; readers that still
+    // hold the previous version release it when they are done with it
+    boost::shared_ptr<SolverPoolMap> updated(new SolverPoolMap());
+    boost::shared_ptr<const SolverPoolMap> current = boost::atomic_load(&pools_);
+    for (SolverPoolMap::const_iterator it = current->begin() ; it != current->end() ; ++it)
+      if (!it->second->model_.expired())
+        updated->insert(*it);
+    for (std::size_t i = 0 ; i < fill_pools.size() ; ++i)
     {
-      boost::mutex::scoped_lock slock(lock_);
-      instances_[jmg].push_back(res);
-      return res;
+      for (std::size_t j = 0 ; j < prefill_size_ ; ++j)
+        if (fill_pools[i]->solvers_[j])
+        {
+          fill_pools[i]->usable_ = true;
+          fill_pools[i]->state_[j].store(SLOT_IDLE, boost::memory_order_relaxed);
+        }
+      (*updated)[poolKey(fill_groups[i])] = fill_pools[i];
     }
+    boost::atomic_store(&pools_, boost::shared_ptr<const SolverPoolMap>(updated));
+    return pools;
+  }
+
+  void registerRobotModel(const robot_model::RobotModelConstPtr &model)
+  {
+    boost::mutex::scoped_lock slock(models_lock_);
+    // forget models that no longer exist; a new model may have been constructed at the same address
+    for (std::map<const robot_model::RobotModel*, boost::weak_ptr<const robot_model::RobotModel> >::iterator it = models_.begin() ; it != models_.end() ; )
+      if (it->second.expired())
+        models_.erase(it++);
+      else
+        ++it;
+    models_[model.get()] = model;
   }
 
   void status() const
@@ -219,18 +404,87 @@ public:
     for (std::map<std::string, std::vector<std::string> >::const_iterator it = possible_kinematics_solvers_.begin() ; it != possible_kinematics_solvers_.end() ; ++it)
       for (std::size_t i = 0 ; i < it->second.size() ; ++i)
         ROS_INFO("Solver for group '%s': '%s' (search resolution = %lf)", it->first.c_str(), it->second[i].c_str(), search_res_.at(it->first)[i]);
+    ROS_INFO("Kinematics solvers kept for each group: %u initially, at most %u", (unsigned int)prefill_size_, (unsigned int)capacity_);
   }
 
 private:
 
+  /** \brief Get the registered model \e jmg is a group of, or an empty pointer if that model was not registered */
+  robot_model::RobotModelConstPtr findRobotModel(const robot_model::JointModelGroup *jmg) const
+  {
+    boost::mutex::scoped_lock slock(models_lock_);
+    std::map<const robot_model::RobotModel*, boost::weak_ptr<const robot_model::RobotModel> >::const_iterator it = models_.find(&jmg->getParentModel());
+    return it == models_.end() ? robot_model::RobotModelConstPtr() : it->second.lock();
+  }
+
+  static PoolKey poolKey(const robot_model::JointModelGroup *jmg)
+  {
+    return PoolKey(&jmg->getParentModel(), jmg->getName());
+  }
+
+  /** \brief Get the pool of \e jmg, or an empty pointer if there is none (or it was created for a model that no longer
+      exists) */
+  SolverPoolPtr findPool(const robot_model::JointModelGroup *jmg) const
+  {
+    boost::shared_ptr<const SolverPoolMap> pools = boost::atomic_load(&pools_);
+    SolverPoolMap::const_iterator it = pools->find(poolKey(jmg));
+    return it == pools->end() || it->second->model_.expired() ? SolverPoolPtr() : it->second;
+  }
+
+  /** \brief Check out an idle solver of \e pool, if there is one */
+  static boost::shared_ptr<kinematics::KinematicsBase> checkout(const SolverPoolPtr &pool)
+  {
+    for (std::size_t i = 0 ; i < pool->solvers_.size() ; ++i)
+    {
+      int expected = SLOT_IDLE;
+      if (pool->state_[i].compare_exchange_strong(expected, SLOT_IN_USE, boost::memory_order_acquire))
+        return boost::shared_ptr<kinematics::KinematicsBase>(pool->solvers_[i].get(), ReturnToPool(pool, i));
+    }
+    return boost::shared_ptr<kinematics::KinematicsBase>();
+  }
+
+  /** \brief Allocate a solver for an empty slot of \e pool and check it out, if the pool is not full */
+  boost::shared_ptr<kinematics::KinematicsBase> checkoutNew(const SolverPoolPtr &pool, const robot_model::JointModelGroup *jmg)
+  {
+    for (std::size_t i = 0 ; i < pool->solvers_.size() ; ++i)
+    {
+      int expected = SLOT_EMPTY;
+      if (!pool->state_[i].compare_exchange_strong(expected, SLOT_CREATING, boost::memory_order_acquire))
+        continue;
+      pool->solvers_[i] = allocKinematicsSolver(jmg);
+      if (!pool->solvers_[i])
+      {
+        pool->state_[i].store(SLOT_EMPTY, boost::memory_order_release);
+        return boost::shared_ptr<kinematics::KinematicsBase>();
+      }
+      pool->state_[i].store(SLOT_IN_USE, boost::memory_order_release);
+      return boost::shared_ptr<kinematics::KinematicsBase>(pool->solvers_[i].get(), ReturnToPool(pool, i));
+    }
+    return boost::shared_ptr<kinematics::KinematicsBase>();
+  }
+
+  void fillPoolsThread(const std::vector<const robot_model::JointModelGroup*> *groups,
+                       const std::vector<SolverPoolPtr> *pools,
+                       boost::atomic<std::size_t> *next)
+  {
+    for (std::size_t i = (*next)++ ; i < groups->size() * prefill_size_ ; i = (*next)++)
+      (*pools)[i / prefill_size_]->solvers_[i % prefill_size_] = allocKinematicsSolver((*groups)[i / prefill_size_]);
+  }
+
   std::string                                                            robot_description_;
   std::map<std::string, std::vector<std::string> >                       possible_kinematics_solvers_;
   std::map<std::string, std::vector<double> >                            search_res_;
   std::map<std::string, std::vector<std::string> >                       iksolver_to_tip_links_;  // a map between each ik solver and a vector of custom-specified tip link(s)
   boost::shared_ptr<pluginlib::ClassLoader<kinematics::KinematicsBase> > kinematics_loader_;
-  std::map<const robot_model::JointModelGroup*,
-           std::vector<boost::shared_ptr<kinematics::KinematicsBase> > > instances_;
   boost::mutex                                                           lock_;
+
+  std::size_t                                                            prefill_size_; // the solvers allocated when a pool is created
+  std::size_t                                                            capacity_;     // the most solvers a pool keeps
+  boost::shared_ptr<const SolverPoolMap>                                 pools_;        // the current version of the map of pools; only accessed atomically
+  boost::mutex                                                           pools_lock_;   // held while pools are created
+
+  std::map<const robot_model::RobotModel*, boost::weak_ptr<const robot_model::RobotModel> > models_; // the registered models
+  mutable boost::mutex                                                   models_lock_;
 };
 
 }
@@ -243,6 +497,35 @@ void kinematics_plugin_loader::KinematicsPluginLoader::status() const
     ROS_INFO("Loader function was never required");
 }
 
+void kinematics_plugin_loader::KinematicsPluginLoader::registerRobotModel(const robot_model::RobotModelConstPtr &model)
+{
+  if (!loader_)
+  {
+    ROS_ERROR("The kinematics solvers have not been configured; cannot register the robot model");
+    return;
+  }
+  loader_->registerRobotModel(model);
+}
+
+void kinematics_plugin_loader::KinematicsPluginLoader::allocateSolvers(const std::vector<const robot_model::JointModelGroup*> &groups,
+                                                                       std::vector<kinematics::KinematicsBasePtr> &solvers)
+{
+  moveit::tools::Profiler::ScopedStart prof_start;
+  moveit::tools::Profiler::ScopedBlock prof_block("KinematicsPluginLoader::allocateSolvers");
+
+  solvers.clear();
+  solvers.resize(groups.size());
+  if (!loader_)
+  {
+    ROS_ERROR("The kinematics solvers have not been configured; cannot allocate solvers");
+    return;
+  }
+
+  loader_->createPools(groups);
+  for (std::size_t i = 0 ; i < groups.size() ; ++i)
+    solvers[i] = loader_->allocKinematicsSolverWithCache(groups[i]);
+}
+
 robot_model::SolverAllocatorFn kinematics_plugin_loader::KinematicsPluginLoader::getLoaderFunction()
 {
   moveit::tools::Profiler::ScopedStart prof_start;
@@ -422,7 +705,17 @@ robot_model::SolverAllocatorFn kinematics_plugin_loader::KinematicsPluginLoader:
       }
     }
 
-    loader_.reset(new KinematicsLoaderImpl(robot_description_, possible_kinematics_solvers, search_res, iksolver_to_tip_links));
+    // the number of solvers kept ready for each group, besides the one the group keeps for itself
+    ros::NodeHandle private_handle("~");
+    int pool_size;
+    private_handle.param("kinematics_solver_pool_size", pool_size, 1);
+    if (pool_size < 0)
+    {
+      ROS_WARN("Kinematics solver pool size must not be negative; using 0");
+      pool_size = 0;
+    }
+
+    loader_.reset(new KinematicsLoaderImpl(robot_description_, possible_kinematics_solvers, search_res, iksolver_to_tip_links, pool_size));
   }
 
   return boost::bind(&KinematicsPluginLoader::KinematicsLoaderImpl::allocKinematicsSolverWithCache, loader_.get(), _1);
@@ -0,0 +1,307 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model_loader/robot_model_loader.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/kdl_kinematics_plugin/chainiksolver_pos_nr_jl_mimic.hpp>
+#include <moveit/kdl_kinematics_plugin/chainiksolver_pos_lma_jl_mimic.hpp>
+#include <moveit/kdl_kinematics_plugin/chainiksolver_vel_pinv_mimic.hpp>
+#include <kdl/chainfksolverpos_recursive.hpp>
+#include <kdl_parser/kdl_parser.hpp>
+#include <pluginlib/class_loader.h>
+#include <random_numbers/random_numbers.h>
+#include <tf_conversions/tf_eigen.h>
+#include <tf_conversions/tf_kdl.h>
+#include <boost/lexical_cast.hpp>
+#include <ros/ros.h>
+
+static const std::string ROBOT_DESCRIPTION = "robot_description";
+static const std::string KDL_PLUGIN = "kdl_kinematics_plugin/KDLKinematicsPlugin";
+
+// Load a KDL solver for the group, configured to use the specified position solver
+static kinematics::KinematicsBasePtr loadSolver(pluginlib::ClassLoader<kinematics::KinematicsBase> &loader,
+                                                const std::string &group, const std::string &base, const std::string &tip,
+                                                double search_discretization, const std::string &solver_type)
+{
+  // the plugin reads its parameters from the private namespace of the node at initialization
+  ros::NodeHandle private_handle("~");
+  private_handle.setParam(group + "/solver_type", solver_type);
+
+  kinematics::KinematicsBasePtr solver;
+  try
+  {
+    solver = loader.createInstance(KDL_PLUGIN);
+  }
+  catch(pluginlib::PluginlibException& ex)
+  {
+    ROS_ERROR("Unable to load %s: %s", KDL_PLUGIN.c_str(), ex.what());
+    return solver;
+  }
+  if (!solver->initialize(ROBOT_DESCRIPTION, group, base, tip, search_discretization))
+  {
+    ROS_ERROR("Unable to initialize the %s solver for group '%s'", solver_type.c_str(), group.c_str());
+    solver.reset();
+  }
+  return solver;
+}
+
+// Solve the same requests with a solver and report the success rate, the time per call and the error of the solutions
+static void evaluateSolver(const std::string &solver_type, const kinematics::KinematicsBasePtr &solver,
+                           const robot_model::JointModelGroup *jmg, robot_state::RobotState &state,
+                           const std::vector<geometry_msgs::Pose> &poses, const std::vector<std::vector<double> > &seeds,
+                           double timeout)
+{
+  const std::string &tip = solver->getTipFrame();
+  const std::string &base = solver->getBaseFrame();
+  bool has_base = state.getRobotModel()->hasLinkModel(base);
+
+  std::vector<double> solution;
+  moveit_msgs::MoveItErrorCodes error_code;
+  unsigned int solved = 0;
+  double solved_time = 0.0;
+  double failed_time = 0.0;
+  double trans_err = 0.0;
+  double rot_err = 0.0;
+  for (std::size_t i = 0 ; i < poses.size() ; ++i)
+  {
+    ros::WallTime start = ros::WallTime::now();
+    bool ok = solver->searchPositionIK(poses[i], seeds[i], timeout, solution, error_code);
+    double duration = (ros::WallTime::now() - start).toSec();
+    if (!ok)
+    {
+      failed_time += duration;
+      continue;
+    }
+    solved++;
+    solved_time += duration;
+
+    // measure the error of the solution independently of the solver
+    state.setJointGroupPositions(jmg, solution);
+    state.update();
+    Eigen::Affine3d reached = state.getGlobalLinkTransform(tip);
+    if (has_base)
+      reached = state.getGlobalLinkTransform(base).inverse() * reached;
+    Eigen::Affine3d desired;
+    tf::poseMsgToEigen(poses[i], desired);
+    Eigen::Affine3d diff = reached * desired.inverse();
+    trans_err += diff.translation().norm();
+    rot_err += (diff.rotation() - Eigen::Matrix3d::Identity()).norm();
+  }
+
+  unsigned int failed = poses.size() - solved;
+  ROS_INFO("%s: solved %u of %u (%.1lf%%); %.3lf ms per solved call, %.3lf ms per failed call; "
+           "average translation error %g, rotation error %g",
+           solver_type.c_str(), solved, (unsigned int)poses.size(), poses.empty() ? 0.0 : 100.0 * solved / poses.size(),
+           solved > 0 ? 1000.0 * solved_time / solved : 0.0, failed > 0 ? 1000.0 * failed_time / failed : 0.0,
+           solved > 0 ? trans_err / solved : 0.0, solved > 0 ? rot_err / solved : 0.0);
+}
+
+// Solve the requests with a KDL position solver directly, restarting from random configurations like the plugin does,
+// and report the iterations per call to the solver and the restarts per pose. The timeout of the plugin hides these:
+// a solver that needs fewer restarts can still be slower per call
+template<typename Solver>
+static void countIterations(const std::string &solver_type, Solver &solver, const robot_model::JointModelGroup *jmg,
+                            const std::vector<int> &group_index, const std::vector<KDL::Frame> &poses,
+                            const std::vector<std::vector<double> > &seeds, unsigned int max_restarts)
+{
+  // the same random restarts for every solver
+  random_numbers::RandomNumberGenerator rng(42);
+  std::vector<double> values;
+  KDL::JntArray q_in(group_index.size()), q_out(group_index.size());
+
+  unsigned int solved = 0;
+  std::size_t calls = 0;
+  std::size_t iterations = 0;
+  std::size_t restarts = 0;
+  for (std::size_t i = 0 ; i < poses.size() ; ++i)
+  {
+    for (std::size_t j = 0 ; j < group_index.size() ; ++j)
+      q_in(j) = seeds[i][group_index[j]];
+    for (unsigned int attempt = 0 ; attempt <= max_restarts ; ++attempt)
+    {
+      int result = solver.CartToJnt(q_in, poses[i], q_out);
+      calls++;
+      iterations += solver.getLastIterationCount();
+      if (result >= 0)
+      {
+        solved++;
+        restarts += attempt;
+        break;
+      }
+      jmg->getVariableRandomPositions(rng, values);
+      for (std::size_t j = 0 ; j < group_index.size() ; ++j)
+        q_in(j) = values[group_index[j]];
+    }
+  }
+
+  ROS_INFO("%s: solved %u of %u with at most %u restarts; %.1lf iterations per call to the solver, "
+           "%.2lf restarts per solved pose",
+           solver_type.c_str(), solved, (unsigned int)poses.size(), max_restarts,
+           calls > 0 ? (double)iterations / calls : 0.0, solved > 0 ? (double)restarts / solved : 0.0);
+}
+
+// Compare the iterations and restarts of the KDL position solvers on the chain the plugin would use. Groups with mimic
+// joints are skipped, since their mapping to the solvers is set up by the plugin
+static void compareIterations(const robot_model::RobotModelConstPtr &model, const robot_model::JointModelGroup *jmg,
+                              const std::string &base, const std::string &tip, const std::vector<geometry_msgs::Pose> &poses,
+                              const std::vector<std::vector<double> > &seeds, unsigned int max_restarts)
+{
+  if (!jmg->getMimicJointModels().empty())
+  {
+    ROS_INFO("Group '%s' has mimic joints; not counting solver iterations", jmg->getName().c_str());
+    return;
+  }
+  KDL::Tree tree;
+  KDL::Chain chain;
+  if (!kdl_parser::treeFromUrdfModel(*model->getURDF(), tree) || !tree.getChain(base, tip, chain))
+  {
+    ROS_ERROR("Unable to construct the KDL chain from '%s' to '%s'", base.c_str(), tip.c_str());
+    return;
+  }
+
+  // the index in the group of each joint of the chain, and its limits
+  std::vector<int> group_index;
+  KDL::JntArray q_min(chain.getNrOfJoints()), q_max(chain.getNrOfJoints());
+  for (unsigned int i = 0 ; i < chain.getNrOfSegments() ; ++i)
+  {
+    const KDL::Joint &joint = chain.getSegment(i).getJoint();
+    if (joint.getType() == KDL::Joint::None)
+      continue;
+    const robot_model::JointModel *jm = model->getJointModel(joint.getName());
+    int index = jmg->getVariableGroupIndex(joint.getName());
+    if (!jm || index < 0)
+    {
+      ROS_ERROR("Joint '%s' of the KDL chain is not a variable of group '%s'", joint.getName().c_str(), jmg->getName().c_str());
+      return;
+    }
+    q_min(group_index.size()) = jm->getVariableBounds()[0].min_position_;
+    q_max(group_index.size()) = jm->getVariableBounds()[0].max_position_;
+    group_index.push_back(index);
+  }
+
+  std::vector<KDL::Frame> frames(poses.size());
+  for (std::size_t i = 0 ; i < poses.size() ; ++i)
+    tf::poseMsgToKDL(poses[i], frames[i]);
+
+  // the same settings the plugin uses
+  ros::NodeHandle private_handle("~");
+  int max_solver_iterations;
+  double epsilon;
+  private_handle.param("max_solver_iterations", max_solver_iterations, 500);
+  private_handle.param("epsilon", epsilon, 1e-5);
+
+  KDL::ChainFkSolverPos_recursive fk_solver(chain);
+  KDL::ChainIkSolverVel_pinv_mimic ik_solver_vel(chain);
+  KDL::ChainIkSolverPos_NR_JL_Mimic nr(chain, q_min, q_max, fk_solver, ik_solver_vel, max_solver_iterations, epsilon);
+  KDL::ChainIkSolverPos_LMA_JL_Mimic lma(chain, q_min, q_max, 0, 0, max_solver_iterations, epsilon);
+  countIterations("newton_raphson", nr, jmg, group_index, frames, seeds, max_restarts);
+  countIterations("levenberg_marquardt", lma, jmg, group_index, frames, seeds, max_restarts);
+}
+
+int main(int argc, char **argv)
+{
+  ros::init(argc, argv, "compare_kdl_ik_solvers");
+
+  ros::AsyncSpinner spinner(1);
+  spinner.start();
+
+  if (argc <= 1)
+    ROS_ERROR("An argument specifying the group name is needed");
+  else
+  {
+    robot_model_loader::RobotModelLoader rml(ROBOT_DESCRIPTION);
+    std::string group = argv[1];
+    const robot_model::JointModelGroup *jmg = rml.getModel()->getJointModelGroup(group);
+    if (!jmg)
+      ROS_ERROR_STREAM("Group " << group << " not found");
+    else
+    {
+      // use the chain configured for the group, so the comparison matches what the group would use
+      const kinematics::KinematicsBaseConstPtr &group_solver = jmg->getSolverInstance();
+      if (!group_solver)
+        ROS_ERROR_STREAM("No kinematics solver specified for group " << group);
+      else
+      {
+        unsigned int test_count = 1000;
+        if (argc > 2)
+          try
+          {
+            test_count = boost::lexical_cast<unsigned int>(argv[2]);
+          }
+          catch(...)
+          {
+          }
+
+        const std::string &base = group_solver->getBaseFrame();
+        const std::string &tip = group_solver->getTipFrame();
+        double timeout = group_solver->getDefaultTimeout();
+
+        pluginlib::ClassLoader<kinematics::KinematicsBase> loader("moveit_core", "kinematics::KinematicsBase");
+        kinematics::KinematicsBasePtr nr = loadSolver(loader, group, base, tip, group_solver->getSearchDiscretization(), "newton_raphson");
+        kinematics::KinematicsBasePtr lma = loadSolver(loader, group, base, tip, group_solver->getSearchDiscretization(), "levenberg_marquardt");
+        if (nr && lma)
+        {
+          robot_state::RobotState state(rml.getModel());
+          state.setToDefaultValues();
+          bool has_base = state.getRobotModel()->hasLinkModel(base);
+
+          // both solvers get the same reachable poses (in the frame of the solver) and seeds
+          std::vector<geometry_msgs::Pose> poses(test_count);
+          std::vector<std::vector<double> > seeds(test_count);
+          for (unsigned int i = 0 ; i < test_count ; ++i)
+          {
+            state.setToRandomPositions(jmg);
+            Eigen::Affine3d pose = state.getGlobalLinkTransform(tip);
+            if (has_base)
+              pose = state.getGlobalLinkTransform(base).inverse() * pose;
+            tf::poseEigenToMsg(pose, poses[i]);
+            state.setToRandomPositions(jmg);
+            state.copyJointGroupPositions(jmg, seeds[i]);
+          }
+
+          ROS_INFO("Comparing KDL position solvers for group '%s' (%s -> %s) on %u poses with a timeout of %lf s",
+                   group.c_str(), base.c_str(), tip.c_str(), test_count, timeout);
+          evaluateSolver("newton_raphson", nr, jmg, state, poses, seeds, timeout);
+          evaluateSolver("levenberg_marquardt", lma, jmg, state, poses, seeds, timeout);
+
+          static const unsigned int MAX_RESTARTS = 100;
+          compareIterations(rml.getModel(), jmg, base, tip, poses, seeds, MAX_RESTARTS);
+        }
+      }
+    }
+  }
+
+  ros::shutdown();
+  return 0;
+}
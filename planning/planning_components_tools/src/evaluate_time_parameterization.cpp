@@ -0,0 +1,188 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model_loader/robot_model_loader.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/planning_request_adapter/planning_request_adapter.h>
+#include <moveit/trajectory_processing/iterative_time_parameterization.h>
+#include <moveit/profiler/profiler.h>
+#include <pluginlib/class_loader.h>
+#include <boost/scoped_ptr.hpp>
+#include <boost/bind.hpp>
+#include <ros/ros.h>
+
+static const std::string ROBOT_DESCRIPTION = "robot_description";
+static const std::string TIME_OPTIMAL_ADAPTER = "default_planner_request_adapters/AddTimeOptimalParameterization";
+
+// number of random paths evaluated per group
+static const int N = 100;
+
+// number of random states each path passes through, and number of waypoints between consecutive ones
+static const int VIA_STATES = 4;
+static const int WAYPOINTS_PER_LEG = 25;
+
+robot_trajectory::RobotTrajectoryPtr copyTrajectory(const robot_trajectory::RobotTrajectory &trajectory)
+{
+  robot_trajectory::RobotTrajectoryPtr copy(new robot_trajectory::RobotTrajectory(trajectory.getRobotModel(), trajectory.getGroupName()));
+  for (std::size_t i = 0 ; i < trajectory.getWayPointCount() ; ++i)
+    copy->addSuffixWayPoint(trajectory.getWayPoint(i), 0.0);
+  return copy;
+}
+
+double getDuration(const robot_trajectory::RobotTrajectory &trajectory)
+{
+  double d = 0.0;
+  for (std::size_t i = 0 ; i < trajectory.getWayPointCount() ; ++i)
+    d += trajectory.getWayPointDurationFromPrevious(i);
+  return d;
+}
+
+bool returnTrajectory(const robot_trajectory::RobotTrajectoryPtr &trajectory,
+                      const planning_scene::PlanningSceneConstPtr &scene,
+                      const planning_interface::MotionPlanRequest &req,
+                      planning_interface::MotionPlanResponse &res)
+{
+  res.trajectory_ = trajectory;
+  res.error_code_.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+    ros::init(argc, argv, "evaluate_time_parameterization");
+
+    ros::AsyncSpinner spinner(1);
+    spinner.start();
+
+    robot_model_loader::RobotModelLoader rml(ROBOT_DESCRIPTION, false);
+    ros::Duration(0.5).sleep();
+
+    robot_model::RobotModelConstPtr robot_model = rml.getModel();
+    if (robot_model)
+    {
+      boost::scoped_ptr<pluginlib::ClassLoader<planning_request_adapter::PlanningRequestAdapter> > loader;
+      boost::scoped_ptr<planning_request_adapter::PlanningRequestAdapter> time_optimal;
+      try
+      {
+        loader.reset(new pluginlib::ClassLoader<planning_request_adapter::PlanningRequestAdapter>("moveit_core", "planning_request_adapter::PlanningRequestAdapter"));
+        time_optimal.reset(loader->createUnmanagedInstance(TIME_OPTIMAL_ADAPTER));
+      }
+      catch(pluginlib::PluginlibException& ex)
+      {
+        ROS_ERROR_STREAM("Exception while loading planning adapter plugin '" << TIME_OPTIMAL_ADAPTER << "': " << ex.what());
+        ros::shutdown();
+        return 1;
+      }
+
+      planning_scene::PlanningScenePtr scene(new planning_scene::PlanningScene(robot_model));
+      trajectory_processing::IterativeParabolicTimeParameterization iterative_parabolic;
+      robot_state::RobotState state(robot_model);
+      state.setToDefaultValues();
+
+      printf("Evaluating model '%s' using %d random paths for each group\n", robot_model->getName().c_str(), N);
+
+      moveit::tools::Profiler::Clear();
+      moveit::tools::Profiler::Start();
+
+      const std::vector<std::string> &groups = robot_model->getJointModelGroupNames();
+      for (std::size_t j = 0 ; j < groups.size() ; ++j)
+      {
+        const robot_model::JointModelGroup *jmg = robot_model->getJointModelGroup(groups[j]);
+        printf("\n%s: Evaluating time parameterization ...\n", groups[j].c_str());
+
+        planning_interface::MotionPlanRequest req;
+        req.group_name = groups[j];
+        std::string pname_ip = groups[j] + ":Iterative Parabolic";
+        std::string pname_to = groups[j] + ":Time Optimal";
+        double duration_ip = 0.0;
+        double duration_to = 0.0;
+        unsigned int failures_ip = 0;
+        unsigned int failures_to = 0;
+
+        for (int i = 0 ; i < N ; ++i)
+        {
+          // a random path through a few random states
+          robot_trajectory::RobotTrajectory path(robot_model, groups[j]);
+          robot_state::RobotState from(state), to(state), waypoint(state);
+          from.setToRandomPositions(jmg);
+          path.addSuffixWayPoint(from, 0.0);
+          for (int v = 0 ; v < VIA_STATES ; ++v)
+          {
+            to.setToRandomPositions(jmg);
+            for (int k = 1 ; k <= WAYPOINTS_PER_LEG ; ++k)
+            {
+              from.interpolate(to, (double)k / (double)WAYPOINTS_PER_LEG, waypoint);
+              path.addSuffixWayPoint(waypoint, 0.0);
+            }
+            from = to;
+          }
+
+          robot_trajectory::RobotTrajectoryPtr traj_ip = copyTrajectory(path);
+          moveit::tools::Profiler::Begin(pname_ip);
+          bool ok_ip = iterative_parabolic.computeTimeStamps(*traj_ip);
+          moveit::tools::Profiler::End(pname_ip);
+          if (ok_ip)
+            duration_ip += getDuration(*traj_ip);
+          else
+            failures_ip++;
+
+          robot_trajectory::RobotTrajectoryPtr traj_to = copyTrajectory(path);
+          planning_interface::MotionPlanResponse res;
+          std::vector<std::size_t> added_path_index;
+          moveit::tools::Profiler::Begin(pname_to);
+          bool ok_to = time_optimal->adaptAndPlan(boost::bind(&returnTrajectory, traj_to, _1, _2, _3), scene, req, res, added_path_index);
+          moveit::tools::Profiler::End(pname_to);
+          // the adapter reports the planning result; a failed parameterization leaves the durations at zero
+          double d = ok_to && res.trajectory_ ? getDuration(*res.trajectory_) : 0.0;
+          if (d > 0.0)
+            duration_to += d;
+          else
+            failures_to++;
+        }
+
+        if (failures_ip < (unsigned int)N)
+          printf("%s: Iterative Parabolic: average trajectory duration %lf s (%u failures)\n", groups[j].c_str(), duration_ip / (N - failures_ip), failures_ip);
+        if (failures_to < (unsigned int)N)
+          printf("%s: Time Optimal: average trajectory duration %lf s (%u failures)\n", groups[j].c_str(), duration_to / (N - failures_to), failures_to);
+      }
+
+      moveit::tools::Profiler::Stop();
+      moveit::tools::Profiler::Status();
+    }
+    else
+      ROS_ERROR("Unable to initialize robot model.");
+
+    ros::shutdown();
+    return 0;
+}
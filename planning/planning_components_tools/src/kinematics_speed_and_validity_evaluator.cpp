@@ -37,10 +37,80 @@
 #include <moveit/robot_model_loader/robot_model_loader.h>
 #include <moveit/robot_state/robot_state.h>
 #include <moveit/profiler/profiler.h>
+#include <tf_conversions/tf_eigen.h>
+#include <boost/atomic.hpp>
 #include <ros/ros.h>
+#include <cstdlib>
+#include <new>
 
 static const std::string ROBOT_DESCRIPTION = "robot_description";
 
+#ifdef MOVEIT_COUNT_ALLOCATIONS
+
+// Count the heap allocations made by this process, so the allocations made per IK call can be reported. This replaces
+// the global allocator, so it is only built into the separate moveit_kinematics_allocation_benchmark executable
+static boost::atomic<std::size_t> ALLOCATION_COUNT(0);
+
+void* operator new(std::size_t size) throw(std::bad_alloc)
+{
+  ALLOCATION_COUNT.fetch_add(1, boost::memory_order_relaxed);
+  void *p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) throw()
+{
+  free(p);
+}
+
+#endif
+
+// Call the solver directly, without going through RobotState, and report calls per second (and allocations per call,
+// if they are counted)
+static void benchmarkSolver(const kinematics::KinematicsBaseConstPtr &solver, const robot_model::JointModelGroup *jmg,
+                            robot_state::RobotState &state, unsigned int test_count)
+{
+  const std::string &tip = solver->getTipFrame();
+  const std::string &base = solver->getBaseFrame();
+  bool has_base = state.getRobotModel()->hasLinkModel(base);
+
+  // generate reachable poses (in the frame of the solver) and seeds up front, so only IK is measured
+  std::vector<geometry_msgs::Pose> poses(test_count);
+  std::vector<std::vector<double> > seeds(test_count);
+  for (unsigned int i = 0 ; i < test_count ; ++i)
+  {
+    state.setToRandomPositions(jmg);
+    Eigen::Affine3d pose = state.getGlobalLinkTransform(tip);
+    if (has_base)
+      pose = state.getGlobalLinkTransform(base).inverse() * pose;
+    tf::poseEigenToMsg(pose, poses[i]);
+    state.setToRandomPositions(jmg);
+    state.copyJointGroupPositions(jmg, seeds[i]);
+  }
+
+  std::vector<double> solution;
+  solution.reserve(jmg->getVariableCount());
+  moveit_msgs::MoveItErrorCodes error_code;
+  unsigned int solved = 0;
+#ifdef MOVEIT_COUNT_ALLOCATIONS
+  std::size_t allocations = ALLOCATION_COUNT.load();
+#endif
+  ros::WallTime start = ros::WallTime::now();
+  for (unsigned int i = 0 ; i < test_count ; ++i)
+    if (solver->searchPositionIK(poses[i], seeds[i], solver->getDefaultTimeout(), solution, error_code))
+      solved++;
+  double duration = (ros::WallTime::now() - start).toSec();
+
+  ROS_INFO("searchPositionIK: %u calls in %lf seconds (%lf calls/sec), %u solved",
+           test_count, duration, duration > 0.0 ? test_count / duration : 0.0, solved);
+#ifdef MOVEIT_COUNT_ALLOCATIONS
+  allocations = ALLOCATION_COUNT.load() - allocations;
+  ROS_INFO("searchPositionIK: %lf allocations/call", test_count > 0 ? (double)allocations / (double)test_count : 0.0);
+#endif
+}
+
 int main(int argc, char **argv)
 {
   ros::init(argc, argv, "inverse_kinematics_test");
@@ -111,6 +181,8 @@ int main(int argc, char **argv)
         }
         moveit::tools::Profiler::Stop();
         moveit::tools::Profiler::Status();
+
+        benchmarkSolver(solver, jmg, state, test_count);
       }
       else
         ROS_ERROR_STREAM("No kinematics solver specified for group " << group);
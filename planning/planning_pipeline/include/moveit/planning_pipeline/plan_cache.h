@@ -0,0 +1,172 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_PLANNING_PIPELINE_PLAN_CACHE_
+#define MOVEIT_PLANNING_PIPELINE_PLAN_CACHE_
+
+#include <moveit/planning_interface/planning_interface.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/macros/class_forward.h>
+#include <moveit_msgs/RobotTrajectory.h>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <list>
+
+namespace planning_pipeline
+{
+
+/** \brief A cache of computed motion plans. Plans are identified by the planning group, the planner id, the start state
+    (with joint positions quantized to a specified resolution) and the goal, path and trajectory constraints of the request.
+    A plan found in the cache is only returned after it is checked to still be valid in the planning scene the request is for.
+    The cache can optionally be backed by a persistent storage. */
+class PlanCache
+{
+public:
+
+  /** \brief Interface for persistent storage of the plans in the cache */
+  class Storage
+  {
+  public:
+
+    virtual ~Storage()
+    {
+    }
+
+    /** \brief Load the trajectory stored under \e key. Return false if there is no such trajectory. */
+    virtual bool loadPlan(const std::string &key, moveit_msgs::RobotTrajectory &trajectory) = 0;
+
+    /** \brief Store \e trajectory under \e key, replacing any previous trajectory with the same key */
+    virtual void storePlan(const std::string &key, const moveit_msgs::RobotTrajectory &trajectory) = 0;
+
+    /** \brief Remove the trajectory stored under \e key, if any */
+    virtual void removePlan(const std::string &key) = 0;
+  };
+  typedef boost::shared_ptr<Storage> StoragePtr;
+
+  /** \brief Construct a cache that holds at most \e max_size plans in memory; joint positions of start states are quantized to \e state_resolution */
+  PlanCache(const robot_model::RobotModelConstPtr &model, std::size_t max_size = 100, double state_resolution = 1e-3);
+
+  /** \brief Look for a plan for \e req. If one is found and it is still valid in \e planning_scene, it is copied into \e res and true is returned. */
+  bool lookup(const planning_scene::PlanningSceneConstPtr &planning_scene,
+              const planning_interface::MotionPlanRequest &req, planning_interface::MotionPlanResponse &res);
+
+  /** \brief Store the trajectory in \e res as the plan for \e req */
+  void insert(const planning_scene::PlanningSceneConstPtr &planning_scene,
+              const planning_interface::MotionPlanRequest &req, const planning_interface::MotionPlanResponse &res);
+
+  /** \brief Remove all plans held in memory. Plans in the persistent storage (if any) are not affected. */
+  void clear();
+
+  /** \brief Set the persistent storage to use. Plans not found in memory are looked up in this storage, and inserted plans are written to it. */
+  void setStorage(const StoragePtr &storage);
+
+  const StoragePtr& getStorage() const
+  {
+    return storage_;
+  }
+
+  /** \brief Get the key under which the plan for request \e req, starting at \e start_state, is stored. The key is a fixed-length
+      hash of the request, computed after the constraints are normalized (time stamps and names cleared, individual constraints sorted),
+      so requests that differ only in those details share a key. */
+  std::string computeKey(const robot_state::RobotState &start_state, const planning_interface::MotionPlanRequest &req) const;
+
+  std::size_t getMaxSize() const
+  {
+    return max_size_;
+  }
+
+  double getStateResolution() const
+  {
+    return state_resolution_;
+  }
+
+  /** \brief Get the number of plans currently held in memory */
+  std::size_t size() const;
+
+  /** \brief Get the number of requests for which a valid plan was found */
+  std::size_t getHitCount() const
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    return hits_;
+  }
+
+  /** \brief Get the number of requests for which no plan was found */
+  std::size_t getMissCount() const
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    return misses_;
+  }
+
+  /** \brief Get the number of requests for which a plan was found, but it was no longer valid */
+  std::size_t getInvalidatedCount() const
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    return invalidated_;
+  }
+
+private:
+
+  robot_state::RobotState getStartState(const planning_scene::PlanningSceneConstPtr &planning_scene,
+                                        const planning_interface::MotionPlanRequest &req) const;
+  bool isPlanValid(const planning_scene::PlanningSceneConstPtr &planning_scene, const planning_interface::MotionPlanRequest &req,
+                   const robot_trajectory::RobotTrajectory &trajectory) const;
+  void insertInMemory(const std::string &key, const robot_trajectory::RobotTrajectoryPtr &trajectory);
+  void remove(const std::string &key);
+
+  struct Entry
+  {
+    robot_trajectory::RobotTrajectoryPtr trajectory_;
+    std::list<std::string>::iterator lru_;
+  };
+
+  robot_model::RobotModelConstPtr model_;
+  std::size_t max_size_;
+  double state_resolution_;
+  StoragePtr storage_;
+
+  /// The cached plans, and their keys in the order of most recent use (most recently used first)
+  std::map<std::string, Entry> plans_;
+  std::list<std::string> lru_;
+  mutable boost::mutex lock_;
+
+  std::size_t hits_;
+  std::size_t misses_;
+  std::size_t invalidated_;
+};
+
+MOVEIT_CLASS_FORWARD(PlanCache);
+
+}
+
+#endif
@@ -39,6 +39,8 @@
 
 #include <moveit/planning_interface/planning_interface.h>
 #include <moveit/planning_request_adapter/planning_request_adapter.h>
+#include <moveit/planning_pipeline/plan_cache.h>
+#include <moveit/planning_scene/planning_scene.h>
 #include <pluginlib/class_loader.h>
 #include <boost/scoped_ptr.hpp>
 #include <ros/ros.h>
@@ -47,6 +49,30 @@
 namespace planning_pipeline
 {
 
+/** \brief Information about a waypoint found to be invalid by checkPath() */
+struct InvalidPathState
+{
+  /// The index of the waypoint in the trajectory
+  std::size_t index_;
+
+  /// The contacts the waypoint is in (empty if the waypoint is not in collision)
+  collision_detection::CollisionResult contacts_;
+
+  /// Flag indicating whether the waypoint is feasible
+  bool feasible_;
+
+  /// Flag indicating whether the waypoint satisfies the path constraints
+  bool satisfies_constraints_;
+};
+
+/** \brief Check the validity of the waypoints of \e trajectory for request \e req (collisions, feasibility, path constraints), using up to \e num_threads threads.
+    Each thread checks blocks of consecutive waypoints. Checking stops once a waypoint that makes the path invalid is found; waypoints in
+    \e tolerated_index and the first waypoint do not count as such by themselves. All invalid waypoints up to and including that waypoint are reported
+    in \e invalid, in order, along with the contacts of those in collision. Return true if no invalid waypoints are found. */
+bool checkPath(const planning_scene::PlanningScene &planning_scene, const robot_trajectory::RobotTrajectory &trajectory,
+               const planning_interface::MotionPlanRequest &req, const std::vector<std::size_t> &tolerated_index,
+               unsigned int num_threads, std::vector<InvalidPathState> &invalid);
+
 /** \brief This class facilitates loading planning plugins and
     planning request adapted plugins.  and allows calling
     planning_interface::PlanningContext::solve() from a loaded
@@ -98,6 +124,10 @@ public:
   /** \brief Pass a flag telling the pipeline whether or not to re-check the solution paths reported by the planner. This is true by default.  */
   void checkSolutionPaths(bool flag);
 
+  /** \brief Pass a flag telling the pipeline whether or not to cache the computed motion plans, and to reuse them (after checking they are still valid)
+      for identical requests. This is false by default, unless the ROS parameter 'cache_plans' is set. */
+  void cachePlans(bool flag);
+
   /** \brief Get the flag set by displayComputedMotionPlans() */
   bool getDisplayComputedMotionPlans() const
   {
@@ -116,6 +146,18 @@ public:
     return check_solution_paths_;
   }
 
+  /** \brief Get the flag set by cachePlans() */
+  bool getCachePlans() const
+  {
+    return static_cast<bool>(plan_cache_);
+  }
+
+  /** \brief Get the cache of motion plans. This is empty unless cachePlans() was enabled. */
+  const PlanCachePtr& getPlanCache() const
+  {
+    return plan_cache_;
+  }
+
   /** \brief Call the motion planner plugin and the sequence of planning request adapters (if any).
       \param planning_scene The planning scene where motion planning is to be done
       \param req The request for motion planning
@@ -189,6 +231,12 @@ private:
   bool check_solution_paths_;
   ros::Publisher contacts_publisher_;
 
+  /// The number of threads used to check solution paths
+  unsigned int solution_check_threads_;
+
+  /// The cache of computed motion plans; this is only allocated if plans are to be cached
+  PlanCachePtr plan_cache_;
+
 };
 
 MOVEIT_CLASS_FORWARD(PlanningPipeline);
@@ -0,0 +1,101 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_PLANNING_PIPELINE_RACING_PLANNER_MANAGER_
+#define MOVEIT_PLANNING_PIPELINE_RACING_PLANNER_MANAGER_
+
+#include <moveit/planning_interface/planning_interface.h>
+
+namespace planning_pipeline
+{
+
+/** \brief A planner manager that dispatches every request concurrently to several configurations of another planner manager
+    (or to several instances of the same configuration, which differ by their random seeds).
+    Depending on the mode, the first solution found is returned and the remaining planners are terminated, or all planners are
+    allowed to run until the allowed planning time elapses and the shortest solution is returned. */
+class RacingPlannerManager : public planning_interface::PlannerManager
+{
+public:
+
+  enum RacingMode
+    {
+      /// Return the first solution found, and terminate the other planners
+      FIRST_SOLUTION,
+
+      /// Return the shortest solution (in joint space) found by any of the planners within the allowed planning time
+      SHORTEST_SOLUTION
+    };
+
+  /** \brief Race planners of \e planner. Every entry of \e planner_ids is a planner configuration to use (an empty entry
+      stands for the configuration specified in the request); each one is run \e instances times. */
+  RacingPlannerManager(const planning_interface::PlannerManagerPtr &planner, const std::vector<std::string> &planner_ids,
+                       unsigned int instances = 1, RacingMode mode = FIRST_SOLUTION);
+
+  virtual bool initialize(const robot_model::RobotModelConstPtr& model, const std::string &ns);
+  virtual std::string getDescription() const;
+  virtual void getPlanningAlgorithms(std::vector<std::string> &algs) const;
+  virtual planning_interface::PlanningContextPtr getPlanningContext(const planning_scene::PlanningSceneConstPtr &planning_scene,
+                                                                    const planning_interface::MotionPlanRequest &req,
+                                                                    moveit_msgs::MoveItErrorCodes &error_code) const;
+  virtual bool canServiceRequest(const planning_interface::MotionPlanRequest &req) const;
+  virtual void setPlannerConfigurations(const planning_interface::PlannerConfigurationMap &pcs);
+
+  /** \brief Get the planner manager whose planners are raced */
+  const planning_interface::PlannerManagerPtr& getRacedPlannerManager() const
+  {
+    return planner_;
+  }
+
+  /** \brief Get the number of planners that are run for every request */
+  std::size_t getRacerCount() const
+  {
+    return planner_ids_.size() * instances_;
+  }
+
+  RacingMode getRacingMode() const
+  {
+    return mode_;
+  }
+
+private:
+
+  planning_interface::PlannerManagerPtr planner_;
+  std::vector<std::string> planner_ids_;
+  unsigned int instances_;
+  RacingMode mode_;
+};
+
+}
+
+#endif
@@ -0,0 +1,371 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_pipeline/plan_cache.h>
+#include <moveit/robot_state/conversions.h>
+#include <moveit/kinematic_constraints/kinematic_constraint.h>
+#include <ros/serialization.h>
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+
+namespace
+{
+
+/* 64 bit FNV-1a hash; unlike boost::hash, its value is specified, so keys remain valid across builds and platforms,
+   which matters for plans kept in a persistent storage */
+class KeyHash
+{
+public:
+
+  KeyHash() : value_(14695981039346656037ULL)
+  {
+  }
+
+  void add(const void *data, std::size_t size)
+  {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    for (std::size_t i = 0 ; i < size ; ++i)
+    {
+      value_ ^= bytes[i];
+      value_ *= 1099511628211ULL;
+    }
+  }
+
+  void add(const std::string &str)
+  {
+    // the terminating null character separates consecutive strings
+    add(str.c_str(), str.size() + 1);
+  }
+
+  void add(boost::int64_t value)
+  {
+    add(&value, sizeof(value));
+  }
+
+  template<typename T>
+  void addMsg(const T &msg)
+  {
+    uint32_t length = ros::serialization::serializationLength(msg);
+    std::vector<uint8_t> buffer(length);
+    if (length > 0)
+    {
+      ros::serialization::OStream stream(&buffer[0], length);
+      ros::serialization::serialize(stream, msg);
+      add(&buffer[0], length);
+    }
+  }
+
+  std::string str() const
+  {
+    char buffer[17];
+    snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)value_);
+    return buffer;
+  }
+
+private:
+
+  boost::uint64_t value_;
+};
+
+void clearHeader(std_msgs::Header &header)
+{
+  header.seq = 0;
+  header.stamp = ros::Time();
+}
+
+template<typename T>
+bool lessByLinkName(const T &a, const T &b)
+{
+  return a.link_name < b.link_name;
+}
+
+bool lessByJointName(const moveit_msgs::JointConstraint &a, const moveit_msgs::JointConstraint &b)
+{
+  return a.joint_name < b.joint_name;
+}
+
+/* Bring \e constraints to a canonical form: the parts that do not change the meaning of the constraints (names, time stamps,
+   the order in which the individual constraints are listed) are cleared or sorted */
+void normalizeConstraints(moveit_msgs::Constraints &constraints)
+{
+  constraints.name.clear();
+  std::stable_sort(constraints.joint_constraints.begin(), constraints.joint_constraints.end(), &lessByJointName);
+  for (std::size_t i = 0 ; i < constraints.position_constraints.size() ; ++i)
+    clearHeader(constraints.position_constraints[i].header);
+  std::stable_sort(constraints.position_constraints.begin(), constraints.position_constraints.end(),
+                   &lessByLinkName<moveit_msgs::PositionConstraint>);
+  for (std::size_t i = 0 ; i < constraints.orientation_constraints.size() ; ++i)
+    clearHeader(constraints.orientation_constraints[i].header);
+  std::stable_sort(constraints.orientation_constraints.begin(), constraints.orientation_constraints.end(),
+                   &lessByLinkName<moveit_msgs::OrientationConstraint>);
+  for (std::size_t i = 0 ; i < constraints.visibility_constraints.size() ; ++i)
+  {
+    clearHeader(constraints.visibility_constraints[i].target_pose.header);
+    clearHeader(constraints.visibility_constraints[i].sensor_pose.header);
+  }
+}
+
+void addNormalizedConstraints(const moveit_msgs::Constraints &constraints, KeyHash &hash)
+{
+  moveit_msgs::Constraints normalized(constraints);
+  normalizeConstraints(normalized);
+  hash.addMsg(normalized);
+}
+
+robot_trajectory::RobotTrajectoryPtr copyTrajectory(const robot_trajectory::RobotTrajectory &trajectory)
+{
+  robot_trajectory::RobotTrajectoryPtr result(new robot_trajectory::RobotTrajectory(trajectory.getRobotModel(), trajectory.getGroupName()));
+  for (std::size_t i = 0 ; i < trajectory.getWayPointCount() ; ++i)
+    result->addSuffixWayPoint(robot_state::RobotStatePtr(new robot_state::RobotState(trajectory.getWayPoint(i))),
+                              trajectory.getWayPointDurationFromPrevious(i));
+  return result;
+}
+
+}
+
+planning_pipeline::PlanCache::PlanCache(const robot_model::RobotModelConstPtr &model, std::size_t max_size, double state_resolution) :
+  model_(model),
+  max_size_(max_size),
+  state_resolution_(state_resolution),
+  hits_(0),
+  misses_(0),
+  invalidated_(0)
+{
+}
+
+void planning_pipeline::PlanCache::setStorage(const StoragePtr &storage)
+{
+  boost::mutex::scoped_lock slock(lock_);
+  storage_ = storage;
+}
+
+std::size_t planning_pipeline::PlanCache::size() const
+{
+  boost::mutex::scoped_lock slock(lock_);
+  return plans_.size();
+}
+
+void planning_pipeline::PlanCache::clear()
+{
+  boost::mutex::scoped_lock slock(lock_);
+  plans_.clear();
+  lru_.clear();
+}
+
+robot_state::RobotState planning_pipeline::PlanCache::getStartState(const planning_scene::PlanningSceneConstPtr &planning_scene,
+                                                                    const planning_interface::MotionPlanRequest &req) const
+{
+  robot_state::RobotState start_state = planning_scene->getCurrentState();
+  robot_state::robotStateMsgToRobotState(planning_scene->getTransforms(), req.start_state, start_state);
+  start_state.update();
+  return start_state;
+}
+
+std::string planning_pipeline::PlanCache::computeKey(const robot_state::RobotState &start_state, const planning_interface::MotionPlanRequest &req) const
+{
+  KeyHash hash;
+  hash.add(model_->getName());
+  hash.add(req.group_name);
+  hash.add(req.planner_id);
+
+  const double *positions = start_state.getVariablePositions();
+  for (std::size_t i = 0 ; i < start_state.getVariableCount() ; ++i)
+    hash.add((boost::int64_t)floor(positions[i] / state_resolution_ + 0.5));
+
+  // attached bodies change what the plan needs to avoid, so they are part of the key as well; they are sorted
+  // because the order in which they are reported does not matter
+  std::vector<const robot_state::AttachedBody*> attached;
+  start_state.getAttachedBodies(attached);
+  std::vector<std::string> attached_names(attached.size());
+  for (std::size_t i = 0 ; i < attached.size() ; ++i)
+    attached_names[i] = attached[i]->getName() + "@" + attached[i]->getAttachedLinkName();
+  std::sort(attached_names.begin(), attached_names.end());
+  hash.add((boost::int64_t)attached_names.size());
+  for (std::size_t i = 0 ; i < attached_names.size() ; ++i)
+    hash.add(attached_names[i]);
+
+  hash.add((boost::int64_t)req.goal_constraints.size());
+  for (std::size_t i = 0 ; i < req.goal_constraints.size() ; ++i)
+    addNormalizedConstraints(req.goal_constraints[i], hash);
+  addNormalizedConstraints(req.path_constraints, hash);
+  moveit_msgs::TrajectoryConstraints trajectory_constraints(req.trajectory_constraints);
+  for (std::size_t i = 0 ; i < trajectory_constraints.constraints.size() ; ++i)
+    normalizeConstraints(trajectory_constraints.constraints[i]);
+  hash.addMsg(trajectory_constraints);
+
+  // the key may (rarely) be the same for different requests; this is safe because cached plans are validated before use
+  return hash.str();
+}
+
+bool planning_pipeline::PlanCache::isPlanValid(const planning_scene::PlanningSceneConstPtr &planning_scene, const planning_interface::MotionPlanRequest &req,
+                                               const robot_trajectory::RobotTrajectory &trajectory) const
+{
+  if (trajectory.empty() || !planning_scene->isPathValid(trajectory, req.path_constraints, req.group_name))
+    return false;
+
+  // goal constraints may be expressed relative to frames that moved since the plan was computed
+  if (req.goal_constraints.empty())
+    return true;
+  for (std::size_t i = 0 ; i < req.goal_constraints.size() ; ++i)
+  {
+    kinematic_constraints::KinematicConstraintSet kset(model_);
+    kset.add(req.goal_constraints[i], planning_scene->getTransforms());
+    if (kset.decide(trajectory.getLastWayPoint()).satisfied)
+      return true;
+  }
+  return false;
+}
+
+void planning_pipeline::PlanCache::insertInMemory(const std::string &key, const robot_trajectory::RobotTrajectoryPtr &trajectory)
+{
+  if (max_size_ == 0)
+    return;
+  std::map<std::string, Entry>::iterator it = plans_.find(key);
+  if (it != plans_.end())
+  {
+    lru_.erase(it->second.lru_);
+    plans_.erase(it);
+  }
+  while (plans_.size() >= max_size_ && !lru_.empty())
+  {
+    plans_.erase(lru_.back());
+    lru_.pop_back();
+  }
+  lru_.push_front(key);
+  Entry &e = plans_[key];
+  e.trajectory_ = trajectory;
+  e.lru_ = lru_.begin();
+}
+
+void planning_pipeline::PlanCache::remove(const std::string &key)
+{
+  std::map<std::string, Entry>::iterator it = plans_.find(key);
+  if (it != plans_.end())
+  {
+    lru_.erase(it->second.lru_);
+    plans_.erase(it);
+  }
+}
+
+bool planning_pipeline::PlanCache::lookup(const planning_scene::PlanningSceneConstPtr &planning_scene,
+                                          const planning_interface::MotionPlanRequest &req, planning_interface::MotionPlanResponse &res)
+{
+  ros::WallTime start = ros::WallTime::now();
+  robot_state::RobotState start_state = getStartState(planning_scene, req);
+  std::string key = computeKey(start_state, req);
+
+  robot_trajectory::RobotTrajectoryPtr cached;
+  StoragePtr storage;
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    std::map<std::string, Entry>::iterator it = plans_.find(key);
+    if (it != plans_.end())
+    {
+      lru_.splice(lru_.begin(), lru_, it->second.lru_);
+      cached = it->second.trajectory_;
+    }
+    storage = storage_;
+  }
+
+  if (!cached && storage)
+  {
+    moveit_msgs::RobotTrajectory msg;
+    if (storage->loadPlan(key, msg))
+    {
+      cached.reset(new robot_trajectory::RobotTrajectory(model_, req.group_name));
+      cached->setRobotTrajectoryMsg(start_state, msg);
+      boost::mutex::scoped_lock slock(lock_);
+      insertInMemory(key, cached);
+    }
+  }
+
+  if (!cached)
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    ++misses_;
+    return false;
+  }
+
+  // the cached plan starts at a state that is equal to the requested one only up to the resolution of the key
+  robot_trajectory::RobotTrajectoryPtr trajectory = copyTrajectory(*cached);
+  *trajectory->getWayPointPtr(0) = start_state;
+
+  if (!isPlanValid(planning_scene, req, *trajectory))
+  {
+    ROS_DEBUG("Cached plan for group '%s' is no longer valid", req.group_name.c_str());
+    {
+      boost::mutex::scoped_lock slock(lock_);
+      remove(key);
+      ++invalidated_;
+    }
+    if (storage)
+      storage->removePlan(key);
+    return false;
+  }
+
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    ++hits_;
+  }
+  res.trajectory_ = trajectory;
+  res.planning_time_ = (ros::WallTime::now() - start).toSec();
+  res.error_code_.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+  ROS_DEBUG("Found valid cached plan for group '%s' (%lf seconds)", req.group_name.c_str(), res.planning_time_);
+  return true;
+}
+
+void planning_pipeline::PlanCache::insert(const planning_scene::PlanningSceneConstPtr &planning_scene,
+                                          const planning_interface::MotionPlanRequest &req, const planning_interface::MotionPlanResponse &res)
+{
+  if (!res.trajectory_ || res.trajectory_->empty())
+    return;
+  std::string key = computeKey(getStartState(planning_scene, req), req);
+  robot_trajectory::RobotTrajectoryPtr trajectory = copyTrajectory(*res.trajectory_);
+
+  StoragePtr storage;
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    insertInMemory(key, trajectory);
+    storage = storage_;
+  }
+
+  if (storage)
+  {
+    moveit_msgs::RobotTrajectory msg;
+    trajectory->getRobotTrajectoryMsg(msg);
+    storage->storePlan(key, msg);
+  }
+}
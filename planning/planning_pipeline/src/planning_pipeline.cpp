@@ -35,19 +35,148 @@
 /* Author: Ioan Sucan */
 
 #include <moveit/planning_pipeline/planning_pipeline.h>
+#include <moveit/planning_pipeline/racing_planner_manager.h>
 #include <moveit/robot_state/conversions.h>
 #include <moveit/collision_detection/collision_tools.h>
+#include <moveit/kinematic_constraints/kinematic_constraint.h>
 #include <moveit/trajectory_processing/trajectory_tools.h>
 #include <moveit_msgs/DisplayTrajectory.h>
 #include <visualization_msgs/MarkerArray.h>
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <boost/thread.hpp>
 #include <sstream>
+#include <algorithm>
+#include <limits>
 
 const std::string planning_pipeline::PlanningPipeline::DISPLAY_PATH_TOPIC = "display_planned_path";
 const std::string planning_pipeline::PlanningPipeline::MOTION_PLAN_REQUEST_TOPIC = "motion_plan_request";
 const std::string planning_pipeline::PlanningPipeline::MOTION_CONTACTS_TOPIC = "display_contacts";
 
+namespace planning_pipeline
+{
+
+// the number of consecutive waypoints checked by a thread at a time
+static const std::size_t PATH_CHECK_BLOCK_SIZE = 16;
+
+namespace
+{
+
+struct PathCheckData
+{
+  const planning_scene::PlanningScene *scene_;
+  const robot_trajectory::RobotTrajectory *trajectory_;
+  const kinematic_constraints::KinematicConstraintSet *constraints_;
+  const std::string *group_;
+  const std::vector<std::size_t> *tolerated_;
+
+  boost::mutex lock_;
+  std::size_t next_block_;
+
+  // index of the first invalid waypoint that makes the path invalid regardless of other waypoints
+  std::size_t first_problem_;
+  std::vector<InvalidPathState> invalid_;
+};
+
+void checkPathBlocks(PathCheckData *data)
+{
+  const std::size_t state_count = data->trajectory_->getWayPointCount();
+  std::vector<InvalidPathState> invalid;
+  while (true)
+  {
+    std::size_t begin;
+    {
+      boost::mutex::scoped_lock slock(data->lock_);
+      begin = data->next_block_;
+      if (begin >= state_count || begin > data->first_problem_)
+        break;
+      data->next_block_ += PATH_CHECK_BLOCK_SIZE;
+    }
+    std::size_t end = std::min(begin + PATH_CHECK_BLOCK_SIZE, state_count);
+    for (std::size_t i = begin ; i < end ; ++i)
+    {
+      const robot_state::RobotState &st = data->trajectory_->getWayPoint(i);
+      // contacts are requested right away, so they are available for explaining why the path is invalid;
+      // they are only computed for states that are in collision
+      collision_detection::CollisionRequest c_req;
+      collision_detection::CollisionResult c_res;
+      c_req.group_name = *data->group_;
+      c_req.contacts = true;
+      c_req.max_contacts = 10;
+      c_req.max_contacts_per_pair = 3;
+      data->scene_->checkCollision(c_req, c_res, st);
+      bool feasible = data->scene_->isStateFeasible(st);
+      bool satisfied = data->constraints_->empty() || data->constraints_->decide(st).satisfied;
+      if (!c_res.collision && feasible && satisfied)
+        continue;
+
+      InvalidPathState s;
+      s.index_ = i;
+      s.feasible_ = feasible;
+      s.satisfies_constraints_ = satisfied;
+      s.contacts_ = c_res;
+      invalid.push_back(s);
+
+      // states added by request adapters and the start state do not by themselves make the path invalid
+      if (i != 0 && std::find(data->tolerated_->begin(), data->tolerated_->end(), i) == data->tolerated_->end())
+      {
+        boost::mutex::scoped_lock slock(data->lock_);
+        data->first_problem_ = std::min(data->first_problem_, i);
+        break;
+      }
+    }
+  }
+
+  boost::mutex::scoped_lock slock(data->lock_);
+  data->invalid_.insert(data->invalid_.end(), invalid.begin(), invalid.end());
+}
+
+bool compareInvalidPathStates(const InvalidPathState &a, const InvalidPathState &b)
+{
+  return a.index_ < b.index_;
+}
+
+}
+
+bool checkPath(const planning_scene::PlanningScene &planning_scene, const robot_trajectory::RobotTrajectory &trajectory,
+               const planning_interface::MotionPlanRequest &req, const std::vector<std::size_t> &tolerated_index,
+               unsigned int num_threads, std::vector<InvalidPathState> &invalid)
+{
+  kinematic_constraints::KinematicConstraintSet ks_p(planning_scene.getRobotModel());
+  ks_p.add(req.path_constraints, planning_scene.getTransforms());
+
+  PathCheckData data;
+  data.scene_ = &planning_scene;
+  data.trajectory_ = &trajectory;
+  data.constraints_ = &ks_p;
+  data.group_ = &req.group_name;
+  data.tolerated_ = &tolerated_index;
+  data.next_block_ = 0;
+  data.first_problem_ = std::numeric_limits<std::size_t>::max();
+
+  std::size_t blocks = (trajectory.getWayPointCount() + PATH_CHECK_BLOCK_SIZE - 1) / PATH_CHECK_BLOCK_SIZE;
+  num_threads = std::min<std::size_t>(num_threads, blocks);
+  if (num_threads <= 1)
+    checkPathBlocks(&data);
+  else
+  {
+    boost::thread_group threads;
+    for (unsigned int i = 0 ; i < num_threads ; ++i)
+      threads.create_thread(boost::bind(&checkPathBlocks, &data));
+    threads.join_all();
+  }
+
+  // only report states up to the first one that makes the path invalid, so the outcome does not depend on thread scheduling
+  invalid.clear();
+  for (std::size_t i = 0 ; i < data.invalid_.size() ; ++i)
+    if (data.invalid_[i].index_ <= data.first_problem_)
+      invalid.push_back(data.invalid_[i]);
+  std::sort(invalid.begin(), invalid.end(), &compareInvalidPathStates);
+  return invalid.empty();
+}
+
+}
+
 planning_pipeline::PlanningPipeline::PlanningPipeline(const robot_model::RobotModelConstPtr& model,
                                                       const ros::NodeHandle &nh,
                                                       const std::string &planner_plugin_param_name,
@@ -125,6 +254,40 @@ void planning_pipeline::PlanningPipeline::configure()
                      << "Available plugins: " << boost::algorithm::join(classes, ", "));
   }
 
+  // if multiple planner configurations (or multiple instances of the same configuration) are to be raced against each other,
+  // wrap the loaded planner so that requests are dispatched to all of them concurrently
+  if (planner_instance_)
+  {
+    std::vector<std::string> racing_planner_ids;
+    std::string racing_ids;
+    if (nh_.getParam("racing_planner_ids", racing_ids))
+    {
+      boost::char_separator<char> sep(" ");
+      boost::tokenizer<boost::char_separator<char> > tok(racing_ids, sep);
+      for(boost::tokenizer<boost::char_separator<char> >::iterator beg = tok.begin() ; beg != tok.end(); ++beg)
+        racing_planner_ids.push_back(*beg);
+    }
+    int racing_instances = 1;
+    nh_.param("racing_instances", racing_instances, 1);
+    std::string racing_mode = "first";
+    nh_.param("racing_mode", racing_mode, racing_mode);
+    if (racing_instances < 1)
+      racing_instances = 1;
+    if (std::max<std::size_t>(racing_planner_ids.size(), 1) * racing_instances > 1)
+    {
+      RacingPlannerManager::RacingMode mode = RacingPlannerManager::FIRST_SOLUTION;
+      if (racing_mode == "shortest")
+        mode = RacingPlannerManager::SHORTEST_SOLUTION;
+      else
+        if (racing_mode != "first")
+          ROS_WARN("Unknown racing mode '%s'. Using 'first'.", racing_mode.c_str());
+      planner_instance_.reset(new RacingPlannerManager(planner_instance_, racing_planner_ids, racing_instances, mode));
+      ROS_INFO("Racing %u planners for every request (%s solution wins)",
+               (unsigned int)static_cast<RacingPlannerManager*>(planner_instance_.get())->getRacerCount(),
+               mode == RacingPlannerManager::FIRST_SOLUTION ? "first" : "shortest");
+    }
+  }
+
   // load the planner request adapters
   if (!adapter_plugin_names_.empty())
   {
@@ -165,6 +328,14 @@ void planning_pipeline::PlanningPipeline::configure()
   }
   displayComputedMotionPlans(true);
   checkSolutionPaths(true);
+
+  int solution_check_threads = 0;
+  nh_.param("solution_path_check_threads", solution_check_threads, 0);
+  solution_check_threads_ = solution_check_threads > 0 ? solution_check_threads : boost::thread::hardware_concurrency();
+
+  bool cache_plans = false;
+  nh_.param("cache_plans", cache_plans, false);
+  cachePlans(cache_plans);
 }
 
 void planning_pipeline::PlanningPipeline::displayComputedMotionPlans(bool flag)
@@ -187,6 +358,22 @@ void planning_pipeline::PlanningPipeline::publishReceivedRequests(bool flag)
   publish_received_requests_ = flag;
 }
 
+void planning_pipeline::PlanningPipeline::cachePlans(bool flag)
+{
+  if (flag && !plan_cache_)
+  {
+    int max_size = 100;
+    double state_resolution = 1e-3;
+    nh_.param("plan_cache_size", max_size, max_size);
+    nh_.param("plan_cache_state_resolution", state_resolution, state_resolution);
+    plan_cache_.reset(new PlanCache(kmodel_, max_size > 0 ? max_size : 0, state_resolution));
+    ROS_INFO("Caching up to %d motion plans", max_size);
+  }
+  else
+    if (!flag)
+      plan_cache_.reset();
+}
+
 void planning_pipeline::PlanningPipeline::checkSolutionPaths(bool flag)
 {
   if (check_solution_paths_ && !flag)
@@ -221,47 +408,58 @@ bool planning_pipeline::PlanningPipeline::generatePlan(const planning_scene::Pla
     return false;
   }
 
-  bool solved = false;
-  try
+  // reuse a previously computed plan, if one is available and still valid
+  PlanCachePtr plan_cache = plan_cache_;
+  bool from_cache = plan_cache && plan_cache->lookup(planning_scene, req, res);
+
+  bool solved = from_cache;
+  if (!from_cache)
   {
-    if (adapter_chain_)
+    try
     {
-      solved = adapter_chain_->adaptAndPlan(planner_instance_, planning_scene, req, res, adapter_added_state_index);
-      if (!adapter_added_state_index.empty())
+      if (adapter_chain_)
       {
-        std::stringstream ss;
-        for (std::size_t i = 0 ; i < adapter_added_state_index.size() ; ++i)
-          ss << adapter_added_state_index[i] << " ";
-        ROS_INFO("Planning adapters have added states at index positions: [ %s]", ss.str().c_str());
+        solved = adapter_chain_->adaptAndPlan(planner_instance_, planning_scene, req, res, adapter_added_state_index);
+        if (!adapter_added_state_index.empty())
+        {
+          std::stringstream ss;
+          for (std::size_t i = 0 ; i < adapter_added_state_index.size() ; ++i)
+            ss << adapter_added_state_index[i] << " ";
+          ROS_INFO("Planning adapters have added states at index positions: [ %s]", ss.str().c_str());
+        }
+      }
+      else
+      {
+        planning_interface::PlanningContextPtr context = planner_instance_->getPlanningContext(planning_scene, req, res.error_code_);
+        solved = context ? context->solve(res) : false;
       }
     }
-    else
+    catch(std::runtime_error &ex)
     {
-      planning_interface::PlanningContextPtr context = planner_instance_->getPlanningContext(planning_scene, req, res.error_code_);
-      solved = context ? context->solve(res) : false;
+      ROS_ERROR("Exception caught: '%s'", ex.what());
+      return false;
+    }
+    catch(...)
+    {
+      ROS_ERROR("Unknown exception thrown by planner");
+      return false;
     }
-  }
-  catch(std::runtime_error &ex)
-  {
-    ROS_ERROR("Exception caught: '%s'", ex.what());
-    return false;
-  }
-  catch(...)
-  {
-    ROS_ERROR("Unknown exception thrown by planner");
-    return false;
   }
   bool valid = true;
 
-  if (solved && res.trajectory_)
+  if (solved && res.trajectory_ && !from_cache)
   {
     std::size_t state_count = res.trajectory_->getWayPointCount();
     ROS_DEBUG_STREAM("Motion planner reported a solution path with " << state_count << " states");
     if (check_solution_paths_)
     {
-      std::vector<std::size_t> index;
-      if (!planning_scene->isPathValid(*res.trajectory_, req.path_constraints, req.group_name, false, &index))
+      std::vector<InvalidPathState> invalid;
+      if (!checkPath(*planning_scene, *res.trajectory_, req, adapter_added_state_index, solution_check_threads_, invalid))
       {
+        std::vector<std::size_t> index(invalid.size());
+        for (std::size_t i = 0 ; i < invalid.size() ; ++i)
+          index[i] = invalid[i].index_;
+
         // check to see if there is any problem with the states that are found to be invalid
         // they are considered ok if they were added by a planning request adapter
         bool problem = false;
@@ -293,22 +491,21 @@ bool planning_pipeline::PlanningPipeline::generatePlan(const planning_scene::Pla
             ROS_ERROR_STREAM("Computed path is not valid. Invalid states at index locations: [ " << ss.str() << "] out of " << state_count
                              << ". Explanations follow in command line. Contacts are published on " << nh_.resolveName(MOTION_CONTACTS_TOPIC));
 
-            // call validity checks in verbose mode for the problematic states
+            // explain why the problematic states are invalid; contacts were already computed when checking the path
+            kinematic_constraints::KinematicConstraintSet ks_p(planning_scene->getRobotModel());
+            ks_p.add(req.path_constraints, planning_scene->getTransforms());
             visualization_msgs::MarkerArray arr;
-            for (std::size_t i = 0 ; i < index.size() ; ++i)
+            for (std::size_t i = 0 ; i < invalid.size() ; ++i)
             {
-              // check validity with verbose on
-              const robot_state::RobotState &kstate = res.trajectory_->getWayPoint(index[i]);
-              planning_scene->isStateValid(kstate, req.path_constraints, req.group_name, true);
-              
-              // compute the contacts if any
-              collision_detection::CollisionRequest c_req;
-              collision_detection::CollisionResult c_res;
-              c_req.contacts = true;
-              c_req.max_contacts = 10;
-              c_req.max_contacts_per_pair = 3;
-              c_req.verbose = false;
-              planning_scene->checkCollision(c_req, c_res, kstate);
+              const robot_state::RobotState &kstate = res.trajectory_->getWayPoint(invalid[i].index_);
+              const collision_detection::CollisionResult &c_res = invalid[i].contacts_;
+              for (collision_detection::CollisionResult::ContactMap::const_iterator it = c_res.contacts.begin() ; it != c_res.contacts.end() ; ++it)
+                ROS_INFO("State at index %u: found a contact between '%s' and '%s'", (unsigned int)invalid[i].index_,
+                         it->first.first.c_str(), it->first.second.c_str());
+              if (!invalid[i].feasible_)
+                planning_scene->isStateFeasible(kstate, true);
+              if (!invalid[i].satisfies_constraints_)
+                ks_p.decide(kstate, true);
               if (c_res.contact_count > 0)
               {
                 visualization_msgs::MarkerArray arr_i;
@@ -340,6 +537,9 @@ bool planning_pipeline::PlanningPipeline::generatePlan(const planning_scene::Pla
     display_path_publisher_.publish(disp);
   }
 
+  if (plan_cache && !from_cache && solved && valid)
+    plan_cache->insert(planning_scene, req, res);
+
   return solved && valid;
 }
 
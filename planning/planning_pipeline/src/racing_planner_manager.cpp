@@ -0,0 +1,297 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_pipeline/racing_planner_manager.h>
+#include <boost/thread.hpp>
+#include <ros/ros.h>
+#include <limits>
+#include <algorithm>
+
+namespace planning_pipeline
+{
+
+// how much longer than the allowed planning time racers are waited for, before they are terminated
+static const double RACE_DEADLINE_GRACE = 0.1;
+
+namespace
+{
+
+robot_trajectory::RobotTrajectoryPtr getSolution(const planning_interface::MotionPlanResponse &res)
+{
+  return res.trajectory_;
+}
+
+robot_trajectory::RobotTrajectoryPtr getSolution(const planning_interface::MotionPlanDetailedResponse &res)
+{
+  return res.trajectory_.empty() ? robot_trajectory::RobotTrajectoryPtr() : res.trajectory_.back();
+}
+
+double getPathLength(const robot_trajectory::RobotTrajectory &trajectory)
+{
+  double length = 0.0;
+  for (std::size_t i = 1 ; i < trajectory.getWayPointCount() ; ++i)
+    length += trajectory.getWayPoint(i).distance(trajectory.getWayPoint(i - 1));
+  return length;
+}
+
+void setPlanningTime(planning_interface::MotionPlanResponse &res, double time)
+{
+  res.planning_time_ = time;
+}
+
+void setPlanningTime(planning_interface::MotionPlanDetailedResponse &, double)
+{
+}
+
+class RacingPlanningContext : public planning_interface::PlanningContext
+{
+public:
+
+  RacingPlanningContext(const std::string &group, const std::vector<planning_interface::PlanningContextPtr> &racers,
+                        RacingPlannerManager::RacingMode mode) :
+    planning_interface::PlanningContext("racing", group),
+    racers_(racers),
+    mode_(mode),
+    finished_(0),
+    winner_(-1)
+  {
+  }
+
+  virtual bool solve(planning_interface::MotionPlanResponse &res)
+  {
+    return race(res);
+  }
+
+  virtual bool solve(planning_interface::MotionPlanDetailedResponse &res)
+  {
+    return race(res);
+  }
+
+  virtual bool terminate()
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    for (std::size_t i = 0 ; i < racers_.size() ; ++i)
+      racers_[i]->terminate();
+    return true;
+  }
+
+  virtual void clear()
+  {
+    for (std::size_t i = 0 ; i < racers_.size() ; ++i)
+      racers_[i]->clear();
+  }
+
+private:
+
+  template<typename R>
+  void runRacer(std::size_t index, R *res)
+  {
+    bool solved = racers_[index]->solve(*res) && getSolution(*res);
+
+    boost::mutex::scoped_lock slock(lock_);
+    ++finished_;
+    if (solved)
+    {
+      solved_[index] = true;
+      if (mode_ == RacingPlannerManager::FIRST_SOLUTION && winner_ < 0)
+      {
+        winner_ = index;
+        for (std::size_t i = 0 ; i < racers_.size() ; ++i)
+          if (i != index)
+            racers_[i]->terminate();
+      }
+    }
+    condition_.notify_all();
+  }
+
+  template<typename R>
+  bool race(R &res)
+  {
+    ros::WallTime start = ros::WallTime::now();
+    std::vector<R> results(racers_.size());
+    {
+      boost::mutex::scoped_lock slock(lock_);
+      solved_.assign(racers_.size(), false);
+      finished_ = 0;
+      winner_ = -1;
+    }
+
+    boost::thread_group threads;
+    for (std::size_t i = 0 ; i < racers_.size() ; ++i)
+      threads.create_thread(boost::bind(&RacingPlanningContext::runRacer<R>, this, i, &results[i]));
+
+    {
+      boost::mutex::scoped_lock slock(lock_);
+      double allowed_time = request_.allowed_planning_time;
+      boost::system_time deadline = boost::get_system_time() +
+        boost::posix_time::microseconds((long)((allowed_time + RACE_DEADLINE_GRACE) * 1000000.0));
+      while (finished_ < racers_.size() && winner_ < 0)
+      {
+        if (allowed_time > 0.0)
+        {
+          if (!condition_.timed_wait(slock, deadline))
+            break;
+        }
+        else
+          condition_.wait(slock);
+      }
+
+      // whatever is still running at this point is not going to be used
+      if (finished_ < racers_.size())
+        for (std::size_t i = 0 ; i < racers_.size() ; ++i)
+          racers_[i]->terminate();
+    }
+    threads.join_all();
+
+    int best = winner_;
+    if (mode_ == RacingPlannerManager::SHORTEST_SOLUTION)
+    {
+      double best_length = std::numeric_limits<double>::infinity();
+      for (std::size_t i = 0 ; i < results.size() ; ++i)
+        if (solved_[i])
+        {
+          double length = getPathLength(*getSolution(results[i]));
+          if (length < best_length)
+          {
+            best_length = length;
+            best = i;
+          }
+        }
+    }
+
+    double planning_time = (ros::WallTime::now() - start).toSec();
+    if (best < 0)
+    {
+      ROS_DEBUG("None of the %u raced planners found a solution", (unsigned int)racers_.size());
+      res = results[0];
+      setPlanningTime(res, planning_time);
+      return false;
+    }
+
+    ROS_DEBUG("Using the solution of raced planner '%s' (%u of %u planners found solutions)", racers_[best]->getName().c_str(),
+              (unsigned int)std::count(solved_.begin(), solved_.end(), true), (unsigned int)racers_.size());
+    res = results[best];
+    setPlanningTime(res, planning_time);
+    return true;
+  }
+
+  std::vector<planning_interface::PlanningContextPtr> racers_;
+  RacingPlannerManager::RacingMode mode_;
+
+  boost::mutex lock_;
+  boost::condition_variable condition_;
+  std::vector<bool> solved_;
+  std::size_t finished_;
+  int winner_;
+};
+
+}
+
+RacingPlannerManager::RacingPlannerManager(const planning_interface::PlannerManagerPtr &planner, const std::vector<std::string> &planner_ids,
+                                           unsigned int instances, RacingMode mode) :
+  planning_interface::PlannerManager(),
+  planner_(planner),
+  planner_ids_(planner_ids),
+  instances_(instances > 0 ? instances : 1),
+  mode_(mode)
+{
+  if (planner_ids_.empty())
+    planner_ids_.push_back("");
+  if (planner_)
+    planning_interface::PlannerManager::setPlannerConfigurations(planner_->getPlannerConfigurations());
+}
+
+bool RacingPlannerManager::initialize(const robot_model::RobotModelConstPtr& model, const std::string &ns)
+{
+  return planner_ && planner_->initialize(model, ns);
+}
+
+std::string RacingPlannerManager::getDescription() const
+{
+  return planner_ ? "Racing " + planner_->getDescription() : "Racing";
+}
+
+void RacingPlannerManager::getPlanningAlgorithms(std::vector<std::string> &algs) const
+{
+  if (planner_)
+    planner_->getPlanningAlgorithms(algs);
+  else
+    algs.clear();
+}
+
+planning_interface::PlanningContextPtr RacingPlannerManager::getPlanningContext(const planning_scene::PlanningSceneConstPtr &planning_scene,
+                                                                                const planning_interface::MotionPlanRequest &req,
+                                                                                moveit_msgs::MoveItErrorCodes &error_code) const
+{
+  std::vector<planning_interface::PlanningContextPtr> racers;
+  if (planner_)
+    for (std::size_t i = 0 ; i < planner_ids_.size() ; ++i)
+    {
+      planning_interface::MotionPlanRequest racer_req = req;
+      if (!planner_ids_[i].empty())
+        racer_req.planner_id = planner_ids_[i];
+      for (unsigned int k = 0 ; k < instances_ ; ++k)
+      {
+        // contexts that are held are not handed out again, so every racer gets its own context
+        planning_interface::PlanningContextPtr context = planner_->getPlanningContext(planning_scene, racer_req, error_code);
+        if (context)
+          racers.push_back(context);
+        else
+          ROS_WARN("Unable to obtain a planning context for raced planner '%s'", racer_req.planner_id.c_str());
+      }
+    }
+
+  if (racers.size() <= 1)
+    return racers.empty() ? planning_interface::PlanningContextPtr() : racers[0];
+
+  error_code.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+  planning_interface::PlanningContextPtr context(new RacingPlanningContext(req.group_name, racers, mode_));
+  context->setPlanningScene(planning_scene);
+  context->setMotionPlanRequest(req);
+  return context;
+}
+
+bool RacingPlannerManager::canServiceRequest(const planning_interface::MotionPlanRequest &req) const
+{
+  return planner_ && planner_->canServiceRequest(req);
+}
+
+void RacingPlannerManager::setPlannerConfigurations(const planning_interface::PlannerConfigurationMap &pcs)
+{
+  if (planner_)
+    planner_->setPlannerConfigurations(pcs);
+  planning_interface::PlannerManager::setPlannerConfigurations(pcs);
+}
+
+}
@@ -0,0 +1,271 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/planning_pipeline/plan_cache.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <urdf_parser/urdf_parser.h>
+#include <map>
+
+static const char *URDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"two_link_arm\">"
+  "<link name=\"base_link\"/>"
+  "<joint name=\"joint_1\" type=\"revolute\">"
+  "  <axis xyz=\"0 0 1\"/>"
+  "  <limit effort=\"10.0\" lower=\"-3.0\" upper=\"3.0\" velocity=\"1.0\"/>"
+  "  <parent link=\"base_link\"/>"
+  "  <child link=\"link_1\"/>"
+  "  <origin rpy=\"0 0 0\" xyz=\"0 0 0.1\"/>"
+  "</joint>"
+  "<link name=\"link_1\"/>"
+  "<joint name=\"joint_2\" type=\"revolute\">"
+  "  <axis xyz=\"0 0 1\"/>"
+  "  <limit effort=\"10.0\" lower=\"-3.0\" upper=\"3.0\" velocity=\"1.0\"/>"
+  "  <parent link=\"link_1\"/>"
+  "  <child link=\"link_2\"/>"
+  "  <origin rpy=\"0 0 0\" xyz=\"0.5 0 0\"/>"
+  "</joint>"
+  "<link name=\"link_2\"/>"
+  "</robot>";
+
+static const char *SRDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"two_link_arm\">"
+  "<group name=\"arm\">"
+  "<joint name=\"joint_1\"/>"
+  "<joint name=\"joint_2\"/>"
+  "</group>"
+  "</robot>";
+
+static robot_model::RobotModelPtr getModel()
+{
+  static robot_model::RobotModelPtr model;
+  if (!model)
+  {
+    boost::shared_ptr<urdf::ModelInterface> urdf(urdf::parseURDF(URDF_STR));
+    boost::shared_ptr<srdf::Model> srdf(new srdf::Model());
+    srdf->initString(*urdf, SRDF_STR);
+    model.reset(new robot_model::RobotModel(urdf, srdf));
+  }
+  return model;
+}
+
+static moveit_msgs::JointConstraint jointConstraint(const std::string &name, double position)
+{
+  moveit_msgs::JointConstraint jc;
+  jc.joint_name = name;
+  jc.position = position;
+  jc.tolerance_above = 0.01;
+  jc.tolerance_below = 0.01;
+  jc.weight = 1.0;
+  return jc;
+}
+
+static planning_interface::MotionPlanRequest makeRequest(double goal_1, double goal_2)
+{
+  planning_interface::MotionPlanRequest req;
+  req.group_name = "arm";
+  req.goal_constraints.resize(1);
+  req.goal_constraints[0].joint_constraints.push_back(jointConstraint("joint_1", goal_1));
+  req.goal_constraints[0].joint_constraints.push_back(jointConstraint("joint_2", goal_2));
+  return req;
+}
+
+// a straight line in joint space from the current state of the scene to the goal of the request
+static planning_interface::MotionPlanResponse makeResponse(const planning_scene::PlanningSceneConstPtr &scene, double goal_1, double goal_2)
+{
+  planning_interface::MotionPlanResponse res;
+  res.trajectory_.reset(new robot_trajectory::RobotTrajectory(scene->getRobotModel(), "arm"));
+  robot_state::RobotState start = scene->getCurrentState();
+  for (std::size_t i = 0 ; i <= 10 ; ++i)
+  {
+    robot_state::RobotStatePtr state(new robot_state::RobotState(start));
+    state->setVariablePosition("joint_1", goal_1 * i / 10.0);
+    state->setVariablePosition("joint_2", goal_2 * i / 10.0);
+    state->update();
+    res.trajectory_->addSuffixWayPoint(state, 0.1);
+  }
+  res.error_code_.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+  return res;
+}
+
+// persistent storage kept in memory, to check what the cache loads and stores
+class MemoryStorage : public planning_pipeline::PlanCache::Storage
+{
+public:
+
+  virtual bool loadPlan(const std::string &key, moveit_msgs::RobotTrajectory &trajectory)
+  {
+    std::map<std::string, moveit_msgs::RobotTrajectory>::const_iterator it = plans_.find(key);
+    if (it == plans_.end())
+      return false;
+    trajectory = it->second;
+    return true;
+  }
+
+  virtual void storePlan(const std::string &key, const moveit_msgs::RobotTrajectory &trajectory)
+  {
+    plans_[key] = trajectory;
+  }
+
+  virtual void removePlan(const std::string &key)
+  {
+    plans_.erase(key);
+  }
+
+  std::map<std::string, moveit_msgs::RobotTrajectory> plans_;
+};
+
+TEST(PlanCache, KeyIsCompactAndNormalized)
+{
+  robot_model::RobotModelPtr model = getModel();
+  planning_pipeline::PlanCache cache(model);
+  robot_state::RobotState state(model);
+  state.setToDefaultValues();
+
+  planning_interface::MotionPlanRequest req = makeRequest(1.0, -0.5);
+  std::string key = cache.computeKey(state, req);
+  EXPECT_EQ(16u, key.size());
+
+  // the order of the individual constraints and their names do not change the key
+  planning_interface::MotionPlanRequest reordered = makeRequest(1.0, -0.5);
+  std::swap(reordered.goal_constraints[0].joint_constraints[0], reordered.goal_constraints[0].joint_constraints[1]);
+  reordered.goal_constraints[0].name = "some goal";
+  EXPECT_EQ(key, cache.computeKey(state, reordered));
+
+  // neither do the time stamps of the constraints
+  moveit_msgs::PositionConstraint pc;
+  pc.header.frame_id = model->getModelFrame();
+  pc.link_name = "link_2";
+  pc.weight = 1.0;
+  planning_interface::MotionPlanRequest stamped_1 = makeRequest(1.0, -0.5);
+  planning_interface::MotionPlanRequest stamped_2 = makeRequest(1.0, -0.5);
+  pc.header.stamp = ros::Time(10.0);
+  stamped_1.path_constraints.position_constraints.push_back(pc);
+  pc.header.stamp = ros::Time(20.0);
+  pc.header.seq = 3;
+  stamped_2.path_constraints.position_constraints.push_back(pc);
+  EXPECT_EQ(cache.computeKey(state, stamped_1), cache.computeKey(state, stamped_2));
+  EXPECT_NE(key, cache.computeKey(state, stamped_1));
+
+  // the goal, the group and the start state (beyond the resolution of the cache) do
+  EXPECT_NE(key, cache.computeKey(state, makeRequest(1.0, 0.5)));
+  planning_interface::MotionPlanRequest other_planner = makeRequest(1.0, -0.5);
+  other_planner.planner_id = "other";
+  EXPECT_NE(key, cache.computeKey(state, other_planner));
+  robot_state::RobotState nearby(state);
+  nearby.setVariablePosition("joint_1", cache.getStateResolution() / 10.0);
+  EXPECT_EQ(key, cache.computeKey(nearby, req));
+  robot_state::RobotState moved(state);
+  moved.setVariablePosition("joint_1", cache.getStateResolution() * 10.0);
+  EXPECT_NE(key, cache.computeKey(moved, req));
+}
+
+TEST(PlanCache, InsertAndLookup)
+{
+  robot_model::RobotModelPtr model = getModel();
+  planning_scene::PlanningScenePtr scene(new planning_scene::PlanningScene(model));
+  planning_pipeline::PlanCache cache(model, 2);
+
+  planning_interface::MotionPlanRequest req = makeRequest(1.0, -0.5);
+  planning_interface::MotionPlanResponse res;
+  EXPECT_FALSE(cache.lookup(scene, req, res));
+  EXPECT_EQ(1u, cache.getMissCount());
+
+  cache.insert(scene, req, makeResponse(scene, 1.0, -0.5));
+  EXPECT_EQ(1u, cache.size());
+  ASSERT_TRUE(cache.lookup(scene, req, res));
+  EXPECT_EQ(1u, cache.getHitCount());
+  ASSERT_TRUE(res.trajectory_);
+  EXPECT_EQ(11u, res.trajectory_->getWayPointCount());
+  EXPECT_NEAR(1.0, res.trajectory_->getLastWayPoint().getVariablePosition("joint_1"), 1e-9);
+
+  // the least recently used plan is evicted when the cache is full
+  cache.insert(scene, makeRequest(0.5, 0.5), makeResponse(scene, 0.5, 0.5));
+  EXPECT_TRUE(cache.lookup(scene, req, res));
+  cache.insert(scene, makeRequest(-0.5, 0.5), makeResponse(scene, -0.5, 0.5));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.lookup(scene, req, res));
+  EXPECT_FALSE(cache.lookup(scene, makeRequest(0.5, 0.5), res));
+}
+
+TEST(PlanCache, InvalidPlansAreDropped)
+{
+  robot_model::RobotModelPtr model = getModel();
+  planning_scene::PlanningScenePtr scene(new planning_scene::PlanningScene(model));
+  boost::shared_ptr<MemoryStorage> storage(new MemoryStorage());
+  planning_pipeline::PlanCache cache(model);
+  cache.setStorage(storage);
+
+  // a plan that does not reach the goal of the request is not returned
+  planning_interface::MotionPlanRequest req = makeRequest(1.0, -0.5);
+  cache.insert(scene, req, makeResponse(scene, 0.5, -0.5));
+  EXPECT_EQ(1u, storage->plans_.size());
+
+  planning_interface::MotionPlanResponse res;
+  EXPECT_FALSE(cache.lookup(scene, req, res));
+  EXPECT_EQ(1u, cache.getInvalidatedCount());
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_TRUE(storage->plans_.empty());
+}
+
+TEST(PlanCache, PlansAreLoadedFromStorage)
+{
+  robot_model::RobotModelPtr model = getModel();
+  planning_scene::PlanningScenePtr scene(new planning_scene::PlanningScene(model));
+  boost::shared_ptr<MemoryStorage> storage(new MemoryStorage());
+
+  planning_interface::MotionPlanRequest req = makeRequest(1.0, -0.5);
+  {
+    planning_pipeline::PlanCache cache(model);
+    cache.setStorage(storage);
+    cache.insert(scene, req, makeResponse(scene, 1.0, -0.5));
+  }
+  ASSERT_EQ(1u, storage->plans_.size());
+
+  // a new cache (e.g., after a restart) finds the plan in the storage
+  planning_pipeline::PlanCache cache(model);
+  cache.setStorage(storage);
+  planning_interface::MotionPlanResponse res;
+  ASSERT_TRUE(cache.lookup(scene, req, res));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_NEAR(-0.5, res.trajectory_->getLastWayPoint().getVariablePosition("joint_2"), 1e-9);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
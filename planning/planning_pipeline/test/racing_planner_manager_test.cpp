@@ -0,0 +1,295 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/planning_pipeline/racing_planner_manager.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <urdf_parser/urdf_parser.h>
+#include <boost/thread.hpp>
+#include <map>
+
+static const char *URDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"one_link_arm\">"
+  "<link name=\"base_link\"/>"
+  "<joint name=\"joint_1\" type=\"revolute\">"
+  "  <axis xyz=\"0 0 1\"/>"
+  "  <limit effort=\"10.0\" lower=\"-3.0\" upper=\"3.0\" velocity=\"1.0\"/>"
+  "  <parent link=\"base_link\"/>"
+  "  <child link=\"link_1\"/>"
+  "  <origin rpy=\"0 0 0\" xyz=\"0 0 0.1\"/>"
+  "</joint>"
+  "<link name=\"link_1\"/>"
+  "</robot>";
+
+static const char *SRDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"one_link_arm\">"
+  "<group name=\"arm\">"
+  "<joint name=\"joint_1\"/>"
+  "</group>"
+  "</robot>";
+
+static robot_model::RobotModelPtr getModel()
+{
+  static robot_model::RobotModelPtr model;
+  if (!model)
+  {
+    boost::shared_ptr<urdf::ModelInterface> urdf(urdf::parseURDF(URDF_STR));
+    boost::shared_ptr<srdf::Model> srdf(new srdf::Model());
+    srdf->initString(*urdf, SRDF_STR);
+    model.reset(new robot_model::RobotModel(urdf, srdf));
+  }
+  return model;
+}
+
+// a planner that needs a fixed amount of time and then reports a straight line from the default state to 'goal',
+// or fails with a given error code; it gives up early when terminated
+class StubPlanningContext : public planning_interface::PlanningContext
+{
+public:
+
+  StubPlanningContext(const std::string &name, double duration, double goal, int error_code = moveit_msgs::MoveItErrorCodes::SUCCESS) :
+    planning_interface::PlanningContext(name, "arm"),
+    duration_(duration),
+    goal_(goal),
+    error_code_(error_code),
+    terminated_(false)
+  {
+  }
+
+  virtual bool solve(planning_interface::MotionPlanResponse &res)
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds((long)(duration_ * 1000000.0));
+    while (!terminated_)
+      if (!condition_.timed_wait(slock, deadline))
+        break;
+    if (terminated_)
+    {
+      res.error_code_.val = moveit_msgs::MoveItErrorCodes::PREEMPTED;
+      return false;
+    }
+    res.error_code_.val = error_code_;
+    if (error_code_ != moveit_msgs::MoveItErrorCodes::SUCCESS)
+      return false;
+
+    res.trajectory_.reset(new robot_trajectory::RobotTrajectory(getModel(), "arm"));
+    for (std::size_t i = 0 ; i <= 10 ; ++i)
+    {
+      robot_state::RobotStatePtr state(new robot_state::RobotState(getModel()));
+      state->setToDefaultValues();
+      state->setVariablePosition("joint_1", goal_ * i / 10.0);
+      state->update();
+      res.trajectory_->addSuffixWayPoint(state, 0.1);
+    }
+    return true;
+  }
+
+  virtual bool solve(planning_interface::MotionPlanDetailedResponse &res)
+  {
+    return false;
+  }
+
+  virtual bool terminate()
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    terminated_ = true;
+    condition_.notify_all();
+    return true;
+  }
+
+  virtual void clear()
+  {
+  }
+
+  bool wasTerminated() const
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    return terminated_;
+  }
+
+private:
+
+  double duration_;
+  double goal_;
+  int error_code_;
+  bool terminated_;
+  mutable boost::mutex lock_;
+  boost::condition_variable condition_;
+};
+
+typedef boost::shared_ptr<StubPlanningContext> StubPlanningContextPtr;
+
+// hands out the stub context registered for the planner id of the request
+class StubPlannerManager : public planning_interface::PlannerManager
+{
+public:
+
+  void addContext(const StubPlanningContextPtr &context)
+  {
+    contexts_[context->getName()] = context;
+  }
+
+  virtual planning_interface::PlanningContextPtr getPlanningContext(const planning_scene::PlanningSceneConstPtr &planning_scene,
+                                                                    const planning_interface::MotionPlanRequest &req,
+                                                                    moveit_msgs::MoveItErrorCodes &error_code) const
+  {
+    std::map<std::string, StubPlanningContextPtr>::const_iterator it = contexts_.find(req.planner_id);
+    if (it == contexts_.end())
+    {
+      error_code.val = moveit_msgs::MoveItErrorCodes::FAILURE;
+      return planning_interface::PlanningContextPtr();
+    }
+    error_code.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+    return it->second;
+  }
+
+  virtual bool canServiceRequest(const planning_interface::MotionPlanRequest &req) const
+  {
+    return true;
+  }
+
+private:
+
+  std::map<std::string, StubPlanningContextPtr> contexts_;
+};
+
+typedef planning_pipeline::RacingPlannerManager RacingPlannerManager;
+
+class RacingPlannerManagerTest : public testing::Test
+{
+protected:
+
+  virtual void SetUp()
+  {
+    scene_.reset(new planning_scene::PlanningScene(getModel()));
+    stub_.reset(new StubPlannerManager());
+  }
+
+  StubPlanningContextPtr addRacer(const std::string &name, double duration, double goal,
+                                  int error_code = moveit_msgs::MoveItErrorCodes::SUCCESS)
+  {
+    StubPlanningContextPtr context(new StubPlanningContext(name, duration, goal, error_code));
+    stub_->addContext(context);
+    planner_ids_.push_back(name);
+    return context;
+  }
+
+  bool race(RacingPlannerManager::RacingMode mode, double allowed_time, planning_interface::MotionPlanResponse &res)
+  {
+    RacingPlannerManager manager(stub_, planner_ids_, 1, mode);
+    planning_interface::MotionPlanRequest req;
+    req.group_name = "arm";
+    req.allowed_planning_time = allowed_time;
+    moveit_msgs::MoveItErrorCodes error_code;
+    planning_interface::PlanningContextPtr context = manager.getPlanningContext(scene_, req, error_code);
+    EXPECT_TRUE(context);
+    EXPECT_EQ(moveit_msgs::MoveItErrorCodes::SUCCESS, error_code.val);
+    return context && context->solve(res);
+  }
+
+  static double getGoal(const planning_interface::MotionPlanResponse &res)
+  {
+    return res.trajectory_->getLastWayPoint().getVariablePosition("joint_1");
+  }
+
+  planning_scene::PlanningScenePtr scene_;
+  boost::shared_ptr<StubPlannerManager> stub_;
+  std::vector<std::string> planner_ids_;
+};
+
+TEST_F(RacingPlannerManagerTest, FirstSolutionTerminatesOthers)
+{
+  StubPlanningContextPtr slow = addRacer("slow", 10.0, 2.0);
+  StubPlanningContextPtr fast = addRacer("fast", 0.05, 1.0);
+
+  ros::WallTime start = ros::WallTime::now();
+  planning_interface::MotionPlanResponse res;
+  ASSERT_TRUE(race(RacingPlannerManager::FIRST_SOLUTION, 20.0, res));
+  EXPECT_LT((ros::WallTime::now() - start).toSec(), 5.0);
+
+  EXPECT_NEAR(1.0, getGoal(res), 1e-9);
+  EXPECT_TRUE(slow->wasTerminated());
+}
+
+TEST_F(RacingPlannerManagerTest, ShortestSolutionIsPicked)
+{
+  StubPlanningContextPtr first = addRacer("first", 0.01, 2.0);
+  StubPlanningContextPtr shortest = addRacer("shortest", 0.1, -0.5);
+  StubPlanningContextPtr other = addRacer("other", 0.05, 1.0);
+
+  planning_interface::MotionPlanResponse res;
+  ASSERT_TRUE(race(RacingPlannerManager::SHORTEST_SOLUTION, 5.0, res));
+  EXPECT_NEAR(-0.5, getGoal(res), 1e-9);
+  EXPECT_FALSE(first->wasTerminated());
+  EXPECT_FALSE(shortest->wasTerminated());
+  EXPECT_FALSE(other->wasTerminated());
+}
+
+TEST_F(RacingPlannerManagerTest, NoSolutionReturnsFirstResult)
+{
+  addRacer("a", 0.05, 1.0, moveit_msgs::MoveItErrorCodes::PLANNING_FAILED);
+  addRacer("b", 0.01, 1.0, moveit_msgs::MoveItErrorCodes::INVALID_MOTION_PLAN);
+
+  for (int mode = RacingPlannerManager::FIRST_SOLUTION ; mode <= RacingPlannerManager::SHORTEST_SOLUTION ; ++mode)
+  {
+    planning_interface::MotionPlanResponse res;
+    EXPECT_FALSE(race((RacingPlannerManager::RacingMode)mode, 5.0, res));
+    EXPECT_EQ(moveit_msgs::MoveItErrorCodes::PLANNING_FAILED, res.error_code_.val);
+    EXPECT_FALSE(res.trajectory_);
+  }
+}
+
+TEST_F(RacingPlannerManagerTest, RacersPastTheDeadlineAreTerminated)
+{
+  StubPlanningContextPtr fast = addRacer("fast", 0.01, 1.0);
+  StubPlanningContextPtr slow = addRacer("slow", 10.0, 0.5);
+
+  // the slow racer would find the shorter solution, but not within the allowed planning time
+  ros::WallTime start = ros::WallTime::now();
+  planning_interface::MotionPlanResponse res;
+  ASSERT_TRUE(race(RacingPlannerManager::SHORTEST_SOLUTION, 0.2, res));
+  EXPECT_LT((ros::WallTime::now() - start).toSec(), 5.0);
+
+  EXPECT_NEAR(1.0, getGoal(res), 1e-9);
+  EXPECT_TRUE(slow->wasTerminated());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,169 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "time_optimal_parameterization.h"
+#include <moveit/planning_request_adapter/planning_request_adapter.h>
+#include <class_loader/class_loader.h>
+#include <ros/ros.h>
+#include <algorithm>
+#include <cmath>
+
+namespace default_planner_request_adapters
+{
+
+/** \brief Time-optimal parameterization of the computed path under velocity, acceleration and jerk limits, for any
+    number of joints. The path between waypoints is subdivided into a grid along which the fastest speed profile is
+    integrated forward and backward under the velocity and acceleration limits; that profile is then smoothed with a
+    moving average just wide enough to respect the jerk limits. Jerk limits are read from the joint_limits namespace,
+    as max_jerk. */
+class AddTimeOptimalParameterization : public planning_request_adapter::PlanningRequestAdapter
+{
+public:
+
+  static const std::string RESOLUTION_PARAM_NAME;
+  static const std::string VELOCITY_PARAM_NAME;
+  static const std::string ACCELERATION_PARAM_NAME;
+  static const std::string JERK_PARAM_NAME;
+  static const std::string ROBOT_DESCRIPTION;
+
+  AddTimeOptimalParameterization() : planning_request_adapter::PlanningRequestAdapter(), nh_("~")
+  {
+    path_resolution_ = readPositiveParam(RESOLUTION_PARAM_NAME, 0.01);
+    default_max_velocity_ = readPositiveParam(VELOCITY_PARAM_NAME, 1.0);
+    default_max_acceleration_ = readPositiveParam(ACCELERATION_PARAM_NAME, 1.0);
+    default_max_jerk_ = readPositiveParam(JERK_PARAM_NAME, 10.0);
+
+    // joint limits are read from the same namespace robot_model_loader::RobotModelLoader reads them from
+    std::string robot_description;
+    if (!nh_.searchParam(ROBOT_DESCRIPTION, robot_description))
+      robot_description = ROBOT_DESCRIPTION;
+    joint_limits_param_prefix_ = robot_description + "_planning/joint_limits/";
+  }
+
+  virtual std::string getDescription() const { return "Add Time Optimal Parameterization"; }
+
+  virtual bool adaptAndPlan(const PlannerFn &planner,
+                            const planning_scene::PlanningSceneConstPtr& planning_scene,
+                            const planning_interface::MotionPlanRequest &req,
+                            planning_interface::MotionPlanResponse &res,
+                            std::vector<std::size_t> &added_path_index) const
+  {
+    bool result = planner(planning_scene, req, res);
+    if (result && res.trajectory_)
+    {
+      ROS_DEBUG("Running '%s'", getDescription().c_str());
+      if (!computeTimeStamps(*res.trajectory_))
+        ROS_WARN("Time optimal parametrization for the solution path failed.");
+    }
+
+    return result;
+  }
+
+private:
+
+  double readPositiveParam(const std::string &name, double default_value) const
+  {
+    double value;
+    if (!nh_.getParam(name, value))
+    {
+      value = default_value;
+      ROS_INFO_STREAM("Param '" << name << "' was not set. Using default value: " << value);
+    }
+    else if (value <= 0.0)
+    {
+      ROS_WARN_STREAM("Param '" << name << "' needs to be positive. Using default value: " << default_value);
+      value = default_value;
+    }
+    else
+      ROS_INFO_STREAM("Param '" << name << "' was set to " << value);
+    return value;
+  }
+
+  void getLimits(const robot_model::RobotModelConstPtr &model, const std::vector<std::string> &vars, JointLimits &limits) const
+  {
+    limits.max_velocity_.resize(vars.size(), default_max_velocity_);
+    limits.max_acceleration_.resize(vars.size(), default_max_acceleration_);
+    limits.max_jerk_.resize(vars.size(), default_max_jerk_);
+    for (std::size_t j = 0 ; j < vars.size() ; ++j)
+    {
+      const robot_model::VariableBounds &b = model->getVariableBounds(vars[j]);
+      if (b.velocity_bounded_)
+      {
+        double v = std::min(fabs(b.max_velocity_), fabs(b.min_velocity_));
+        if (v > 0.0)
+          limits.max_velocity_[j] = v;
+      }
+      if (b.acceleration_bounded_)
+      {
+        double a = std::min(fabs(b.max_acceleration_), fabs(b.min_acceleration_));
+        if (a > 0.0)
+          limits.max_acceleration_[j] = a;
+      }
+      double jerk;
+      if (nh_.getParamCached(joint_limits_param_prefix_ + vars[j] + "/max_jerk", jerk) && jerk > 0.0)
+        limits.max_jerk_[j] = jerk;
+    }
+  }
+
+  bool computeTimeStamps(robot_trajectory::RobotTrajectory &trajectory) const
+  {
+    const robot_model::JointModelGroup *jmg = trajectory.getGroup();
+    if (!jmg)
+    {
+      ROS_ERROR("It looks like the planner did not set the group the plan was computed for");
+      return false;
+    }
+    JointLimits limits;
+    getLimits(trajectory.getRobotModel(), jmg->getVariableNames(), limits);
+    return computeTimeOptimalTimeStamps(trajectory, limits, path_resolution_);
+  }
+
+  ros::NodeHandle nh_;
+  double path_resolution_;
+  double default_max_velocity_;
+  double default_max_acceleration_;
+  double default_max_jerk_;
+  std::string joint_limits_param_prefix_;
+};
+
+const std::string AddTimeOptimalParameterization::RESOLUTION_PARAM_NAME = "time_parameterization_resolution";
+const std::string AddTimeOptimalParameterization::VELOCITY_PARAM_NAME = "default_max_velocity";
+const std::string AddTimeOptimalParameterization::ACCELERATION_PARAM_NAME = "default_max_acceleration";
+const std::string AddTimeOptimalParameterization::JERK_PARAM_NAME = "default_max_jerk";
+const std::string AddTimeOptimalParameterization::ROBOT_DESCRIPTION = "robot_description";
+
+}
+
+CLASS_LOADER_REGISTER_CLASS(default_planner_request_adapters::AddTimeOptimalParameterization,
+                            planning_request_adapter::PlanningRequestAdapter);
@@ -39,17 +39,75 @@
 #include <moveit/trajectory_processing/trajectory_tools.h>
 #include <class_loader/class_loader.h>
 #include <ros/ros.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <Eigen/Dense>
+#include <map>
 
 namespace default_planner_request_adapters
 {
 
+namespace
+{
+// the number of candidate states each thread evaluates in one round of the repair
+static const unsigned int CANDIDATES_PER_THREAD = 4;
+
+// links in contact are pushed by this multiple of the penetration depth, plus a clearance (in meters)
+static const double PUSH_DEPTH_FACTOR = 1.5;
+static const double PUSH_CLEARANCE = 0.005;
+
+// damping used when mapping the push of a link to joint space
+static const double PUSH_DAMPING = 0.01;
+
+// when a round makes no progress, the jiggle distance is doubled, up to this multiple of the jiggle fraction
+static const double MAX_JIGGLE_GROWTH = 8.0;
+
+struct CandidateEvaluation
+{
+  const planning_scene::PlanningScene *scene_;
+  const collision_detection::CollisionRequest *request_;
+  const std::vector<robot_state::RobotStatePtr> *candidates_;
+
+  boost::mutex lock_;
+  std::size_t next_candidate_;
+  std::vector<collision_detection::CollisionResult> results_;
+};
+
+void evaluateCandidates(CandidateEvaluation *data)
+{
+  while (true)
+  {
+    std::size_t i;
+    {
+      boost::mutex::scoped_lock slock(data->lock_);
+      i = data->next_candidate_++;
+    }
+    if (i >= data->candidates_->size())
+      break;
+    const robot_state::RobotState &candidate = *(*data->candidates_)[i];
+    data->scene_->checkCollision(*data->request_, data->results_[i], candidate);
+  }
+}
+
+double getPenetrationDepth(const collision_detection::CollisionResult &res)
+{
+  double depth = 0.0;
+  for (collision_detection::CollisionResult::ContactMap::const_iterator it = res.contacts.begin() ; it != res.contacts.end() ; ++it)
+    for (std::size_t i = 0 ; i < it->second.size() ; ++i)
+      depth += fabs(it->second[i].depth);
+  return depth;
+}
+
+}
+
 class FixStartStateCollision : public planning_request_adapter::PlanningRequestAdapter
 {
 public:
 
   static const std::string DT_PARAM_NAME;
   static const std::string JIGGLE_PARAM_NAME;
-  static const std::string ATTEMPTS_PARAM_NAME;
+  static const std::string TIMEOUT_PARAM_NAME;
+  static const std::string THREADS_PARAM_NAME;
 
   FixStartStateCollision() : planning_request_adapter::PlanningRequestAdapter(), nh_("~")
   {
@@ -69,21 +127,28 @@ public:
     else
       ROS_INFO_STREAM("Param '" << JIGGLE_PARAM_NAME << "' was set to " << jiggle_fraction_);
 
-    if (!nh_.getParam(ATTEMPTS_PARAM_NAME, sampling_attempts_))
+    if (!nh_.getParam(TIMEOUT_PARAM_NAME, repair_timeout_))
     {
-      sampling_attempts_ = 100;
-      ROS_INFO_STREAM("Param '" << ATTEMPTS_PARAM_NAME << "' was not set. Using default value: " << sampling_attempts_);
+      repair_timeout_ = 0.05;
+      ROS_INFO_STREAM("Param '" << TIMEOUT_PARAM_NAME << "' was not set. Using default value: " << repair_timeout_);
     }
     else
-    {
-      if (sampling_attempts_ < 1)
+      if (repair_timeout_ <= 0.0)
       {
-        sampling_attempts_ = 1;
-        ROS_WARN_STREAM("Param '" << ATTEMPTS_PARAM_NAME << "' needs to be at least 1.");
+        repair_timeout_ = 0.05;
+        ROS_WARN_STREAM("Param '" << TIMEOUT_PARAM_NAME << "' needs to be positive. Using default value: " << repair_timeout_);
       }
-      ROS_INFO_STREAM("Param '" << ATTEMPTS_PARAM_NAME << "' was set to " << sampling_attempts_);
-    }
+      else
+        ROS_INFO_STREAM("Param '" << TIMEOUT_PARAM_NAME << "' was set to " << repair_timeout_);
 
+    int num_threads = 0;
+    if (!nh_.getParam(THREADS_PARAM_NAME, num_threads))
+      ROS_INFO_STREAM("Param '" << THREADS_PARAM_NAME << "' was not set. Using the number of hardware threads");
+    else
+      ROS_INFO_STREAM("Param '" << THREADS_PARAM_NAME << "' was set to " << num_threads);
+    num_threads_ = num_threads > 0 ? num_threads : boost::thread::hardware_concurrency();
+    if (num_threads_ < 1)
+      num_threads_ = 1;
   }
 
   virtual std::string getDescription() const { return "Fix Start State In Collision"; }
@@ -118,33 +183,7 @@ public:
         ROS_INFO_STREAM("Start state appears to be in collision with respect to group " << creq.group_name);
 
       robot_state::RobotStatePtr prefix_state(new robot_state::RobotState(start_state));
-      random_numbers::RandomNumberGenerator &rng = prefix_state->getRandomNumberGenerator();
-      
-      const std::vector<const robot_model::JointModel*> &jmodels =
-        planning_scene->getRobotModel()->hasJointModelGroup(req.group_name) ?
-        planning_scene->getRobotModel()->getJointModelGroup(req.group_name)->getJointModels() :
-        planning_scene->getRobotModel()->getJointModels();
-      
-      bool found = false;
-      for (int c = 0 ; !found && c < sampling_attempts_ ; ++c)
-      {
-        for (std::size_t i = 0 ; !found && i < jmodels.size() ; ++i)
-        {
-          std::vector<double> sampled_variable_values(jmodels[i]->getVariableCount());
-          const double *original_values = prefix_state->getJointPositions(jmodels[i]);
-          jmodels[i]->getVariableRandomPositionsNearBy(rng, &sampled_variable_values[0], original_values, jmodels[i]->getMaximumExtent() * jiggle_fraction_);
-          start_state.setJointPositions(jmodels[i], sampled_variable_values);
-          collision_detection::CollisionResult cres;
-          planning_scene->checkCollision(creq, cres, start_state);
-          if (!cres.collision)
-          {
-            found = true;
-            ROS_INFO("Found a valid state near the start state at distance %lf after %d attempts", prefix_state->distance(start_state), c);
-          }
-        }
-      }
-
-      if (found)
+      if (repairStartState(*planning_scene, creq, *prefix_state, start_state))
       {
         planning_interface::MotionPlanRequest req2 = req;
         robot_state::robotStateToRobotStateMsg(start_state, req2.start_state);
@@ -163,8 +202,8 @@ public:
       }
       else
       {
-        ROS_WARN("Unable to find a valid state nearby the start state (using jiggle fraction of %lf and %u sampling attempts). Passing the original planning request to the planner.",
-                 jiggle_fraction_, sampling_attempts_);
+        ROS_WARN("Unable to find a valid state nearby the start state (using jiggle fraction of %lf and a time budget of %lf s). Passing the original planning request to the planner.",
+                 jiggle_fraction_, repair_timeout_);
         return planner(planning_scene, req, res);
       }
     }
@@ -180,15 +219,228 @@ public:
 
 private:
 
+  /** \brief Search for a collision free state near \e original within the time budget. Every round evaluates a set
+      of candidates in parallel: states that push the links in contact out along the contact normals by the penetration
+      depth, and random states near the current one. The closest collision free candidate is the result; otherwise the
+      search continues from the candidate with the least penetration, if it improves on the current state. */
+  bool repairStartState(const planning_scene::PlanningScene &scene, const collision_detection::CollisionRequest &creq,
+                        const robot_state::RobotState &original, robot_state::RobotState &repaired) const
+  {
+    const robot_model::RobotModelConstPtr &model = scene.getRobotModel();
+    const robot_model::JointModelGroup *jmg = model->hasJointModelGroup(creq.group_name) ? model->getJointModelGroup(creq.group_name) : NULL;
+    const std::vector<const robot_model::JointModel*> &jmodels = jmg ? jmg->getJointModels() : model->getJointModels();
+    if (jmodels.empty())
+      return false;
+    random_numbers::RandomNumberGenerator rng;
+
+    collision_detection::CollisionRequest contact_req = creq;
+    contact_req.contacts = true;
+    contact_req.max_contacts = 10;
+    contact_req.max_contacts_per_pair = 1;
+
+    robot_state::RobotState current(original);
+    current.update();
+    collision_detection::CollisionResult current_res;
+    scene.checkCollision(contact_req, current_res, current);
+    double current_depth = getPenetrationDepth(current_res);
+
+    const std::size_t num_candidates = num_threads_ * CANDIDATES_PER_THREAD;
+    double jiggle = jiggle_fraction_;
+    ros::WallTime start = ros::WallTime::now();
+    ros::WallTime deadline = start + ros::WallDuration(repair_timeout_);
+    for (unsigned int round = 1 ; ros::WallTime::now() < deadline ; ++round)
+    {
+      std::vector<robot_state::RobotStatePtr> candidates;
+      candidates.reserve(num_candidates);
+
+      Eigen::VectorXd step;
+      if (jmg && jmg->isChain() && computePushStep(current, jmg, current_res, step))
+      {
+        // the entries of the step correspond to the variables of the active joints of the group, in order;
+        // mimic joints follow the joints they mimic
+        const std::vector<const robot_model::JointModel*> &active = jmg->getActiveJointModels();
+        for (double scale = 0.5 ; scale <= 2.0 ; scale *= 2.0)
+        {
+          robot_state::RobotStatePtr candidate(new robot_state::RobotState(current));
+          std::size_t col = 0;
+          for (std::size_t a = 0 ; a < active.size() ; ++a)
+          {
+            const double *positions = current.getJointPositions(active[a]);
+            std::vector<double> pushed(positions, positions + active[a]->getVariableCount());
+            for (std::size_t k = 0 ; k < pushed.size() ; ++k, ++col)
+              pushed[k] += scale * step(col);
+            candidate->setJointPositions(active[a], pushed);
+          }
+          candidate->enforceBounds(jmg);
+          candidate->update();
+          candidates.push_back(candidate);
+        }
+      }
+
+      // random candidates alternate between moving a single joint and moving all joints
+      while (candidates.size() < num_candidates)
+      {
+        robot_state::RobotStatePtr candidate(new robot_state::RobotState(current));
+        bool single = candidates.size() % 2 == 1;
+        std::size_t pick = rng.uniformInteger(0, jmodels.size() - 1);
+        for (std::size_t i = 0 ; i < jmodels.size() ; ++i)
+        {
+          if ((single && i != pick) || jmodels[i]->getVariableCount() == 0)
+            continue;
+          std::vector<double> sampled_variable_values(jmodels[i]->getVariableCount());
+          jmodels[i]->getVariableRandomPositionsNearBy(rng, &sampled_variable_values[0], current.getJointPositions(jmodels[i]),
+                                                       jmodels[i]->getMaximumExtent() * jiggle);
+          candidate->setJointPositions(jmodels[i], sampled_variable_values);
+        }
+        candidate->update();
+        candidates.push_back(candidate);
+      }
+
+      CandidateEvaluation data;
+      data.scene_ = &scene;
+      data.request_ = &contact_req;
+      data.candidates_ = &candidates;
+      data.next_candidate_ = 0;
+      data.results_.resize(candidates.size());
+      if (num_threads_ <= 1)
+        evaluateCandidates(&data);
+      else
+      {
+        boost::thread_group threads;
+        for (unsigned int i = 0 ; i < num_threads_ ; ++i)
+          threads.create_thread(boost::bind(&evaluateCandidates, &data));
+        threads.join_all();
+      }
+
+      int best_free = -1;
+      double best_distance = 0.0;
+      int best_colliding = -1;
+      double best_depth = current_depth;
+      for (std::size_t i = 0 ; i < candidates.size() ; ++i)
+        if (!data.results_[i].collision)
+        {
+          double d = original.distance(*candidates[i]);
+          if (best_free < 0 || d < best_distance)
+          {
+            best_free = i;
+            best_distance = d;
+          }
+        }
+        else
+        {
+          double depth = getPenetrationDepth(data.results_[i]);
+          if (depth < best_depth)
+          {
+            best_colliding = i;
+            best_depth = depth;
+          }
+        }
+
+      if (best_free >= 0)
+      {
+        repaired = *candidates[best_free];
+        ROS_INFO("Found a valid state near the start state at distance %lf after %u rounds (%lf s)", best_distance, round,
+                 (ros::WallTime::now() - start).toSec());
+        return true;
+      }
+
+      if (best_colliding >= 0)
+      {
+        current = *candidates[best_colliding];
+        current_res = data.results_[best_colliding];
+        current_depth = best_depth;
+        jiggle = jiggle_fraction_;
+      }
+      else
+        jiggle = std::min(2.0 * jiggle, MAX_JIGGLE_GROWTH * jiggle_fraction_);
+    }
+    return false;
+  }
+
+  /** \brief Compute the change of the values of the active joint variables of \e jmg that pushes the links in contact out
+      of collision, by mapping the penetration of each contact through the link's Jacobian at the contact point. \e step
+      has one entry per active variable, in the order of the active joints. */
+  bool computePushStep(const robot_state::RobotState &state, const robot_model::JointModelGroup *jmg,
+                       const collision_detection::CollisionResult &res, Eigen::VectorXd &step) const
+  {
+    const std::vector<const robot_model::JointModel*> &active = jmg->getActiveJointModels();
+    std::map<const robot_model::JointModel*, std::size_t> active_column;
+    std::size_t active_variable_count = 0;
+    for (std::size_t a = 0 ; a < active.size() ; ++a)
+    {
+      active_column[active[a]] = active_variable_count;
+      active_variable_count += active[a]->getVariableCount();
+    }
+
+    // the Jacobian has a column for every variable of the group; the columns of mimic joints are added to the columns of
+    // the joints they mimic, scaled by the mimic factor, as the KDL kinematics plugin does
+    std::vector<int> column(jmg->getVariableCount(), -1);
+    std::vector<double> column_factor(jmg->getVariableCount(), 1.0);
+    const std::vector<const robot_model::JointModel*> &joints = jmg->getJointModels();
+    for (std::size_t i = 0 ; i < joints.size() ; ++i)
+    {
+      const robot_model::JointModel *source = joints[i]->getMimic() ? joints[i]->getMimic() : joints[i];
+      std::map<const robot_model::JointModel*, std::size_t>::const_iterator it = active_column.find(source);
+      if (it == active_column.end())
+        continue;
+      const std::vector<std::string> &variables = joints[i]->getVariableNames();
+      for (std::size_t k = 0 ; k < variables.size() ; ++k)
+      {
+        int index = jmg->getVariableGroupIndex(variables[k]);
+        if (index < 0 || index >= (int)column.size())
+          continue;
+        column[index] = it->second + k;
+        column_factor[index] = joints[i]->getMimic() ? joints[i]->getMimicFactor() : 1.0;
+      }
+    }
+
+    // the Jacobian is expressed in the frame of the parent link of the first joint of the group, while contacts are
+    // reported in the planning frame
+    const robot_model::LinkModel *root_link = joints[0]->getParentLinkModel();
+    const Eigen::Matrix3d to_root = root_link ? Eigen::Matrix3d(state.getGlobalLinkTransform(root_link).rotation().transpose()) :
+      Eigen::Matrix3d::Identity();
+
+    step = Eigen::VectorXd::Zero(active_variable_count);
+    bool pushed = false;
+    for (collision_detection::CollisionResult::ContactMap::const_iterator it = res.contacts.begin() ; it != res.contacts.end() ; ++it)
+      for (std::size_t i = 0 ; i < it->second.size() ; ++i)
+      {
+        const collision_detection::Contact &c = it->second[i];
+        for (int body = 0 ; body < 2 ; ++body)
+        {
+          const std::string &name = body == 0 ? c.body_name_1 : c.body_name_2;
+          if ((body == 0 ? c.body_type_1 : c.body_type_2) != collision_detection::BodyTypes::ROBOT_LINK || !jmg->isLinkUpdated(name))
+            continue;
+          const robot_model::LinkModel *link = state.getLinkModel(name);
+          Eigen::MatrixXd jacobian;
+          if (!state.getJacobian(jmg, link, state.getGlobalLinkTransform(link).inverse() * c.pos, jacobian))
+            continue;
+          Eigen::MatrixXd jp = Eigen::MatrixXd::Zero(3, active_variable_count);
+          for (std::size_t v = 0 ; v < column.size() && v < (std::size_t)jacobian.cols() ; ++v)
+            if (column[v] >= 0)
+              jp.col(column[v]) += column_factor[v] * jacobian.block(0, v, 3, 1);
+
+          // the contact normal points from the first body to the second one
+          Eigen::Vector3d push = to_root * (body == 0 ? -c.normal : c.normal) * (fabs(c.depth) * PUSH_DEPTH_FACTOR + PUSH_CLEARANCE);
+          Eigen::Matrix3d jjt = jp * jp.transpose() + PUSH_DAMPING * PUSH_DAMPING * Eigen::Matrix3d::Identity();
+          step += jp.transpose() * jjt.ldlt().solve(push);
+          pushed = true;
+        }
+      }
+    return pushed;
+  }
+
   ros::NodeHandle nh_;
   double max_dt_offset_;
   double jiggle_fraction_;
-  int sampling_attempts_;
+  double repair_timeout_;
+  unsigned int num_threads_;
 };
 
 const std::string FixStartStateCollision::DT_PARAM_NAME = "start_state_max_dt";
 const std::string FixStartStateCollision::JIGGLE_PARAM_NAME = "jiggle_fraction";
-const std::string FixStartStateCollision::ATTEMPTS_PARAM_NAME = "max_sampling_attempts";
+const std::string FixStartStateCollision::TIMEOUT_PARAM_NAME = "start_state_repair_timeout";
+const std::string FixStartStateCollision::THREADS_PARAM_NAME = "start_state_repair_threads";
 
 }
 
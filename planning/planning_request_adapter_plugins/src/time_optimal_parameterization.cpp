@@ -0,0 +1,466 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include "time_optimal_parameterization.h"
+#include <ros/console.h>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace default_planner_request_adapters
+{
+
+namespace
+{
+// the maximum number of grid steps a single path segment is subdivided into
+static const unsigned int MAX_SEGMENT_SUBDIVISIONS = 100;
+
+// the number of bisection steps used to locate the grid points in time along the smoothed speed profile
+static const unsigned int SMOOTHING_BISECTION_STEPS = 60;
+
+// the maximum number of times the speed profile is recomputed with lower speed caps after smoothing
+static const unsigned int MAX_SMOOTHING_PASSES = 10;
+
+// relative tolerance when checking joint limits
+static const double LIMIT_TOLERANCE = 1e-3;
+
+/** \brief The path to be parameterized, as a grid of points along the piecewise linear interpolation of the waypoints.
+    Consecutive identical waypoints are represented once, so every segment has a non-zero length */
+struct PathGrid
+{
+  std::size_t num_vars_;
+
+  /** \brief The unit direction of each path segment (num_vars_ values per segment) */
+  std::vector<double> segment_direction_;
+
+  /** \brief The curvature of the path at each waypoint (num_vars_ values per waypoint), assuming corners are blended
+      over the adjacent segments, as the spline interpolation of trajectory controllers does */
+  std::vector<double> waypoint_curvature_;
+
+  /** \brief The path length of each grid step */
+  std::vector<double> step_length_;
+
+  /** \brief The segment each grid step lies on */
+  std::vector<std::size_t> step_segment_;
+
+  /** \brief The grid point each waypoint corresponds to */
+  std::vector<std::size_t> waypoint_node_;
+
+  /** \brief The waypoint each grid point corresponds to, or -1 for grid points inside segments */
+  std::vector<int> node_waypoint_;
+
+  std::size_t getNodeCount() const
+  {
+    return step_length_.size() + 1;
+  }
+
+  const double* getStepDirection(std::size_t step) const
+  {
+    return &segment_direction_[step_segment_[step] * num_vars_];
+  }
+
+  /** \brief The direction of motion at a grid point: the average of the directions of the adjacent grid steps */
+  void getNodeDirection(std::size_t node, std::vector<double> &dir) const
+  {
+    dir.assign(num_vars_, 0.0);
+    const double *dir_in = node > 0 ? getStepDirection(node - 1) : NULL;
+    const double *dir_out = node < step_length_.size() ? getStepDirection(node) : NULL;
+    for (std::size_t j = 0 ; j < num_vars_ ; ++j)
+      dir[j] = dir_in && dir_out ? (dir_in[j] + dir_out[j]) / 2.0 : (dir_in ? dir_in[j] : (dir_out ? dir_out[j] : 0.0));
+  }
+
+  const double* getNodeCurvature(std::size_t node) const
+  {
+    return node_waypoint_[node] >= 0 ? &waypoint_curvature_[node_waypoint_[node] * num_vars_] : NULL;
+  }
+};
+
+/** \brief The largest path acceleration allowed along grid step \e step when the path speed at grid point \e node is \e speed */
+double pathAccelerationLimit(const PathGrid &grid, const JointLimits &limits, std::size_t step, std::size_t node, double speed)
+{
+  const double *dir = grid.getStepDirection(step);
+  const double *curv = grid.getNodeCurvature(node);
+  double a = std::numeric_limits<double>::infinity();
+  for (std::size_t j = 0 ; j < grid.num_vars_ ; ++j)
+  {
+    if (fabs(dir[j]) <= std::numeric_limits<double>::epsilon())
+      continue;
+    double budget = limits.max_acceleration_[j] - (curv ? fabs(curv[j]) * speed * speed : 0.0);
+    if (budget <= 0.0)
+      return 0.0;
+    a = std::min(a, budget / fabs(dir[j]));
+  }
+  return a;
+}
+
+/** \brief The largest path jerk allowed along grid step \e step */
+double pathJerkLimit(const PathGrid &grid, const JointLimits &limits, std::size_t step)
+{
+  const double *dir = grid.getStepDirection(step);
+  double l = std::numeric_limits<double>::infinity();
+  for (std::size_t j = 0 ; j < grid.num_vars_ ; ++j)
+    if (fabs(dir[j]) > std::numeric_limits<double>::epsilon())
+      l = std::min(l, limits.max_jerk_[j] / fabs(dir[j]));
+  return l;
+}
+
+/** \brief The factor by which time needs to be stretched at grid point \e node for the joint velocities and
+    accelerations to be within limits, when moving along the path at \e speed with path acceleration \e acceleration */
+double limitStretch(const PathGrid &grid, const JointLimits &limits, std::size_t node, double speed, double acceleration)
+{
+  std::vector<double> dir;
+  grid.getNodeDirection(node, dir);
+  const double *curv = grid.getNodeCurvature(node);
+  double r = 1.0;
+  for (std::size_t j = 0 ; j < grid.num_vars_ ; ++j)
+  {
+    r = std::max(r, fabs(speed * dir[j]) / limits.max_velocity_[j]);
+    r = std::max(r, sqrt(fabs(acceleration * dir[j] + (curv ? curv[j] * speed * speed : 0.0)) / limits.max_acceleration_[j]));
+  }
+  return r;
+}
+
+/** \brief Compute the fastest path speed at every grid point that respects \e caps and the acceleration limits, by
+    integrating forward from the start of the path at maximum acceleration and backward from its end at maximum deceleration */
+void integrateSpeedProfile(const PathGrid &grid, const JointLimits &limits, const std::vector<double> &caps, std::vector<double> &speed)
+{
+  const std::size_t num_nodes = grid.getNodeCount();
+  speed.resize(num_nodes);
+  speed[0] = caps[0];
+  for (std::size_t p = 0 ; p + 1 < num_nodes ; ++p)
+  {
+    double a = pathAccelerationLimit(grid, limits, p, p, speed[p]);
+    speed[p + 1] = std::min(caps[p + 1], sqrt(speed[p] * speed[p] + 2.0 * grid.step_length_[p] * a));
+  }
+  for (std::size_t p = num_nodes - 1 ; p > 0 ; --p)
+  {
+    double a = pathAccelerationLimit(grid, limits, p - 1, p, speed[p]);
+    speed[p - 1] = std::min(speed[p - 1], sqrt(speed[p] * speed[p] + 2.0 * grid.step_length_[p - 1] * a));
+  }
+}
+
+/** \brief A path speed profile over time: the path position and speed at each grid point are reached at the
+    time of that grid point, and the path acceleration is constant along each grid step */
+struct SpeedProfile
+{
+  std::vector<double> time_;
+  std::vector<double> position_;
+  std::vector<double> speed_;
+  std::vector<double> acceleration_;
+
+  /** \brief The integral of the path position over time, up to each grid point */
+  std::vector<double> position_integral_;
+
+  double getDuration() const
+  {
+    return time_.back();
+  }
+
+  /** \brief Evaluate the path position \e s, speed \e v and the integral of the position \e S at time \e t. The path
+      is at rest at its start before the profile begins and at its end after the profile ends */
+  void evaluate(double t, double &s, double &v, double &S) const
+  {
+    if (t <= 0.0)
+    {
+      s = v = S = 0.0;
+      return;
+    }
+    if (t >= getDuration())
+    {
+      s = position_.back();
+      v = 0.0;
+      S = position_integral_.back() + s * (t - getDuration());
+      return;
+    }
+    std::size_t k = std::upper_bound(time_.begin(), time_.end(), t) - time_.begin() - 1;
+    double tau = t - time_[k];
+    s = position_[k] + (speed_[k] + acceleration_[k] * tau / 2.0) * tau;
+    v = speed_[k] + acceleration_[k] * tau;
+    S = position_integral_[k] + (position_[k] + (speed_[k] / 2.0 + acceleration_[k] * tau / 6.0) * tau) * tau;
+  }
+};
+
+/** \brief Build the timing of the speed profile. Returns false if the speed profile stalls along the path */
+bool computeSpeedProfile(const PathGrid &grid, const std::vector<double> &speed, SpeedProfile &profile)
+{
+  const std::size_t num_nodes = grid.getNodeCount();
+  profile.time_.resize(num_nodes);
+  profile.position_.resize(num_nodes);
+  profile.position_integral_.resize(num_nodes);
+  profile.speed_ = speed;
+  profile.acceleration_.resize(num_nodes, 0.0);
+  profile.time_[0] = profile.position_[0] = profile.position_integral_[0] = 0.0;
+  for (std::size_t p = 0 ; p + 1 < num_nodes ; ++p)
+  {
+    const double l = grid.step_length_[p];
+    double dt = 0.0;
+    profile.acceleration_[p] = 0.0;
+    if (l > std::numeric_limits<double>::epsilon())
+    {
+      const double v = speed[p] + speed[p + 1];
+      if (v <= std::numeric_limits<double>::epsilon())
+        return false;
+      dt = 2.0 * l / v;
+      profile.acceleration_[p] = (speed[p + 1] - speed[p]) / dt;
+    }
+    profile.time_[p + 1] = profile.time_[p] + dt;
+    profile.position_[p + 1] = profile.position_[p] + l;
+    profile.position_integral_[p + 1] = profile.position_integral_[p] +
+      (profile.position_[p] + (speed[p] / 2.0 + profile.acceleration_[p] * dt / 6.0) * dt) * dt;
+  }
+  return true;
+}
+
+/** \brief Smooth the speed profile with a moving average over a time window of length \e window. This bounds the path
+    jerk by the change in path acceleration over the window divided by \e window, keeps the speed and acceleration
+    within the range of the original profile and makes the trajectory last \e window longer. For every grid point,
+    compute the time it is reached at and the path speed and acceleration at that time */
+void smoothSpeedProfile(const SpeedProfile &profile, double window, std::vector<double> &time,
+                        std::vector<double> &speed, std::vector<double> &acceleration)
+{
+  const std::size_t num_nodes = profile.time_.size();
+  const double h = window / 2.0;
+  time.resize(num_nodes);
+  speed.resize(num_nodes);
+  acceleration.resize(num_nodes);
+  for (std::size_t p = 0 ; p < num_nodes ; ++p)
+  {
+    // the smoothed position at time t is the average of the original one over [t - h, t + h]; it only increases
+    // with time, so the time the grid point is reached at can be found by bisection
+    double lo = -h;
+    double hi = profile.getDuration() + h;
+    if (p == 0)
+      hi = lo;
+    else if (p + 1 == num_nodes)
+      lo = hi;
+    for (unsigned int b = 0 ; b < SMOOTHING_BISECTION_STEPS && lo < hi ; ++b)
+    {
+      double t = (lo + hi) / 2.0;
+      double s0, v0, S0, s1, v1, S1;
+      profile.evaluate(t - h, s0, v0, S0);
+      profile.evaluate(t + h, s1, v1, S1);
+      if ((S1 - S0) / window < profile.position_[p])
+        lo = t;
+      else
+        hi = t;
+    }
+    double t = (lo + hi) / 2.0;
+    double s0, v0, S0, s1, v1, S1;
+    profile.evaluate(t - h, s0, v0, S0);
+    profile.evaluate(t + h, s1, v1, S1);
+    time[p] = t + h;
+    speed[p] = (s1 - s0) / window;
+    acceleration[p] = (v1 - v0) / window;
+  }
+}
+
+}
+
+bool computeTimeOptimalTimeStamps(robot_trajectory::RobotTrajectory &trajectory, const JointLimits &limits, double path_resolution)
+{
+  const robot_model::JointModelGroup *jmg = trajectory.getGroup();
+  if (!jmg)
+    return false;
+  const std::size_t num_points = trajectory.getWayPointCount();
+  if (num_points == 0)
+    return true;
+
+  const std::vector<int> &idx = jmg->getVariableIndexList();
+  const std::size_t num_vars = idx.size();
+
+  // consecutive identical waypoints would make zero-length segments, along which the path speed is undefined;
+  // they are merged into a single point of the path, which all of them reach at the same time
+  std::vector<std::size_t> path_points(1, 0);
+  std::vector<std::size_t> waypoint_path_point(num_points, 0);
+  std::vector<double> segment_direction;
+  std::vector<double> segment_length;
+  std::vector<double> dir(num_vars);
+  for (std::size_t i = 1 ; i < num_points ; ++i)
+  {
+    const robot_state::RobotState &prev = trajectory.getWayPoint(path_points.back());
+    const robot_state::RobotState &curr = trajectory.getWayPoint(i);
+    double l = 0.0;
+    for (std::size_t j = 0 ; j < num_vars ; ++j)
+    {
+      dir[j] = curr.getVariablePosition(idx[j]) - prev.getVariablePosition(idx[j]);
+      l += dir[j] * dir[j];
+    }
+    l = sqrt(l);
+    if (l > std::numeric_limits<double>::epsilon())
+    {
+      for (std::size_t j = 0 ; j < num_vars ; ++j)
+        segment_direction.push_back(dir[j] / l);
+      segment_length.push_back(l);
+      path_points.push_back(i);
+    }
+    waypoint_path_point[i] = path_points.size() - 1;
+  }
+  const std::size_t num_path_points = path_points.size();
+
+  // a path that does not move is traversed instantly
+  if (num_path_points == 1)
+  {
+    for (std::size_t i = 0 ; i < num_points ; ++i)
+    {
+      trajectory.setWayPointDurationFromPrevious(i, 0.0);
+      robot_state::RobotStatePtr state = trajectory.getWayPointPtr(i);
+      for (std::size_t j = 0 ; j < num_vars ; ++j)
+      {
+        state->setVariableVelocity(idx[j], 0.0);
+        state->setVariableAcceleration(idx[j], 0.0);
+      }
+    }
+    return true;
+  }
+
+  // build the grid: the segments between consecutive path points, subdivided at the path resolution
+  PathGrid grid;
+  grid.num_vars_ = num_vars;
+  grid.segment_direction_.swap(segment_direction);
+  grid.waypoint_curvature_.resize(num_path_points * num_vars, 0.0);
+  grid.waypoint_node_.resize(num_path_points, 0);
+  for (std::size_t k = 0 ; k + 1 < num_path_points ; ++k)
+  {
+    const double l = segment_length[k];
+    unsigned int n = std::min(MAX_SEGMENT_SUBDIVISIONS, std::max(1u, (unsigned int)ceil(l / path_resolution)));
+    for (unsigned int s = 0 ; s < n ; ++s)
+    {
+      grid.step_length_.push_back(l / n);
+      grid.step_segment_.push_back(k);
+    }
+    grid.waypoint_node_[k + 1] = grid.step_length_.size();
+  }
+  for (std::size_t i = 1 ; i + 1 < num_path_points ; ++i)
+  {
+    double blend = (segment_length[i - 1] + segment_length[i]) / 2.0;
+    for (std::size_t j = 0 ; j < num_vars ; ++j)
+      grid.waypoint_curvature_[i * num_vars + j] = (grid.segment_direction_[i * num_vars + j] - grid.segment_direction_[(i - 1) * num_vars + j]) / blend;
+  }
+  const std::size_t num_nodes = grid.getNodeCount();
+  grid.node_waypoint_.resize(num_nodes, -1);
+  for (std::size_t i = 0 ; i < num_path_points ; ++i)
+    grid.node_waypoint_[grid.waypoint_node_[i]] = i;
+
+  // the path speed at every grid point is capped by the joint velocity limits and, at corners, by the acceleration
+  // needed to change direction; the trajectory starts and ends at rest
+  std::vector<double> caps(num_nodes, std::numeric_limits<double>::infinity());
+  caps[0] = caps[num_nodes - 1] = 0.0;
+  for (std::size_t p = 1 ; p + 1 < num_nodes ; ++p)
+  {
+    for (std::size_t s = p - 1 ; s <= p ; ++s)
+    {
+      const double *dir = grid.getStepDirection(s);
+      for (std::size_t j = 0 ; j < num_vars ; ++j)
+        if (fabs(dir[j]) > std::numeric_limits<double>::epsilon())
+          caps[p] = std::min(caps[p], limits.max_velocity_[j] / fabs(dir[j]));
+    }
+    if (const double *curv = grid.getNodeCurvature(p))
+      for (std::size_t j = 0 ; j < num_vars ; ++j)
+        if (fabs(curv[j]) > std::numeric_limits<double>::epsilon())
+          caps[p] = std::min(caps[p], sqrt(limits.max_acceleration_[j] / fabs(curv[j])));
+  }
+
+  // the fastest speed profile under the velocity and acceleration limits is smoothed to respect the jerk limits;
+  // smoothing raises the speed where the profile is slowest, such as at corners, so wherever the limits end up
+  // exceeded the speed is capped further and the profile recomputed
+  SpeedProfile profile;
+  std::vector<double> speed, time, smooth_speed, acceleration;
+  for (unsigned int pass = 0 ; ; ++pass)
+  {
+    integrateSpeedProfile(grid, limits, caps, speed);
+    if (!computeSpeedProfile(grid, speed, profile))
+      return false;
+    double window = 0.0;
+    for (std::size_t p = 0 ; p + 1 < num_nodes ; ++p)
+      window = std::max(window, 2.0 * fabs(profile.acceleration_[p]) / pathJerkLimit(grid, limits, p));
+    if (window > 0.0)
+      smoothSpeedProfile(profile, window, time, smooth_speed, acceleration);
+    else
+    {
+      time = profile.time_;
+      smooth_speed = speed;
+      acceleration.assign(num_nodes, 0.0);
+    }
+    if (pass + 1 >= MAX_SMOOTHING_PASSES)
+      break;
+    bool changed = false;
+    for (std::size_t p = 1 ; p + 1 < num_nodes ; ++p)
+    {
+      double r = limitStretch(grid, limits, p, smooth_speed[p], acceleration[p]);
+      if (r > 1.0 + LIMIT_TOLERANCE)
+      {
+        caps[p] = std::min(caps[p], speed[p] / r);
+        changed = true;
+      }
+    }
+    if (!changed)
+      break;
+  }
+
+  // if the limits are still exceeded, slow down the whole trajectory; stretching time by a factor f scales the
+  // velocities by 1/f, the accelerations by 1/f^2 and the jerks by 1/f^3
+  double time_scale = 1.0;
+  for (std::size_t p = 0 ; p < num_nodes ; ++p)
+  {
+    time_scale = std::max(time_scale, limitStretch(grid, limits, p, smooth_speed[p], acceleration[p]));
+    if (p + 1 < num_nodes && time[p + 1] - time[p] > std::numeric_limits<double>::epsilon())
+      time_scale = std::max(time_scale, cbrt(fabs(acceleration[p + 1] - acceleration[p]) / (time[p + 1] - time[p]) /
+                                             pathJerkLimit(grid, limits, p)));
+  }
+  if (time_scale > 1.0 + LIMIT_TOLERANCE)
+    ROS_DEBUG("Slowing down trajectory by a factor of %lf to satisfy joint limits", time_scale);
+
+  // store the timing, velocities and accelerations in the trajectory
+  for (std::size_t i = 0 ; i < num_points ; ++i)
+  {
+    const std::size_t p = grid.waypoint_node_[waypoint_path_point[i]];
+    trajectory.setWayPointDurationFromPrevious(i, i > 0 ? (time[p] - time[grid.waypoint_node_[waypoint_path_point[i - 1]]]) * time_scale : 0.0);
+
+    std::vector<double> dir;
+    grid.getNodeDirection(p, dir);
+    const double *curv = grid.getNodeCurvature(p);
+    const double v = smooth_speed[p] / time_scale;
+    const double a = acceleration[p] / (time_scale * time_scale);
+    robot_state::RobotStatePtr state = trajectory.getWayPointPtr(i);
+    for (std::size_t j = 0 ; j < num_vars ; ++j)
+    {
+      state->setVariableVelocity(idx[j], v * dir[j]);
+      state->setVariableAcceleration(idx[j], a * dir[j] + (curv ? curv[j] * v * v : 0.0));
+    }
+  }
+
+  return true;
+}
+
+}
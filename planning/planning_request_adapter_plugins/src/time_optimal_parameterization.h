@@ -0,0 +1,60 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_DEFAULT_PLANNER_REQUEST_ADAPTERS_TIME_OPTIMAL_PARAMETERIZATION_
+#define MOVEIT_DEFAULT_PLANNER_REQUEST_ADAPTERS_TIME_OPTIMAL_PARAMETERIZATION_
+
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <vector>
+
+namespace default_planner_request_adapters
+{
+
+/** \brief The limits of the variables of a group, in the order of JointModelGroup::getVariableNames() */
+struct JointLimits
+{
+  std::vector<double> max_velocity_;
+  std::vector<double> max_acceleration_;
+  std::vector<double> max_jerk_;
+};
+
+/** \brief Compute the timing, velocities and accelerations of the waypoints of \e trajectory for the fastest motion
+    along its path that respects \e limits. The path between waypoints is subdivided into grid steps no longer than
+    \e path_resolution. Consecutive identical waypoints are reached at the same time. Returns false if the trajectory
+    has no group or cannot be parameterized */
+bool computeTimeOptimalTimeStamps(robot_trajectory::RobotTrajectory &trajectory, const JointLimits &limits, double path_resolution);
+
+}
+
+#endif
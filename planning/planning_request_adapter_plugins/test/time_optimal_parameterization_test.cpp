@@ -0,0 +1,168 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include "../src/time_optimal_parameterization.h"
+#include <urdf_parser/urdf_parser.h>
+#include <cmath>
+
+static const char *URDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"two_link_arm\">"
+  "<link name=\"base_link\"/>"
+  "<joint name=\"joint_1\" type=\"revolute\">"
+  "  <axis xyz=\"0 0 1\"/>"
+  "  <limit effort=\"10.0\" lower=\"-3.0\" upper=\"3.0\" velocity=\"1.0\"/>"
+  "  <parent link=\"base_link\"/>"
+  "  <child link=\"link_1\"/>"
+  "  <origin rpy=\"0 0 0\" xyz=\"0 0 0.1\"/>"
+  "</joint>"
+  "<link name=\"link_1\"/>"
+  "<joint name=\"joint_2\" type=\"revolute\">"
+  "  <axis xyz=\"0 0 1\"/>"
+  "  <limit effort=\"10.0\" lower=\"-3.0\" upper=\"3.0\" velocity=\"1.0\"/>"
+  "  <parent link=\"link_1\"/>"
+  "  <child link=\"link_2\"/>"
+  "  <origin rpy=\"0 0 0\" xyz=\"0.5 0 0\"/>"
+  "</joint>"
+  "<link name=\"link_2\"/>"
+  "</robot>";
+
+static const char *SRDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"two_link_arm\">"
+  "<group name=\"arm\">"
+  "<joint name=\"joint_1\"/>"
+  "<joint name=\"joint_2\"/>"
+  "</group>"
+  "</robot>";
+
+static robot_model::RobotModelPtr getModel()
+{
+  static robot_model::RobotModelPtr model;
+  if (!model)
+  {
+    boost::shared_ptr<urdf::ModelInterface> urdf(urdf::parseURDF(URDF_STR));
+    boost::shared_ptr<srdf::Model> srdf(new srdf::Model());
+    srdf->initString(*urdf, SRDF_STR);
+    model.reset(new robot_model::RobotModel(urdf, srdf));
+  }
+  return model;
+}
+
+static default_planner_request_adapters::JointLimits getLimits()
+{
+  default_planner_request_adapters::JointLimits limits;
+  limits.max_velocity_.assign(2, 1.0);
+  limits.max_acceleration_.assign(2, 2.0);
+  limits.max_jerk_.assign(2, 10.0);
+  return limits;
+}
+
+// a trajectory through the given (joint_1, joint_2) positions, without timing
+static robot_trajectory::RobotTrajectoryPtr makeTrajectory(const double positions[][2], std::size_t count)
+{
+  robot_trajectory::RobotTrajectoryPtr trajectory(new robot_trajectory::RobotTrajectory(getModel(), "arm"));
+  for (std::size_t i = 0 ; i < count ; ++i)
+  {
+    robot_state::RobotStatePtr state(new robot_state::RobotState(getModel()));
+    state->setToDefaultValues();
+    state->setVariablePosition("joint_1", positions[i][0]);
+    state->setVariablePosition("joint_2", positions[i][1]);
+    state->update();
+    trajectory->addSuffixWayPoint(state, 0.0);
+  }
+  return trajectory;
+}
+
+static void expectFinite(const robot_trajectory::RobotTrajectory &trajectory)
+{
+  for (std::size_t i = 0 ; i < trajectory.getWayPointCount() ; ++i)
+  {
+    EXPECT_TRUE(std::isfinite(trajectory.getWayPointDurationFromPrevious(i)));
+    EXPECT_GE(trajectory.getWayPointDurationFromPrevious(i), 0.0);
+    const robot_state::RobotState &state = trajectory.getWayPoint(i);
+    for (std::size_t j = 0 ; j < 2 ; ++j)
+    {
+      EXPECT_TRUE(std::isfinite(state.getVariableVelocity(j)));
+      EXPECT_TRUE(std::isfinite(state.getVariableAcceleration(j)));
+    }
+  }
+}
+
+TEST(TimeOptimalParameterization, DuplicateWaypointsAreReachedTogether)
+{
+  const double positions[][2] = { { 0.0, 0.0 }, { 0.0, 0.0 }, { 0.0, 0.0 }, { 0.5, 0.2 }, { 0.5, 0.2 }, { 0.5, 0.2 },
+                                   { 1.0, -0.3 }, { 1.0, -0.3 }, { 1.0, -0.3 } };
+  const double distinct[][2] = { { 0.0, 0.0 }, { 0.5, 0.2 }, { 1.0, -0.3 } };
+  robot_trajectory::RobotTrajectoryPtr trajectory = makeTrajectory(positions, 9);
+  robot_trajectory::RobotTrajectoryPtr reference = makeTrajectory(distinct, 3);
+  ASSERT_TRUE(default_planner_request_adapters::computeTimeOptimalTimeStamps(*trajectory, getLimits(), 0.01));
+  ASSERT_TRUE(default_planner_request_adapters::computeTimeOptimalTimeStamps(*reference, getLimits(), 0.01));
+  expectFinite(*trajectory);
+
+  // repeated waypoints take no time and move at the velocity of the waypoint they repeat
+  for (std::size_t i = 0 ; i < 9 ; ++i)
+  {
+    const std::size_t k = i / 3;
+    if (i % 3 == 0)
+      EXPECT_NEAR(reference->getWayPointDurationFromPrevious(k), trajectory->getWayPointDurationFromPrevious(i), 1e-9);
+    else
+      EXPECT_EQ(0.0, trajectory->getWayPointDurationFromPrevious(i));
+    for (std::size_t j = 0 ; j < 2 ; ++j)
+      EXPECT_NEAR(reference->getWayPoint(k).getVariableVelocity(j), trajectory->getWayPoint(i).getVariableVelocity(j), 1e-9);
+  }
+  EXPECT_GT(trajectory->getWayPointDurationFromPrevious(3), 0.0);
+  EXPECT_GT(trajectory->getWayPointDurationFromPrevious(6), 0.0);
+}
+
+TEST(TimeOptimalParameterization, PathWithoutMotionTakesNoTime)
+{
+  const double positions[][2] = { { 0.3, 0.1 }, { 0.3, 0.1 }, { 0.3, 0.1 } };
+  robot_trajectory::RobotTrajectoryPtr trajectory = makeTrajectory(positions, 3);
+  ASSERT_TRUE(default_planner_request_adapters::computeTimeOptimalTimeStamps(*trajectory, getLimits(), 0.01));
+  expectFinite(*trajectory);
+  for (std::size_t i = 0 ; i < 3 ; ++i)
+  {
+    EXPECT_EQ(0.0, trajectory->getWayPointDurationFromPrevious(i));
+    EXPECT_EQ(0.0, trajectory->getWayPoint(i).getVariableVelocity(0));
+    EXPECT_EQ(0.0, trajectory->getWayPoint(i).getVariableVelocity(1));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
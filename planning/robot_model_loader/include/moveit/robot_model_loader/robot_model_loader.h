@@ -40,6 +40,7 @@
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/rdf_loader/rdf_loader.h>
 #include <moveit/kinematics_plugin_loader/kinematics_plugin_loader.h>
+#include <XmlRpcValue.h>
 
 namespace robot_model_loader
 {
@@ -152,5 +153,11 @@ private:
 typedef boost::shared_ptr<RobotModelLoader> RobotModelLoaderPtr;
 typedef boost::shared_ptr<const RobotModelLoader> RobotModelLoaderConstPtr;
 
+/** @brief Override the variable bounds of the joints of \e model with \e joint_limits, a struct of the form of the
+    <robot_description>_planning/joint_limits parameter: for each variable, a struct with any of max_position,
+    min_position, max_velocity, has_velocity_limits, max_acceleration and has_acceleration_limits. The limits of the
+    variables of a multi-DOF joint are nested under the name of the joint (e.g., the limits of base/x are at base: x:). */
+void applyJointLimits(XmlRpc::XmlRpcValue &joint_limits, const robot_model::RobotModelPtr &model);
+
 }
 #endif
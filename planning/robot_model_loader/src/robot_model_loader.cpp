@@ -77,6 +77,115 @@ bool canSpecifyPosition(const robot_model::JointModel *jmodel, const unsigned in
     ok = true;
   return ok;
 }
+
+// read a number from an entry of the joint limits; integers are accepted too, as ros::param does
+bool getLimit(XmlRpc::XmlRpcValue &limits, const char *name, double &value)
+{
+  if (!limits.hasMember(name))
+    return false;
+  XmlRpc::XmlRpcValue &v = limits[name];
+  if (v.getType() == XmlRpc::XmlRpcValue::TypeDouble)
+    value = static_cast<double>(v);
+  else
+    if (v.getType() == XmlRpc::XmlRpcValue::TypeInt)
+      value = static_cast<int>(v);
+    else
+      return false;
+  return true;
+}
+
+bool getLimit(XmlRpc::XmlRpcValue &limits, const char *name, bool &value)
+{
+  if (!limits.hasMember(name))
+    return false;
+  XmlRpc::XmlRpcValue &v = limits[name];
+  if (v.getType() != XmlRpc::XmlRpcValue::TypeBoolean)
+    return false;
+  value = static_cast<bool>(v);
+  return true;
+}
+
+// find the limits of a variable; the variables of multi-DOF joints are named <joint>/<variable>, and since '/'
+// separates namespaces on the parameter server, their limits are nested under the name of the joint
+XmlRpc::XmlRpcValue* findLimits(XmlRpc::XmlRpcValue &joint_limits, const std::string &variable)
+{
+  if (joint_limits.hasMember(variable))
+    return &joint_limits[variable];
+  XmlRpc::XmlRpcValue *limits = &joint_limits;
+  std::size_t begin = 0;
+  while (begin <= variable.size())
+  {
+    std::size_t end = variable.find('/', begin);
+    if (end == std::string::npos)
+      end = variable.size();
+    std::string name = variable.substr(begin, end - begin);
+    if (limits->getType() != XmlRpc::XmlRpcValue::TypeStruct || !limits->hasMember(name))
+      return NULL;
+    limits = &(*limits)[name];
+    begin = end + 1;
+  }
+  return limits;
+}
+}
+
+void robot_model_loader::applyJointLimits(XmlRpc::XmlRpcValue &joint_limits, const robot_model::RobotModelPtr &model)
+{
+  if (joint_limits.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+    return;
+  for (std::size_t i = 0; i < model->getJointModels().size() ; ++i)
+  {
+    robot_model::JointModel *jmodel = model->getJointModels()[i];
+    std::vector<moveit_msgs::JointLimits> jlim = jmodel->getVariableBoundsMsg();
+    bool changed = false;
+    for (std::size_t j = 0; j < jlim.size(); ++j)
+    {
+      XmlRpc::XmlRpcValue *found = findLimits(joint_limits, jlim[j].joint_name);
+      if (!found || found->getType() != XmlRpc::XmlRpcValue::TypeStruct)
+        continue;
+      XmlRpc::XmlRpcValue &limits = *found;
+      changed = true;
+
+      double max_position;
+      if (getLimit(limits, "max_position", max_position))
+      {
+        if (canSpecifyPosition(jmodel, j))
+        {
+          jlim[j].has_position_limits = true;
+          jlim[j].max_position = max_position;
+        }
+      }
+      double min_position;
+      if (getLimit(limits, "min_position", min_position))
+      {
+        if (canSpecifyPosition(jmodel, j))
+        {
+          jlim[j].has_position_limits = true;
+          jlim[j].min_position = min_position;
+        }
+      }
+      double max_velocity;
+      if (getLimit(limits, "max_velocity", max_velocity))
+      {
+        jlim[j].has_velocity_limits = true;
+        jlim[j].max_velocity = max_velocity;
+      }
+      bool has_vel_limits;
+      if (getLimit(limits, "has_velocity_limits", has_vel_limits))
+        jlim[j].has_velocity_limits = has_vel_limits;
+
+      double max_acc;
+      if (getLimit(limits, "max_acceleration", max_acc))
+      {
+        jlim[j].has_acceleration_limits = true;
+        jlim[j].max_acceleration = max_acc;
+      }
+      bool has_acc_limits;
+      if (getLimit(limits, "has_acceleration_limits", has_acc_limits))
+        jlim[j].has_acceleration_limits = has_acc_limits;
+    }
+    if (changed)
+      jmodel->setVariableBounds(jlim);
+  }
 }
 
 void robot_model_loader::RobotModelLoader::configure(const Options &opt)
@@ -85,15 +194,19 @@ void robot_model_loader::RobotModelLoader::configure(const Options &opt)
   moveit::tools::Profiler::ScopedBlock prof_block("RobotModelLoader::configure");
 
   ros::WallTime start = ros::WallTime::now();
-  if (opt.urdf_doc_ && opt.srdf_doc_)
-    rdf_loader_.reset(new rdf_loader::RDFLoader(opt.urdf_doc_, opt.srdf_doc_));
-  else
-    if (!opt.urdf_string_.empty() && !opt.srdf_string_.empty())
-      rdf_loader_.reset(new rdf_loader::RDFLoader(opt.urdf_string_, opt.srdf_string_));
+  {
+    moveit::tools::Profiler::ScopedBlock prof_block2("RobotModelLoader::configure parse URDF and SRDF");
+    if (opt.urdf_doc_ && opt.srdf_doc_)
+      rdf_loader_.reset(new rdf_loader::RDFLoader(opt.urdf_doc_, opt.srdf_doc_));
     else
-      rdf_loader_.reset(new rdf_loader::RDFLoader(opt.robot_description_));
+      if (!opt.urdf_string_.empty() && !opt.srdf_string_.empty())
+        rdf_loader_.reset(new rdf_loader::RDFLoader(opt.urdf_string_, opt.srdf_string_));
+      else
+        rdf_loader_.reset(new rdf_loader::RDFLoader(opt.robot_description_));
+  }
   if (rdf_loader_->getURDF())
   {
+    moveit::tools::Profiler::ScopedBlock prof_block2("RobotModelLoader::configure construct model");
     const boost::shared_ptr<srdf::Model> &srdf = rdf_loader_->getSRDF() ? rdf_loader_->getSRDF() : boost::shared_ptr<srdf::Model>(new srdf::Model());
     model_.reset(new robot_model::RobotModel(rdf_loader_->getURDF(), srdf));
   }
@@ -102,57 +215,13 @@ void robot_model_loader::RobotModelLoader::configure(const Options &opt)
   {
     moveit::tools::Profiler::ScopedBlock prof_block2("RobotModelLoader::configure joint limits");
 
-    // if there are additional joint limits specified in some .yaml file, read those in
+    // if there are additional joint limits specified in some .yaml file, read those in; all the limits are
+    // retrieved with one request to the parameter server, instead of one request per joint and field
     ros::NodeHandle nh("~");
-
-    for (std::size_t i = 0; i < model_->getJointModels().size() ; ++i)
-    {
-      robot_model::JointModel *jmodel = model_->getJointModels()[i];
-      std::vector<moveit_msgs::JointLimits> jlim = jmodel->getVariableBoundsMsg();
-      for (std::size_t j = 0; j < jlim.size(); ++j)
-      {
-        std::string prefix = rdf_loader_->getRobotDescription() + "_planning/joint_limits/" + jlim[j].joint_name + "/";
-
-        double max_position;
-        if (nh.getParam(prefix + "max_position", max_position))
-        {
-          if (canSpecifyPosition(jmodel, j))
-          {
-            jlim[j].has_position_limits = true;
-            jlim[j].max_position = max_position;
-          }
-        }
-        double min_position;
-        if (nh.getParam(prefix + "min_position", min_position))
-        {
-          if (canSpecifyPosition(jmodel, j))
-          {
-            jlim[j].has_position_limits = true;
-            jlim[j].min_position = min_position;
-          }
-        }
-        double max_velocity;
-        if (nh.getParam(prefix + "max_velocity", max_velocity))
-        {
-          jlim[j].has_velocity_limits = true;
-          jlim[j].max_velocity = max_velocity;
-        }
-        bool has_vel_limits;
-        if (nh.getParam(prefix + "has_velocity_limits", has_vel_limits))
-          jlim[j].has_velocity_limits = has_vel_limits;
-
-        double max_acc;
-        if (nh.getParam(prefix + "max_acceleration", max_acc))
-        {
-          jlim[j].has_acceleration_limits = true;
-          jlim[j].max_acceleration = max_acc;
-        }
-        bool has_acc_limits;
-        if (nh.getParam(prefix + "has_acceleration_limits", has_acc_limits))
-          jlim[j].has_acceleration_limits = has_acc_limits;
-      }
-      jmodel->setVariableBounds(jlim);
-    }
+    XmlRpc::XmlRpcValue all_limits;
+    if (nh.getParam(rdf_loader_->getRobotDescription() + "_planning/joint_limits", all_limits) &&
+        all_limits.getType() == XmlRpc::XmlRpcValue::TypeStruct)
+      applyJointLimits(all_limits, model_);
   }
 
   if (model_ && opt.load_kinematics_solvers_)
@@ -174,43 +243,53 @@ void robot_model_loader::RobotModelLoader::loadKinematicsSolvers(const kinematic
     else
       kinematics_loader_.reset(new kinematics_plugin_loader::KinematicsPluginLoader(rdf_loader_->getRobotDescription()));
     robot_model::SolverAllocatorFn kinematics_allocator = kinematics_loader_->getLoaderFunction(rdf_loader_->getSRDF());
+    // the solvers for the groups of this model use it (including the joint limits read above) instead of building their own
+    kinematics_loader_->registerRobotModel(model_);
     const std::vector<std::string> &groups = kinematics_loader_->getKnownGroups();
     std::stringstream ss;
     std::copy(groups.begin(), groups.end(), std::ostream_iterator<std::string>(ss, " "));
     ROS_DEBUG_STREAM("Loaded information about the following groups: '" << ss.str() << "'");
 
-    std::map<std::string, robot_model::SolverAllocatorFn> imap;
+    // Check if a group in kinematics.yaml exists in the srdf
+    std::vector<const robot_model::JointModelGroup*> jmgs;
     for (std::size_t i = 0 ; i < groups.size() ; ++i)
-    {
-      // Check if a group in kinematics.yaml exists in the srdf
-      if (!model_->hasJointModelGroup(groups[i]))
-        continue;
+      if (model_->hasJointModelGroup(groups[i]))
+        jmgs.push_back(model_->getJointModelGroup(groups[i]));
 
-      const robot_model::JointModelGroup *jmg = model_->getJointModelGroup(groups[i]);
+    // initialize the solvers of all groups at once; they are cached by the loader, so the allocator reuses them
+    std::vector<kinematics::KinematicsBasePtr> solvers;
+    kinematics_loader_->allocateSolvers(jmgs, solvers);
 
-      kinematics::KinematicsBasePtr solver = kinematics_allocator(jmg);
+    std::map<std::string, robot_model::SolverAllocatorFn> imap;
+    for (std::size_t i = 0 ; i < jmgs.size() ; ++i)
+    {
+      const kinematics::KinematicsBasePtr &solver = solvers[i];
       if(solver)
       {
         std::string error_msg;
-        if(solver->supportsGroup(jmg, &error_msg))
+        if(solver->supportsGroup(jmgs[i], &error_msg))
         {
-          imap[groups[i]] = kinematics_allocator;
+          imap[jmgs[i]->getName()] = kinematics_allocator;
         }
         else
         {
           ROS_ERROR("Kinematics solver %s does not support joint group %s.  Error: %s",
                     typeid(*solver).name(),
-                    groups[i].c_str(),
+                    jmgs[i]->getName().c_str(),
                     error_msg.c_str());
         }
       }
       else
       {
         ROS_ERROR("Kinematics solver could not be instantiated for joint group %s.",
-                  groups[i].c_str());
+                  jmgs[i]->getName().c_str());
       }
     }
-    model_->setKinematicsAllocators(imap);
+    solvers.clear(); // release the solvers, so the allocator can hand out the cached instances
+    {
+      moveit::tools::Profiler::ScopedBlock prof_block2("RobotModelLoader::loadKinematicsSolvers set allocators");
+      model_->setKinematicsAllocators(imap);
+    }
 
     // set the default IK timeouts
     const std::map<std::string, double> &timeout = kinematics_loader_->getIKTimeout();
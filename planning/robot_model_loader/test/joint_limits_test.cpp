@@ -0,0 +1,148 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/robot_model_loader/robot_model_loader.h>
+#include <urdf_parser/urdf_parser.h>
+
+static const char *URDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"mobile_arm\">"
+  "<link name=\"base_link\"/>"
+  "<joint name=\"joint_1\" type=\"revolute\">"
+  "  <axis xyz=\"0 0 1\"/>"
+  "  <limit effort=\"10.0\" lower=\"-3.0\" upper=\"3.0\" velocity=\"1.0\"/>"
+  "  <parent link=\"base_link\"/>"
+  "  <child link=\"link_1\"/>"
+  "  <origin rpy=\"0 0 0\" xyz=\"0 0 0.1\"/>"
+  "</joint>"
+  "<link name=\"link_1\"/>"
+  "</robot>";
+
+static const char *SRDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"mobile_arm\">"
+  "<virtual_joint name=\"base\" type=\"planar\" parent_frame=\"odom\" child_link=\"base_link\"/>"
+  "<group name=\"arm\">"
+  "<joint name=\"joint_1\"/>"
+  "</group>"
+  "</robot>";
+
+// a new model for every test, since the limits are changed in place
+static robot_model::RobotModelPtr makeModel()
+{
+  boost::shared_ptr<urdf::ModelInterface> urdf(urdf::parseURDF(URDF_STR));
+  boost::shared_ptr<srdf::Model> srdf(new srdf::Model());
+  srdf->initString(*urdf, SRDF_STR);
+  return robot_model::RobotModelPtr(new robot_model::RobotModel(urdf, srdf));
+}
+
+TEST(ApplyJointLimits, OverridesLimitsOfSingleDOFJoints)
+{
+  robot_model::RobotModelPtr model = makeModel();
+  XmlRpc::XmlRpcValue limits;
+  limits["joint_1"]["min_position"] = -1.5;
+  limits["joint_1"]["max_position"] = 1.5;
+  limits["joint_1"]["max_velocity"] = 2; // integers are accepted too
+  limits["joint_1"]["has_acceleration_limits"] = true;
+  limits["joint_1"]["max_acceleration"] = 4.0;
+  robot_model_loader::applyJointLimits(limits, model);
+
+  const robot_model::VariableBounds &bounds = model->getVariableBounds("joint_1");
+  EXPECT_TRUE(bounds.position_bounded_);
+  EXPECT_DOUBLE_EQ(-1.5, bounds.min_position_);
+  EXPECT_DOUBLE_EQ(1.5, bounds.max_position_);
+  EXPECT_TRUE(bounds.velocity_bounded_);
+  EXPECT_DOUBLE_EQ(2.0, bounds.max_velocity_);
+  EXPECT_TRUE(bounds.acceleration_bounded_);
+  EXPECT_DOUBLE_EQ(4.0, bounds.max_acceleration_);
+}
+
+TEST(ApplyJointLimits, OverridesLimitsOfPlanarJointVariables)
+{
+  robot_model::RobotModelPtr model = makeModel();
+  const robot_model::VariableBounds y_before = model->getVariableBounds("base/y");
+  const robot_model::VariableBounds theta_before = model->getVariableBounds("base/theta");
+
+  // base/x and base/theta, as they are nested when loaded from a yaml file onto the parameter server
+  XmlRpc::XmlRpcValue limits;
+  limits["base"]["x"]["min_position"] = -2.0;
+  limits["base"]["x"]["max_position"] = 2.0;
+  limits["base"]["theta"]["max_velocity"] = 0.5;
+  limits["base"]["theta"]["max_position"] = 1.0; // not allowed for the orientation of a planar joint
+  robot_model_loader::applyJointLimits(limits, model);
+
+  const robot_model::VariableBounds &x = model->getVariableBounds("base/x");
+  EXPECT_TRUE(x.position_bounded_);
+  EXPECT_DOUBLE_EQ(-2.0, x.min_position_);
+  EXPECT_DOUBLE_EQ(2.0, x.max_position_);
+
+  const robot_model::VariableBounds &y = model->getVariableBounds("base/y");
+  EXPECT_EQ(y_before.position_bounded_, y.position_bounded_);
+  EXPECT_DOUBLE_EQ(y_before.min_position_, y.min_position_);
+  EXPECT_DOUBLE_EQ(y_before.max_position_, y.max_position_);
+
+  const robot_model::VariableBounds &theta = model->getVariableBounds("base/theta");
+  EXPECT_TRUE(theta.velocity_bounded_);
+  EXPECT_DOUBLE_EQ(0.5, theta.max_velocity_);
+  EXPECT_DOUBLE_EQ(theta_before.max_position_, theta.max_position_);
+
+  // the joint that is not multi-DOF keeps its limits from the URDF
+  EXPECT_DOUBLE_EQ(3.0, model->getVariableBounds("joint_1").max_position_);
+}
+
+TEST(ApplyJointLimits, IgnoresEntriesThatAreNotVariables)
+{
+  robot_model::RobotModelPtr model = makeModel();
+  const robot_model::VariableBounds x_before = model->getVariableBounds("base/x");
+
+  XmlRpc::XmlRpcValue limits;
+  limits["base"]["max_position"] = 1.0; // the joint itself, not one of its variables
+  limits["base"]["z"]["max_position"] = 1.0;
+  limits["joint_2"]["max_position"] = 1.0;
+  limits["joint_1"] = 1.0;
+  robot_model_loader::applyJointLimits(limits, model);
+
+  const robot_model::VariableBounds &x = model->getVariableBounds("base/x");
+  EXPECT_EQ(x_before.position_bounded_, x.position_bounded_);
+  EXPECT_DOUBLE_EQ(x_before.max_position_, x.max_position_);
+  EXPECT_DOUBLE_EQ(3.0, model->getVariableBounds("joint_1").max_position_);
+  EXPECT_DOUBLE_EQ(1.0, model->getVariableBounds("joint_1").max_velocity_);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -47,6 +47,10 @@
 
 // System
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <list>
+#include <map>
 
 // ROS msgs
 #include <geometry_msgs/PoseStamped.h>
@@ -179,21 +183,74 @@ namespace srv_kinematics_plugin
 
     bool isRedundantJoint(unsigned int index) const;
 
+    /** @brief Send one IK query to the service and extract the solution for the group from the response */
+    bool callService(const std::vector<geometry_msgs::Pose> &ik_poses,
+                     const std::vector<double> &ik_seed_state,
+                     std::vector<double> &solution,
+                     moveit_msgs::MoveItErrorCodes &error_code) const;
+
+    /** @brief Get an idle connection to the service, or open a new one */
+    boost::shared_ptr<ros::ServiceClient> acquireClient() const;
+
+    /** @brief Make a connection available for reuse */
+    void releaseClient(const boost::shared_ptr<ros::ServiceClient> &client) const;
+
+    /** @brief Get the key of the cache entry for a query: the values of the poses, rounded to cache_resolution_ */
+    void cacheKey(const std::vector<geometry_msgs::Pose> &ik_poses, std::vector<double> &key) const;
+
+    /** @brief Look up the solution the service returned for a query with the same \e key */
+    bool lookupCache(const std::vector<double> &key, std::vector<double> &solution) const;
+
+    /** @brief Remember the solution for \e key, dropping the least recently used entry if the cache is full */
+    void addToCache(const std::vector<double> &key, const std::vector<double> &solution) const;
+
+    /** @brief Forget the solution for \e key, if there is one */
+    void removeFromCache(const std::vector<double> &key) const;
+
     bool active_; /** Internal variable that indicates whether solvers are configured and ready */
 
     moveit_msgs::KinematicSolverInfo ik_group_info_; /** Stores information for the inverse kinematics solver */
 
     unsigned int dimension_; /** Dimension of the group */
 
-    robot_model::RobotModelPtr robot_model_;
-    robot_model::JointModelGroup* joint_model_group_;
+    /** The model of the robot; its groups own their solvers, so only a weak reference is kept */
+    boost::weak_ptr<const robot_model::RobotModel> robot_model_;
 
-    robot_state::RobotStatePtr robot_state_;
+    /** The model this solver constructed itself, if the loader did not provide one */
+    robot_model::RobotModelConstPtr own_robot_model_;
 
-    int num_possible_redundant_joints_;
+    /** The group of robot_model_; only used while a reference to the model is held */
+    const robot_model::JointModelGroup* joint_model_group_;
+
+    std::vector<std::string> variable_names_; /** The variables of the group */
+
+    /** The robot state sent with each request; only the values of the group variables are changed per request */
+    moveit_msgs::RobotState request_state_template_;
+
+    /** For each variable of the group, its index in request_state_template_.joint_state */
+    std::vector<std::size_t> request_state_index_;
 
-    boost::shared_ptr<ros::ServiceClient> ik_service_client_;
+    /** The index of each variable of the group, by name */
+    std::map<std::string, std::size_t> variable_index_;
+
+    /** True if all the variables of the group are in the joint state of request_state_template_, so requests can be
+        built and solutions extracted without converting to and from a full robot state */
+    bool fast_state_conversion_;
+
+    int num_possible_redundant_joints_;
 
+    std::string ik_service_name_;
+    bool persistent_connections_;
+    mutable std::vector<boost::shared_ptr<ros::ServiceClient> > idle_clients_;
+    mutable boost::mutex clients_lock_;
+
+    /** Least recently used cache of solutions, by the rounded values of the requested poses */
+    typedef std::list<std::pair<std::vector<double>, std::vector<double> > > CacheList;
+    std::size_t cache_size_;
+    double cache_resolution_; /** Poses closer than this (in meters, and in quaternion components) share a cache entry */
+    mutable CacheList cache_;
+    mutable std::map<std::vector<double>, CacheList::iterator> cache_index_;
+    mutable boost::mutex cache_lock_;
 
   };
 }
@@ -43,6 +43,10 @@
 
 #include <moveit/robot_state/conversions.h>
 #include <moveit/rdf_loader/rdf_loader.h>
+#include <moveit/kinematics_plugin_loader/kinematics_plugin_loader.h>
+
+#include <algorithm>
+#include <cmath>
 
 // Eigen
 #include <Eigen/Core>
@@ -55,7 +59,11 @@ namespace srv_kinematics_plugin
 {
 
 SrvKinematicsPlugin::SrvKinematicsPlugin()
- : active_(false) 
+ : active_(false),
+   fast_state_conversion_(false),
+   persistent_connections_(true),
+   cache_size_(0),
+   cache_resolution_(1e-4)
 {}
 
 bool SrvKinematicsPlugin::initialize(const std::string &robot_description,
@@ -71,19 +79,28 @@ bool SrvKinematicsPlugin::initialize(const std::string &robot_description,
   setValues(robot_description, group_name, base_frame, tip_frames, search_discretization);
 
   ros::NodeHandle private_handle("~");
-  rdf_loader::RDFLoader rdf_loader(robot_description_);
-  const boost::shared_ptr<srdf::Model> &srdf = rdf_loader.getSRDF();
-  const boost::shared_ptr<urdf::ModelInterface>& urdf_model = rdf_loader.getURDF();
 
-  if (!urdf_model || !srdf)
+  // use the model the loader already built, if there is one; parsing the robot description is slow
+  robot_model::RobotModelConstPtr robot_model = kinematics_plugin_loader::getRobotModelForInitialization();
+  own_robot_model_.reset();
+  if (!robot_model)
   {
-    ROS_ERROR_NAMED("srv","URDF and SRDF must be loaded for SRV kinematics solver to work."); // TODO: is this true?
-    return false;
-  }
+    rdf_loader::RDFLoader rdf_loader(robot_description_);
+    const boost::shared_ptr<srdf::Model> &srdf = rdf_loader.getSRDF();
+    const boost::shared_ptr<urdf::ModelInterface>& urdf_model = rdf_loader.getURDF();
+
+    if (!urdf_model || !srdf)
+    {
+      ROS_ERROR_NAMED("srv","URDF and SRDF must be loaded for SRV kinematics solver to work."); // TODO: is this true?
+      return false;
+    }
 
-  robot_model_.reset(new robot_model::RobotModel(urdf_model, srdf));
+    own_robot_model_.reset(new robot_model::RobotModel(urdf_model, srdf));
+    robot_model = own_robot_model_;
+  }
+  robot_model_ = robot_model;
 
-  joint_model_group_ = robot_model_->getJointModelGroup(group_name);
+  joint_model_group_ = robot_model->getJointModelGroup(group_name);
   if (!joint_model_group_)
     return false;
 
@@ -127,21 +144,47 @@ bool SrvKinematicsPlugin::initialize(const std::string &robot_description,
   // Choose what ROS service to send IK requests to
   ROS_DEBUG_STREAM_NAMED("srv","Looking for ROS service name on rosparm server at location: " <<
     private_handle.getNamespace() << "/" << group_name_ << "/kinematics_solver_service_name");
-  std::string ik_service_name;
-  private_handle.param(group_name_ + "/kinematics_solver_service_name", ik_service_name, std::string("solve_ik"));
+  private_handle.param(group_name_ + "/kinematics_solver_service_name", ik_service_name_, std::string("solve_ik"));
+  private_handle.param(group_name_ + "/kinematics_solver_persistent_connections", persistent_connections_, true);
+  int cache_size;
+  private_handle.param(group_name_ + "/kinematics_solver_cache_size", cache_size, 0);
+  cache_size_ = cache_size > 0 ? cache_size : 0;
+  private_handle.param(group_name_ + "/kinematics_solver_cache_resolution", cache_resolution_, 1e-4);
+  if (cache_resolution_ <= 0.0)
+  {
+    ROS_WARN_NAMED("srv","kinematics_solver_cache_resolution must be positive; using 1e-4");
+    cache_resolution_ = 1e-4;
+  }
 
-  // Setup the joint state groups that we need
-  robot_state_.reset(new robot_state::RobotState(robot_model_));
-  robot_state_->setToDefaultValues();
+  // The full robot state is converted once; requests only update the variables of the group
+  robot_state::RobotState default_state(robot_model);
+  default_state.setToDefaultValues();
+  moveit::core::robotStateToRobotStateMsg(default_state, request_state_template_);
+  variable_names_ = joint_model_group_->getVariableNames();
+  const std::vector<std::string> &variable_names = variable_names_;
+  std::map<std::string, std::size_t> template_index;
+  for (std::size_t i = 0 ; i < request_state_template_.joint_state.name.size() ; ++i)
+    template_index[request_state_template_.joint_state.name[i]] = i;
+  fast_state_conversion_ = true;
+  request_state_index_.resize(variable_names.size());
+  variable_index_.clear();
+  for (std::size_t i = 0 ; i < variable_names.size() ; ++i)
+  {
+    variable_index_[variable_names[i]] = i;
+    std::map<std::string, std::size_t>::const_iterator it = template_index.find(variable_names[i]);
+    if (it == template_index.end())
+      fast_state_conversion_ = false;
+    else
+      request_state_index_[i] = it->second;
+  }
 
   // Create the ROS service client
-  ros::NodeHandle nonprivate_handle("");
-  ik_service_client_ = boost::make_shared<ros::ServiceClient>(nonprivate_handle.serviceClient
-                       <moveit_msgs::GetPositionIK>(ik_service_name));
-  if (!ik_service_client_->waitForExistence(ros::Duration(0.1))) // wait 0.1 seconds, blocking
-    ROS_WARN_STREAM_NAMED("srv","Unable to connect to ROS service client with name: " << ik_service_client_->getService());
+  boost::shared_ptr<ros::ServiceClient> client = acquireClient();
+  if (!client->waitForExistence(ros::Duration(0.1))) // wait 0.1 seconds, blocking
+    ROS_WARN_STREAM_NAMED("srv","Unable to connect to ROS service client with name: " << client->getService());
   else
-    ROS_INFO_STREAM_NAMED("srv","Service client started with ROS service name: " << ik_service_client_->getService());
+    ROS_INFO_STREAM_NAMED("srv","Service client started with ROS service name: " << client->getService());
+  releaseClient(client);
 
   active_ = true;
   ROS_DEBUG_NAMED("srv","ROS service-based kinematics solver initialized");
@@ -339,14 +382,99 @@ bool SrvKinematicsPlugin::searchPositionIK(const std::vector<geometry_msgs::Pose
     return false;
   }
 
+  // a cached solution is not necessarily close to the seed, so it is not used when consistency is required
+  std::vector<double> key;
+  bool cached = false;
+  if (cache_size_ > 0)
+  {
+    cacheKey(ik_poses, key);
+    cached = consistency_limits.empty() && lookupCache(key, solution);
+  }
+  if (cached)
+    error_code.val = error_code.SUCCESS;
+  else
+  {
+    if (!callService(ik_poses, ik_seed_state, solution, error_code))
+      return false;
+    addToCache(key, solution);
+  }
+
+  // Run the solution callback (i.e. collision checker) if available
+  if (!solution_callback.empty())
+  {
+    ROS_DEBUG_STREAM_NAMED("srv","Calling solution callback on IK solution");
+
+    // hack: should use all poses, not just the 0th
+    solution_callback(ik_poses[0], solution, error_code);
+
+    // a rejected solution is not kept; if it came from the cache, the environment may have changed since the service
+    // returned it, so the service is asked again
+    if (error_code.val != error_code.SUCCESS && cache_size_ > 0)
+    {
+      removeFromCache(key);
+      if (cached)
+      {
+        ROS_DEBUG_NAMED("srv","The cached IK solution was rejected; calling the service");
+        if (!callService(ik_poses, ik_seed_state, solution, error_code))
+          return false;
+        solution_callback(ik_poses[0], solution, error_code);
+        if (error_code.val == error_code.SUCCESS)
+          addToCache(key, solution);
+      }
+    }
+
+    if(error_code.val != error_code.SUCCESS)
+    {
+      switch (error_code.val)
+      {
+        case moveit_msgs::MoveItErrorCodes::FAILURE:
+          ROS_ERROR_STREAM_NAMED("srv","IK solution callback failed with with error code: FAILURE");
+          break;
+        case moveit_msgs::MoveItErrorCodes::NO_IK_SOLUTION:
+          ROS_ERROR_STREAM_NAMED("srv","IK solution callback failed with with error code: NO IK SOLUTION");
+          break;
+        default:
+          ROS_ERROR_STREAM_NAMED("srv","IK solution callback failed with with error code: " << error_code.val);
+      }
+      return false;
+    }
+  }
+
+  ROS_DEBUG_STREAM_NAMED("srv","IK Solver Succeeded!");
+  return true;
+}
+
+bool SrvKinematicsPlugin::callService(const std::vector<geometry_msgs::Pose> &ik_poses,
+  const std::vector<double> &ik_seed_state,
+  std::vector<double> &solution,
+  moveit_msgs::MoveItErrorCodes &error_code) const
+{
   // Create the service message
   moveit_msgs::GetPositionIK ik_srv;
   ik_srv.request.ik_request.avoid_collisions = true;
   ik_srv.request.ik_request.group_name = getGroupName();
 
-  // Copy seed state into virtual robot state and convert into moveit_msg
-  robot_state_->setJointGroupPositions(joint_model_group_, ik_seed_state);
-  moveit::core::robotStateToRobotStateMsg(*robot_state_, ik_srv.request.ik_request.robot_state);
+  // Copy seed state into the robot state message
+  if (fast_state_conversion_)
+  {
+    ik_srv.request.ik_request.robot_state = request_state_template_;
+    for (std::size_t i = 0 ; i < request_state_index_.size() ; ++i)
+      ik_srv.request.ik_request.robot_state.joint_state.position[request_state_index_[i]] = ik_seed_state[i];
+  }
+  else
+  {
+    robot_model::RobotModelConstPtr robot_model = robot_model_.lock();
+    if (!robot_model)
+    {
+      ROS_ERROR_NAMED("srv","The robot model this solver was initialized for no longer exists");
+      error_code.val = error_code.FAILURE;
+      return false;
+    }
+    robot_state::RobotState seed_state(robot_model);
+    seed_state.setToDefaultValues();
+    seed_state.setJointGroupPositions(joint_model_group_, ik_seed_state);
+    moveit::core::robotStateToRobotStateMsg(seed_state, ik_srv.request.ik_request.robot_state);
+  }
 
   // Load the poses into the request in difference places depending if there is more than one or not
   geometry_msgs::PoseStamped ik_pose_st;
@@ -370,9 +498,12 @@ bool SrvKinematicsPlugin::searchPositionIK(const std::vector<geometry_msgs::Pose
     ik_srv.request.ik_request.ik_link_name = getTipFrames()[0];
   }
 
-  ROS_DEBUG_STREAM_NAMED("srv","Calling service: " << ik_service_client_->getService() );
-  if (ik_service_client_->call(ik_srv))
+  boost::shared_ptr<ros::ServiceClient> client = acquireClient();
+  ROS_DEBUG_STREAM_NAMED("srv","Calling service: " << client->getService() );
+  if (client->call(ik_srv))
   {
+    releaseClient(client);
+
     // Check error code
     error_code.val = ik_srv.response.error_code.val;
     if(error_code.val != error_code.SUCCESS)
@@ -398,51 +529,136 @@ bool SrvKinematicsPlugin::searchPositionIK(const std::vector<geometry_msgs::Pose
   }
   else
   {
-    ROS_ERROR_STREAM("Service call failed to connect to service: " << ik_service_client_->getService() );
+    // the connection is not reused; a persistent connection that failed stays invalid
+    ROS_ERROR_STREAM("Service call failed to connect to service: " << client->getService() );
     error_code.val = error_code.FAILURE;
     return false;
   }
 
-  // Convert the robot state message to our robot_state representation
-  if (!moveit::core::robotStateMsgToRobotState(ik_srv.response.solution, *robot_state_))
+  // Get just the joints we are concerned about in our planning group; variables not in the response keep their seed value
+  if (fast_state_conversion_)
   {
-    ROS_ERROR_STREAM_NAMED("srv","An error occured converting recieved robot state message into internal robot state.");
-    error_code.val = error_code.FAILURE;
-    return false;
+    solution = ik_seed_state;
+    const sensor_msgs::JointState &js = ik_srv.response.solution.joint_state;
+    for (std::size_t i = 0 ; i < js.name.size() && i < js.position.size() ; ++i)
+    {
+      std::map<std::string, std::size_t>::const_iterator it = variable_index_.find(js.name[i]);
+      if (it != variable_index_.end())
+        solution[it->second] = js.position[i];
+    }
   }
-
-  // Get just the joints we are concerned about in our planning group
-  robot_state_->copyJointGroupPositions(joint_model_group_, solution);
-
-  // Run the solution callback (i.e. collision checker) if available
-  if (!solution_callback.empty())
+  else
   {
-    ROS_DEBUG_STREAM_NAMED("srv","Calling solution callback on IK solution");
-
-    // hack: should use all poses, not just the 0th
-    solution_callback(ik_poses[0], solution, error_code);
-
-    if(error_code.val != error_code.SUCCESS)
+    robot_model::RobotModelConstPtr robot_model = robot_model_.lock();
+    if (!robot_model)
     {
-      switch (error_code.val)
-      {
-        case moveit_msgs::MoveItErrorCodes::FAILURE:
-          ROS_ERROR_STREAM_NAMED("srv","IK solution callback failed with with error code: FAILURE");
-          break;
-        case moveit_msgs::MoveItErrorCodes::NO_IK_SOLUTION:
-          ROS_ERROR_STREAM_NAMED("srv","IK solution callback failed with with error code: NO IK SOLUTION");
-          break;
-        default:
-          ROS_ERROR_STREAM_NAMED("srv","IK solution callback failed with with error code: " << error_code.val);
-      }
+      ROS_ERROR_NAMED("srv","The robot model this solver was initialized for no longer exists");
+      error_code.val = error_code.FAILURE;
+      return false;
+    }
+    robot_state::RobotState solution_state(robot_model);
+    solution_state.setToDefaultValues();
+    solution_state.setJointGroupPositions(joint_model_group_, ik_seed_state);
+    // Convert the robot state message to our robot_state representation
+    if (!moveit::core::robotStateMsgToRobotState(ik_srv.response.solution, solution_state))
+    {
+      ROS_ERROR_STREAM_NAMED("srv","An error occured converting recieved robot state message into internal robot state.");
+      error_code.val = error_code.FAILURE;
       return false;
     }
+    solution_state.copyJointGroupPositions(joint_model_group_, solution);
   }
+  return true;
+}
+
+boost::shared_ptr<ros::ServiceClient> SrvKinematicsPlugin::acquireClient() const
+{
+  {
+    boost::mutex::scoped_lock slock(clients_lock_);
+    if (!idle_clients_.empty())
+    {
+      boost::shared_ptr<ros::ServiceClient> client = idle_clients_.back();
+      idle_clients_.pop_back();
+      if (client->isValid())
+        return client;
+    }
+  }
+  ros::NodeHandle nonprivate_handle("");
+  return boost::make_shared<ros::ServiceClient>(nonprivate_handle.serviceClient<moveit_msgs::GetPositionIK>(ik_service_name_, persistent_connections_));
+}
+
+void SrvKinematicsPlugin::releaseClient(const boost::shared_ptr<ros::ServiceClient> &client) const
+{
+  boost::mutex::scoped_lock slock(clients_lock_);
+  idle_clients_.push_back(client);
+}
 
-  ROS_INFO_STREAM_NAMED("srv","IK Solver Succeeded!");
+void SrvKinematicsPlugin::cacheKey(const std::vector<geometry_msgs::Pose> &ik_poses, std::vector<double> &key) const
+{
+  // the seed is left out so that queries for the same pose from different seeds share an entry; a cached solution is
+  // therefore only used when no consistency with the seed is required
+  key.resize(ik_poses.size() * 7);
+  for (std::size_t i = 0 ; i < ik_poses.size() ; ++i)
+  {
+    // q and -q are the same orientation
+    double sign = ik_poses[i].orientation.w < 0.0 ? -1.0 : 1.0;
+    key[i * 7 + 0] = ik_poses[i].position.x;
+    key[i * 7 + 1] = ik_poses[i].position.y;
+    key[i * 7 + 2] = ik_poses[i].position.z;
+    key[i * 7 + 3] = sign * ik_poses[i].orientation.x;
+    key[i * 7 + 4] = sign * ik_poses[i].orientation.y;
+    key[i * 7 + 5] = sign * ik_poses[i].orientation.z;
+    key[i * 7 + 6] = sign * ik_poses[i].orientation.w;
+  }
+  // poses that differ by less than the resolution (e.g., the same target computed twice) map to the same key
+  for (std::size_t i = 0 ; i < key.size() ; ++i)
+    key[i] = floor(key[i] / cache_resolution_ + 0.5);
+}
+
+bool SrvKinematicsPlugin::lookupCache(const std::vector<double> &key, std::vector<double> &solution) const
+{
+  if (cache_size_ == 0)
+    return false;
+  boost::mutex::scoped_lock slock(cache_lock_);
+  std::map<std::vector<double>, CacheList::iterator>::const_iterator it = cache_index_.find(key);
+  if (it == cache_index_.end())
+    return false;
+  cache_.splice(cache_.begin(), cache_, it->second);
+  solution = it->second->second;
   return true;
 }
 
+void SrvKinematicsPlugin::addToCache(const std::vector<double> &key, const std::vector<double> &solution) const
+{
+  if (cache_size_ == 0)
+    return;
+  boost::mutex::scoped_lock slock(cache_lock_);
+  std::map<std::vector<double>, CacheList::iterator>::iterator it = cache_index_.find(key);
+  if (it != cache_index_.end())
+  {
+    it->second->second = solution;
+    cache_.splice(cache_.begin(), cache_, it->second);
+    return;
+  }
+  cache_.push_front(std::make_pair(key, solution));
+  cache_index_[key] = cache_.begin();
+  if (cache_.size() > cache_size_)
+  {
+    cache_index_.erase(cache_.back().first);
+    cache_.pop_back();
+  }
+}
+
+void SrvKinematicsPlugin::removeFromCache(const std::vector<double> &key) const
+{
+  boost::mutex::scoped_lock slock(cache_lock_);
+  std::map<std::vector<double>, CacheList::iterator>::iterator it = cache_index_.find(key);
+  if (it == cache_index_.end())
+    return;
+  cache_.erase(it->second);
+  cache_index_.erase(it);
+}
+
 bool SrvKinematicsPlugin::getPositionFK(const std::vector<std::string> &link_names,
   const std::vector<double> &joint_angles,
   std::vector<geometry_msgs::Pose> &poses) const
@@ -477,7 +693,7 @@ const std::vector<std::string>& SrvKinematicsPlugin::getLinkNames() const
 
 const std::vector<std::string>& SrvKinematicsPlugin::getVariableNames() const
 {
-  return joint_model_group_->getVariableNames();
+  return variable_names_;
 }
 
 } // namespace
@@ -38,6 +38,12 @@
 #define MOVEIT_PLANNING_INTERFACE_COMMON_OBJECTS_
 
 #include <moveit/planning_scene_monitor/current_state_monitor.h>
+#include <moveit/planning_scene_monitor/planning_scene_monitor.h>
+#include <moveit/planning_pipeline/planning_pipeline.h>
+#include <actionlib/client/action_client.h>
+#include <ros/callback_queue_interface.h>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
 
 namespace moveit
 {
@@ -51,6 +57,57 @@ robot_model::RobotModelConstPtr getSharedRobotModel(const std::string &robot_des
 
 planning_scene_monitor::CurrentStateMonitorPtr getSharedStateMonitor(const robot_model::RobotModelConstPtr &kmodel, const boost::shared_ptr<tf::Transformer> &tf);
 
+/** \brief Get a planning scene monitor for \e robot_description that mirrors the scene maintained by the move_group node whose namespace is \e move_group_ns.
+    The monitor is shared by all users in this process that connect to the same move_group. It is initialized from the get_planning_scene service and follows the
+    monitored scene published by move_group, as well as the joint states. NULL is returned if the monitor could not be configured or the initial scene could not be retrieved. */
+planning_scene_monitor::PlanningSceneMonitorPtr getSharedPlanningSceneMonitor(const std::string &robot_description, const boost::shared_ptr<tf::Transformer> &tf,
+                                                                              const std::string &move_group_ns);
+
+/** \brief Get a planning pipeline for \e kmodel configured from the parameters in the namespace of \e node_handle, shared by all users in this process */
+planning_pipeline::PlanningPipelinePtr getSharedPlanningPipeline(const robot_model::RobotModelConstPtr &kmodel, const ros::NodeHandle &node_handle);
+
+/** \brief The signature of planning_pipeline::PlanningPipeline::generatePlan() */
+typedef boost::function<bool(const planning_scene::PlanningSceneConstPtr&, const ::planning_interface::MotionPlanRequest&,
+                             ::planning_interface::MotionPlanResponse&)> GeneratePlanFn;
+
+/** \brief Compute a plan for \e req by calling \e generate_plan on a copy of \e scene. \e lock_scene and \e unlock_scene are only called around making the copy,
+    so whoever maintains \e scene can keep updating it while the plan is computed. If \e generate_plan throws, the error code of \e res is set to FAILURE. */
+void generatePlanOnSceneCopy(const planning_scene::PlanningScenePtr &scene, const boost::function<void()> &lock_scene, const boost::function<void()> &unlock_scene,
+                             const GeneratePlanFn &generate_plan, const ::planning_interface::MotionPlanRequest &req, ::planning_interface::MotionPlanResponse &res);
+
+/** \brief Compute a plan for \e req with \e pipeline, on a copy of the scene kept by \e monitor that is updated with the current state of the robot */
+void generatePlanOnSceneCopy(const planning_scene_monitor::PlanningSceneMonitorPtr &monitor, const planning_pipeline::PlanningPipelinePtr &pipeline,
+                             const ::planning_interface::MotionPlanRequest &req, ::planning_interface::MotionPlanResponse &res);
+
+/** \brief Get the key under which an object of kind \e type, for \e name, is shared among the users of the move_group in namespace \e move_group_ns.
+    Spellings of the same namespace that differ only in repeated or trailing slashes give the same key. */
+std::string getSharedMoveGroupObjectKey(const std::string &type, const std::string &name, const std::string &move_group_ns);
+
+/** \brief Get the object stored under \e key, shared by all users in this process. The first time a key is requested, \e allocator is called to construct the object.
+    If \e allocator returns NULL, nothing is stored and the next request for the key calls it again. */
+boost::shared_ptr<void> getSharedObject(const std::string &key, const boost::function<boost::shared_ptr<void>()> &allocator);
+
+/** \brief Get the callback queue used by the shared action clients. A thread of its own services this queue, so the clients connect and receive results without the caller spinning. */
+ros::CallbackQueueInterface* getSharedCallbackQueue();
+
+namespace detail
+{
+template<typename ActionSpec>
+boost::shared_ptr<void> allocateActionClient(const ros::NodeHandle &node_handle, const std::string &action_name)
+{
+  return boost::shared_ptr<void>(new actionlib::ActionClient<ActionSpec>(node_handle, action_name, getSharedCallbackQueue()));
+}
+}
+
+/** \brief Get the action client for \e action_name (resolved in the namespace of \e node_handle) shared by all users in this process.
+    The client starts connecting to its server when it is first constructed. Every user tracks its own goals through actionlib::ClientGoalHandle, so the client can be used concurrently. */
+template<typename ActionSpec>
+boost::shared_ptr<actionlib::ActionClient<ActionSpec> > getSharedActionClient(const ros::NodeHandle &node_handle, const std::string &action_name)
+{
+  const std::string key = std::string(ros::message_traits::datatype<ActionSpec>()) + ":" + node_handle.resolveName(action_name);
+  return boost::static_pointer_cast<actionlib::ActionClient<ActionSpec> >(getSharedObject(key, boost::bind(&detail::allocateActionClient<ActionSpec>, node_handle, action_name)));
+}
+
 }
 }
 
@@ -37,6 +37,12 @@
 #include <moveit/common_planning_interface_objects/common_objects.h>
 #include <moveit/robot_model_loader/robot_model_loader.h>
 #include <tf/transform_listener.h>
+#include <ros/callback_queue.h>
+#include <ros/spinner.h>
+#include <ros/names.h>
+#include <ros/console.h>
+#include <boost/scoped_ptr.hpp>
+#include <stdexcept>
 
 namespace
 {
@@ -48,6 +54,9 @@ struct SharedStorage
 
   ~SharedStorage()
   {
+    if (spinner_)
+      spinner_->stop();
+    objects_.clear();
     tf_.reset();
     state_monitors_.clear();
     model_loaders_.clear();
@@ -57,6 +66,9 @@ struct SharedStorage
   boost::shared_ptr<tf::Transformer> tf_;
   std::map<std::string, robot_model_loader::RobotModelLoaderPtr> model_loaders_;
   std::map<std::string, planning_scene_monitor::CurrentStateMonitorPtr> state_monitors_;
+  std::map<std::string, boost::shared_ptr<void> > objects_;
+  ros::CallbackQueue queue_;
+  boost::scoped_ptr<ros::AsyncSpinner> spinner_;
 };
 
 SharedStorage& getSharedStorage()
@@ -80,22 +92,57 @@ boost::shared_ptr<tf::Transformer> getSharedTF()
   return s.tf_;
 }
 
-robot_model::RobotModelConstPtr getSharedRobotModel(const std::string &robot_description)
+namespace
+{
+robot_model_loader::RobotModelLoaderPtr getSharedModelLoader(const std::string &robot_description)
 {
   SharedStorage &s = getSharedStorage();
   boost::mutex::scoped_lock slock(s.lock_);
   if (s.model_loaders_.find(robot_description) != s.model_loaders_.end())
-    return s.model_loaders_[robot_description]->getModel();
+    return s.model_loaders_[robot_description];
   else
   {
     robot_model_loader::RobotModelLoader::Options opt(robot_description);
     opt.load_kinematics_solvers_ = true;
     robot_model_loader::RobotModelLoaderPtr loader(new robot_model_loader::RobotModelLoader(opt));
     s.model_loaders_[robot_description] = loader;
-    return loader->getModel();
+    return loader;
   }
 }
 
+boost::shared_ptr<void> allocatePlanningSceneMonitor(const std::string &robot_description, const boost::shared_ptr<tf::Transformer> &tf,
+                                                     const std::string &move_group_ns)
+{
+  planning_scene_monitor::PlanningSceneMonitorPtr monitor(new planning_scene_monitor::PlanningSceneMonitor(getSharedModelLoader(robot_description), tf,
+                                                                                                          "move_group_interface"));
+  if (!monitor->getPlanningScene())
+    return boost::shared_ptr<void>();
+  monitor->startSceneMonitor(ros::names::append(move_group_ns, planning_scene_monitor::PlanningSceneMonitor::MONITORED_PLANNING_SCENE_TOPIC));
+  monitor->startStateMonitor();
+  // without the initial scene, local plans would ignore the objects move_group already knows about
+  if (!monitor->requestPlanningSceneState(ros::names::append(move_group_ns, planning_scene_monitor::PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_SERVICE)))
+  {
+    ROS_WARN_STREAM("Unable to retrieve the planning scene maintained by move_group in namespace '" << move_group_ns << "'");
+    return boost::shared_ptr<void>();
+  }
+  return monitor;
+}
+
+boost::shared_ptr<void> allocatePlanningPipeline(const robot_model::RobotModelConstPtr &kmodel, const ros::NodeHandle &node_handle)
+{
+  planning_pipeline::PlanningPipelinePtr pipeline(new planning_pipeline::PlanningPipeline(kmodel, node_handle));
+  // plans computed in this process are only for the caller; move_group takes care of displaying and checking its own
+  pipeline->displayComputedMotionPlans(false);
+  pipeline->checkSolutionPaths(true);
+  return pipeline;
+}
+}
+
+robot_model::RobotModelConstPtr getSharedRobotModel(const std::string &robot_description)
+{
+  return getSharedModelLoader(robot_description)->getModel();
+}
+
 planning_scene_monitor::CurrentStateMonitorPtr getSharedStateMonitor(const robot_model::RobotModelConstPtr &kmodel, const boost::shared_ptr<tf::Transformer> &tf)
 {
   SharedStorage &s = getSharedStorage();
@@ -110,5 +157,126 @@ planning_scene_monitor::CurrentStateMonitorPtr getSharedStateMonitor(const robot
   }
 }
 
+boost::shared_ptr<void> getSharedObject(const std::string &key, const boost::function<boost::shared_ptr<void>()> &allocator)
+{
+  SharedStorage &s = getSharedStorage();
+  {
+    boost::mutex::scoped_lock slock(s.lock_);
+    std::map<std::string, boost::shared_ptr<void> >::const_iterator it = s.objects_.find(key);
+    if (it != s.objects_.end())
+      return it->second;
+  }
+
+  // construct the object without holding the lock, since the allocator may need other shared objects;
+  // if another thread constructed the same object in the meantime, that one is kept
+  boost::shared_ptr<void> object = allocator();
+  // allocation failures are not remembered, so a later request can try again
+  if (!object)
+    return object;
+  boost::mutex::scoped_lock slock(s.lock_);
+  return s.objects_.insert(std::make_pair(key, object)).first->second;
+}
+
+ros::CallbackQueueInterface* getSharedCallbackQueue()
+{
+  SharedStorage &s = getSharedStorage();
+  boost::mutex::scoped_lock slock(s.lock_);
+  if (!s.spinner_)
+  {
+    s.spinner_.reset(new ros::AsyncSpinner(1, &s.queue_));
+    s.spinner_->start();
+  }
+  return &s.queue_;
+}
+
+std::string getSharedMoveGroupObjectKey(const std::string &type, const std::string &name, const std::string &move_group_ns)
+{
+  std::string ns;
+  for (std::size_t i = 0 ; i < move_group_ns.size() ; ++i)
+    if (move_group_ns[i] != '/' || ns.empty() || ns[ns.size() - 1] != '/')
+      ns += move_group_ns[i];
+  if (ns.size() > 1 && ns[ns.size() - 1] == '/')
+    ns.erase(ns.size() - 1);
+  return type + ":" + name + ":" + ns;
+}
+
+planning_scene_monitor::PlanningSceneMonitorPtr getSharedPlanningSceneMonitor(const std::string &robot_description, const boost::shared_ptr<tf::Transformer> &tf,
+                                                                              const std::string &move_group_ns)
+{
+  return boost::static_pointer_cast<planning_scene_monitor::PlanningSceneMonitor>(getSharedObject(getSharedMoveGroupObjectKey("planning_scene_monitor", robot_description, move_group_ns),
+                                                                                                    boost::bind(&allocatePlanningSceneMonitor, robot_description, tf, move_group_ns)));
+}
+
+planning_pipeline::PlanningPipelinePtr getSharedPlanningPipeline(const robot_model::RobotModelConstPtr &kmodel, const ros::NodeHandle &node_handle)
+{
+  return boost::static_pointer_cast<planning_pipeline::PlanningPipeline>(getSharedObject(getSharedMoveGroupObjectKey("planning_pipeline", kmodel->getName(), node_handle.getNamespace()),
+                                                                                         boost::bind(&allocatePlanningPipeline, kmodel, node_handle)));
+}
+
+namespace
+{
+// keeps the scene locked for as long as the copy is being made, even if copying throws
+class SceneCopyLock
+{
+public:
+  SceneCopyLock(const boost::function<void()> &lock_scene, const boost::function<void()> &unlock_scene) :
+    unlock_scene_(unlock_scene)
+  {
+    lock_scene();
+  }
+
+  ~SceneCopyLock()
+  {
+    unlock_scene_();
+  }
+
+private:
+  boost::function<void()> unlock_scene_;
+};
+
+bool generatePlanWithPipeline(const planning_pipeline::PlanningPipelinePtr &pipeline, const planning_scene::PlanningSceneConstPtr &scene,
+                              const ::planning_interface::MotionPlanRequest &req, ::planning_interface::MotionPlanResponse &res)
+{
+  return pipeline->generatePlan(scene, req, res);
+}
+}
+
+void generatePlanOnSceneCopy(const planning_scene::PlanningScenePtr &scene, const boost::function<void()> &lock_scene, const boost::function<void()> &unlock_scene,
+                             const GeneratePlanFn &generate_plan, const ::planning_interface::MotionPlanRequest &req, ::planning_interface::MotionPlanResponse &res)
+{
+  try
+  {
+    planning_scene::PlanningScenePtr copy;
+    {
+      SceneCopyLock slock(lock_scene, unlock_scene);
+      copy = planning_scene::PlanningScene::clone(scene);
+    }
+    generate_plan(copy, req, res);
+  }
+  catch(std::runtime_error &ex)
+  {
+    ROS_ERROR("Planning pipeline threw an exception: %s", ex.what());
+    res.error_code_.val = moveit_msgs::MoveItErrorCodes::FAILURE;
+  }
+  catch(...)
+  {
+    ROS_ERROR("Planning pipeline threw an exception");
+    res.error_code_.val = moveit_msgs::MoveItErrorCodes::FAILURE;
+  }
+}
+
+void generatePlanOnSceneCopy(const planning_scene_monitor::PlanningSceneMonitorPtr &monitor, const planning_pipeline::PlanningPipelinePtr &pipeline,
+                             const ::planning_interface::MotionPlanRequest &req, ::planning_interface::MotionPlanResponse &res)
+{
+  // the scene starts from the default state until the first joint states arrive; the wait returns immediately once the state is known
+  if (!monitor->getStateMonitor()->waitForCurrentState(req.group_name, 1.0))
+    ROS_WARN("Planning locally but the full current state of the robot is not known");
+  monitor->updateSceneWithCurrentState();
+
+  generatePlanOnSceneCopy(monitor->getPlanningScene(), boost::bind(&planning_scene_monitor::PlanningSceneMonitor::lockSceneRead, monitor.get()),
+                          boost::bind(&planning_scene_monitor::PlanningSceneMonitor::unlockSceneRead, monitor.get()),
+                          boost::bind(&generatePlanWithPipeline, pipeline, _1, _2, _3), req, res);
+}
+
 } // namespace planning_interface
 } // namespace moveit
@@ -0,0 +1,210 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/common_planning_interface_objects/common_objects.h>
+#include <geometric_shapes/shapes.h>
+#include <urdf_parser/urdf_parser.h>
+#include <stdexcept>
+
+static const char *URDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"one_link_arm\">"
+  "<link name=\"base_link\"/>"
+  "<joint name=\"joint_1\" type=\"revolute\">"
+  "  <axis xyz=\"0 0 1\"/>"
+  "  <limit effort=\"10.0\" lower=\"-3.0\" upper=\"3.0\" velocity=\"1.0\"/>"
+  "  <parent link=\"base_link\"/>"
+  "  <child link=\"link_1\"/>"
+  "  <origin rpy=\"0 0 0\" xyz=\"0 0 0.1\"/>"
+  "</joint>"
+  "<link name=\"link_1\"/>"
+  "</robot>";
+
+static const char *SRDF_STR =
+  "<?xml version=\"1.0\" ?>"
+  "<robot name=\"one_link_arm\">"
+  "<group name=\"arm\">"
+  "<joint name=\"joint_1\"/>"
+  "</group>"
+  "</robot>";
+
+static robot_model::RobotModelPtr getModel()
+{
+  static robot_model::RobotModelPtr model;
+  if (!model)
+  {
+    boost::shared_ptr<urdf::ModelInterface> urdf(urdf::parseURDF(URDF_STR));
+    boost::shared_ptr<srdf::Model> srdf(new srdf::Model());
+    srdf->initString(*urdf, SRDF_STR);
+    model.reset(new robot_model::RobotModel(urdf, srdf));
+  }
+  return model;
+}
+
+namespace
+{
+
+// stands in for the lock of a planning scene monitor
+struct StubSceneLock
+{
+  StubSceneLock() : locked_(false), lock_count_(0)
+  {
+  }
+
+  void lock()
+  {
+    locked_ = true;
+    ++lock_count_;
+  }
+
+  void unlock()
+  {
+    locked_ = false;
+  }
+
+  bool locked_;
+  unsigned int lock_count_;
+};
+
+// stands in for a planning pipeline; while "planning", the scene of the monitor keeps changing
+struct StubPipeline
+{
+  StubPipeline(const planning_scene::PlanningScenePtr &monitored_scene, const StubSceneLock *lock) :
+    monitored_scene_(monitored_scene),
+    lock_(lock),
+    locked_while_planning_(false),
+    sees_concurrent_update_(false),
+    throw_(false)
+  {
+  }
+
+  bool generatePlan(const planning_scene::PlanningSceneConstPtr &scene, const planning_interface::MotionPlanRequest &req,
+                    planning_interface::MotionPlanResponse &res)
+  {
+    planned_scene_ = scene;
+    locked_while_planning_ = lock_->locked_;
+    monitored_scene_->getWorldNonConst()->addToObject("box", shapes::ShapeConstPtr(new shapes::Box(0.1, 0.1, 0.1)), Eigen::Affine3d::Identity());
+    sees_concurrent_update_ = scene->getWorld()->hasObject("box");
+    if (throw_)
+      throw std::runtime_error("stub pipeline failure");
+    res.error_code_.val = moveit_msgs::MoveItErrorCodes::SUCCESS;
+    return true;
+  }
+
+  planning_scene::PlanningScenePtr monitored_scene_;
+  const StubSceneLock *lock_;
+  planning_scene::PlanningSceneConstPtr planned_scene_;
+  bool locked_while_planning_;
+  bool sees_concurrent_update_;
+  bool throw_;
+};
+
+boost::shared_ptr<void> countAllocation(unsigned int *count)
+{
+  ++*count;
+  return boost::shared_ptr<void>(new int(*count));
+}
+
+}
+
+TEST(CommonObjects, PlansOnSceneCopy)
+{
+  planning_scene::PlanningScenePtr scene(new planning_scene::PlanningScene(getModel()));
+  StubSceneLock lock;
+  StubPipeline pipeline(scene, &lock);
+
+  planning_interface::MotionPlanRequest req;
+  req.group_name = "arm";
+  planning_interface::MotionPlanResponse res;
+  moveit::planning_interface::generatePlanOnSceneCopy(scene, boost::bind(&StubSceneLock::lock, &lock), boost::bind(&StubSceneLock::unlock, &lock),
+                                                      boost::bind(&StubPipeline::generatePlan, &pipeline, _1, _2, _3), req, res);
+
+  EXPECT_EQ(moveit_msgs::MoveItErrorCodes::SUCCESS, res.error_code_.val);
+  ASSERT_TRUE(pipeline.planned_scene_);
+  EXPECT_NE(scene.get(), pipeline.planned_scene_.get());
+  // the scene is only locked for making the copy, and updates of the monitored scene do not show up in the copy
+  EXPECT_EQ(1u, lock.lock_count_);
+  EXPECT_FALSE(pipeline.locked_while_planning_);
+  EXPECT_FALSE(lock.locked_);
+  EXPECT_TRUE(scene->getWorld()->hasObject("box"));
+  EXPECT_FALSE(pipeline.sees_concurrent_update_);
+}
+
+TEST(CommonObjects, PipelineExceptionsAreFailures)
+{
+  planning_scene::PlanningScenePtr scene(new planning_scene::PlanningScene(getModel()));
+  StubSceneLock lock;
+  StubPipeline pipeline(scene, &lock);
+  pipeline.throw_ = true;
+
+  planning_interface::MotionPlanRequest req;
+  req.group_name = "arm";
+  planning_interface::MotionPlanResponse res;
+  moveit::planning_interface::generatePlanOnSceneCopy(scene, boost::bind(&StubSceneLock::lock, &lock), boost::bind(&StubSceneLock::unlock, &lock),
+                                                      boost::bind(&StubPipeline::generatePlan, &pipeline, _1, _2, _3), req, res);
+
+  EXPECT_EQ(moveit_msgs::MoveItErrorCodes::FAILURE, res.error_code_.val);
+  EXPECT_FALSE(lock.locked_);
+}
+
+TEST(CommonObjects, OneMonitorPerMoveGroupNamespace)
+{
+  using moveit::planning_interface::getSharedMoveGroupObjectKey;
+  using moveit::planning_interface::getSharedObject;
+
+  const std::string key = getSharedMoveGroupObjectKey("planning_scene_monitor", "robot_description", "/left/move_group");
+  EXPECT_EQ(key, getSharedMoveGroupObjectKey("planning_scene_monitor", "robot_description", "/left/move_group/"));
+  EXPECT_EQ(key, getSharedMoveGroupObjectKey("planning_scene_monitor", "robot_description", "//left//move_group"));
+  EXPECT_NE(key, getSharedMoveGroupObjectKey("planning_scene_monitor", "robot_description", "/right/move_group"));
+  EXPECT_NE(key, getSharedMoveGroupObjectKey("planning_scene_monitor", "other_robot_description", "/left/move_group"));
+  EXPECT_NE(key, getSharedMoveGroupObjectKey("planning_pipeline", "robot_description", "/left/move_group"));
+  EXPECT_EQ("planning_scene_monitor:robot_description:/", getSharedMoveGroupObjectKey("planning_scene_monitor", "robot_description", "/"));
+
+  unsigned int allocations = 0;
+  boost::shared_ptr<void> left = getSharedObject(key, boost::bind(&countAllocation, &allocations));
+  boost::shared_ptr<void> left_again = getSharedObject(getSharedMoveGroupObjectKey("planning_scene_monitor", "robot_description", "/left/move_group/"),
+                                                       boost::bind(&countAllocation, &allocations));
+  boost::shared_ptr<void> right = getSharedObject(getSharedMoveGroupObjectKey("planning_scene_monitor", "robot_description", "/right/move_group"),
+                                                  boost::bind(&countAllocation, &allocations));
+  EXPECT_EQ(2u, allocations);
+  EXPECT_EQ(left.get(), left_again.get());
+  EXPECT_NE(left.get(), right.get());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
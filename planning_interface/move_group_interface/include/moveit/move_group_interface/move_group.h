@@ -47,7 +47,14 @@
 #include <moveit_msgs/PlaceLocation.h>
 #include <geometry_msgs/PoseStamped.h>
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <tf/tf.h>
+#include <ros/time.h>
+#include <ros/init.h>
 
 namespace moveit
 {
@@ -65,6 +72,196 @@ public:
   operator bool() const { return val == moveit_msgs::MoveItErrorCodes::SUCCESS; }
 };
 
+/** \brief The value of futures for operations that only report an error code */
+struct NoResult
+{
+};
+
+/** \brief Run \e callback on the thread that runs the done callbacks of all instances of MoveGroupFuture. The callbacks run
+    one at a time, in the order they were passed to this function. */
+void runFutureCallback(const boost::function<void()> &callback);
+
+/** \brief A handle to an operation started by one of the MoveGroup::start*() functions. The operation produces an error code and,
+    if it succeeds, a value of type \e T. Copies of a future refer to the same operation. */
+template<typename T>
+class MoveGroupFuture
+{
+public:
+
+  /** \brief The type of the callbacks called when the operation completes */
+  typedef boost::function<void(const MoveItErrorCode&, const T&)> DoneCallback;
+
+  /** \brief The state shared by the copies of a future; it is completed by MoveGroup */
+  class State : private boost::noncopyable
+  {
+  public:
+
+    State() : done_(false), code_(moveit_msgs::MoveItErrorCodes::FAILURE)
+    {
+    }
+
+    /** \brief Set the function that cancels the operation. Ignored if the operation is already complete. */
+    void setCancelFunction(const boost::function<void()> &cancel)
+    {
+      boost::mutex::scoped_lock slock(lock_);
+      if (!done_)
+        cancel_ = cancel;
+    }
+
+    /** \brief Mark the operation as complete. Only the first call has an effect. */
+    void complete(const MoveItErrorCode &code, const T &value)
+    {
+      std::vector<DoneCallback> callbacks;
+      {
+        boost::mutex::scoped_lock slock(lock_);
+        if (done_)
+          return;
+        code_ = code;
+        value_ = value;
+        done_ = true;
+        cancel_ = boost::function<void()>();
+        callbacks.swap(callbacks_);
+        condition_.notify_all();
+      }
+      // operations are completed from the threads that process ROS callbacks; the done callbacks run elsewhere, since
+      // they may wait for other operations, which needs those threads
+      for (std::size_t i = 0 ; i < callbacks.size() ; ++i)
+        runFutureCallback(boost::bind(callbacks[i], code_, value_));
+    }
+
+    bool isDone()
+    {
+      boost::mutex::scoped_lock slock(lock_);
+      return done_;
+    }
+
+    bool wait(const ros::WallDuration &timeout)
+    {
+      ros::WallTime final_time = ros::WallTime::now() + timeout;
+      boost::mutex::scoped_lock slock(lock_);
+      while (!done_ && !ros::isShuttingDown())
+      {
+        ros::WallDuration time_left = final_time - ros::WallTime::now();
+        if (timeout != ros::WallDuration() && time_left <= ros::WallDuration())
+          break;
+        // check every now and then if ROS is still running
+        if (timeout == ros::WallDuration() || time_left > ros::WallDuration(0.5))
+          time_left = ros::WallDuration(0.5);
+        condition_.timed_wait(slock, boost::posix_time::microseconds(time_left.toNSec() / 1000));
+      }
+      return done_;
+    }
+
+    void cancel()
+    {
+      boost::function<void()> cancel;
+      {
+        boost::mutex::scoped_lock slock(lock_);
+        cancel = cancel_;
+      }
+      if (cancel)
+        cancel();
+    }
+
+    void addDoneCallback(const DoneCallback &callback)
+    {
+      {
+        boost::mutex::scoped_lock slock(lock_);
+        if (!done_)
+        {
+          callbacks_.push_back(callback);
+          return;
+        }
+      }
+      runFutureCallback(boost::bind(callback, code_, value_));
+    }
+
+    /* only valid once done */
+    const MoveItErrorCode& getErrorCode() const
+    {
+      return code_;
+    }
+
+    const T& getValue() const
+    {
+      return value_;
+    }
+
+  private:
+
+    boost::mutex lock_;
+    boost::condition_variable condition_;
+    bool done_;
+    MoveItErrorCode code_;
+    T value_;
+    boost::function<void()> cancel_;
+    std::vector<DoneCallback> callbacks_;
+  };
+
+  /** \brief Construct a future that does not refer to any operation */
+  MoveGroupFuture()
+  {
+  }
+
+  explicit MoveGroupFuture(const boost::shared_ptr<State> &state) : state_(state)
+  {
+  }
+
+  /** \brief Check if this future refers to an operation */
+  bool valid() const
+  {
+    return state_.get() != NULL;
+  }
+
+  /** \brief Check if the operation completed */
+  bool isReady() const
+  {
+    return state_ && state_->isDone();
+  }
+
+  /** \brief Wait for the operation to complete, for at most \e timeout (a zero timeout means no limit). Return true if the operation completed. */
+  bool wait(const ros::WallDuration &timeout = ros::WallDuration()) const
+  {
+    return state_ && state_->wait(timeout);
+  }
+
+  /** \brief Wait for the operation to complete and return its error code. FAILURE is reported if the operation did not complete (ROS was shut down). */
+  MoveItErrorCode getErrorCode() const
+  {
+    if (!wait())
+      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+    return state_->getErrorCode();
+  }
+
+  /** \brief Wait for the operation to complete and return the value it produced. The value is only meaningful if the error code reports success.
+      The future must be valid. */
+  const T& getValue() const
+  {
+    wait();
+    return state_->getValue();
+  }
+
+  /** \brief Request the operation to be cancelled. The future still completes, typically with an error code. */
+  void cancel()
+  {
+    if (state_)
+      state_->cancel();
+  }
+
+  /** \brief Call \e callback when the operation completes (or now, if it is already complete). Callbacks run on a thread dedicated
+      to the done callbacks of all futures, one at a time, so they may call blocking functions such as MoveGroup::move(); a callback
+      that blocks delays the ones after it. */
+  void addDoneCallback(const DoneCallback &callback)
+  {
+    if (state_)
+      state_->addDoneCallback(callback);
+  }
+
+private:
+
+  boost::shared_ptr<State> state_;
+};
+
 /** \brief Client class for the MoveGroup action. This class includes many default settings to make things easy to use. */
 class MoveGroup
 {
@@ -81,7 +278,9 @@ public:
 	    const ros::NodeHandle &node_handle = ros::NodeHandle()) :
       group_name_(group_name),
       robot_description_(desc),
-      node_handle_(node_handle)
+      node_handle_(node_handle),
+      plan_locally_(false),
+      move_group_ns_("move_group")
     {
     }
 
@@ -95,6 +294,13 @@ public:
     robot_model::RobotModelConstPtr robot_model_;
 
     ros::NodeHandle node_handle_;
+
+    /// If true, motion plans are computed in this process, by a planning pipeline configured like the one of move_group and against a local copy
+    /// of the planning scene maintained by move_group. If local planning cannot be set up, plans are requested from move_group as usual.
+    bool plan_locally_;
+
+    /// The namespace of the move_group node (relative to \e node_handle_); the local planning pipeline reads its configuration from here
+    std::string move_group_ns_;
   };
 
   /// The representation of a motion plan (as ROS messasges)
@@ -110,6 +316,29 @@ public:
     double planning_time_;
   };
 
+  /// The representation of a Cartesian path (as ROS messages)
+  struct CartesianPath
+  {
+    CartesianPath() : fraction_(-1.0)
+    {
+    }
+
+    /// The trajectory of the robot along the waypoints
+    moveit_msgs::RobotTrajectory trajectory_;
+
+    /// The fraction of the path (as described by the waypoints) that was achieved, or -1.0 in case of error
+    double fraction_;
+  };
+
+  /// A future for the computation of a motion plan
+  typedef MoveGroupFuture<Plan> PlanFuture;
+
+  /// A future for the computation of a Cartesian path
+  typedef MoveGroupFuture<CartesianPath> CartesianPathFuture;
+
+  /// A future for operations that move the robot (move, execute, pick and place)
+  typedef MoveGroupFuture<NoResult> ExecutionFuture;
+
   /** \brief Construct a client for the MoveGroup action using a specified set of options \e opt. Optionally, specify a TF instance to use.
       If not specified, one will be constructed internally. A timeout for connecting to the action server can also be specified. If it is not specified,
       the wait time is unlimited. */
@@ -590,6 +819,27 @@ public:
   double computeCartesianPath(const std::vector<geometry_msgs::Pose> &waypoints, double eef_step, double jump_threshold,
                               moveit_msgs::RobotTrajectory &trajectory, bool avoid_collisions = true, moveit_msgs::MoveItErrorCodes *error_code = NULL);
 
+  /** \brief Start computing a motion plan that takes the group declared in the constructor from the current state to the specified
+      target and return without waiting. Plans for this and other groups can be computed concurrently. Cancelling the future preempts the planning request.
+      When planning locally (see Options::plan_locally_), cancelling interrupts all the plans the local pipeline is computing. */
+  PlanFuture startPlan();
+
+  /** \brief Start planning and executing a trajectory to the specified target and return without waiting. Cancelling the future preempts the request. */
+  ExecutionFuture startMove();
+
+  /** \brief Start executing \e plan and return without waiting. Cancelling the future stops trajectory execution (as stop() does). */
+  ExecutionFuture startExecute(const Plan &plan);
+
+  /** \brief Start computing a Cartesian path (see computeCartesianPath()) and return without waiting. This computation cannot be cancelled. */
+  CartesianPathFuture startComputeCartesianPath(const std::vector<geometry_msgs::Pose> &waypoints, double eef_step, double jump_threshold,
+                                                bool avoid_collisions = true);
+
+  /** \brief Start picking up an object given possible grasp poses and return without waiting. Cancelling the future preempts the request. */
+  ExecutionFuture startPick(const std::string &object, const std::vector<moveit_msgs::Grasp> &grasps);
+
+  /** \brief Start placing an object at one of the specified possible locations and return without waiting. Cancelling the future preempts the request. */
+  ExecutionFuture startPlace(const std::string &object, const std::vector<moveit_msgs::PlaceLocation> &locations);
+
   /** \brief Stop any trajectory execution, if one is active */
   void stop();
 
@@ -54,7 +54,7 @@
 #include <moveit_msgs/QueryPlannerInterfaces.h>
 #include <moveit_msgs/GetCartesianPath.h>
 
-#include <actionlib/client/simple_action_client.h>
+#include <actionlib/client/action_client.h>
 #include <eigen_conversions/eigen_msg.h>
 #include <std_msgs/String.h>
 #include <tf/transform_listener.h>
@@ -62,6 +62,8 @@
 #include <tf_conversions/tf_eigen.h>
 #include <ros/console.h>
 #include <ros/ros.h>
+#include <boost/thread.hpp>
+#include <deque>
 
 namespace moveit
 {
@@ -73,11 +75,178 @@ const std::string MoveGroup::ROBOT_DESCRIPTION = "robot_description";    // name
 namespace
 {
 
+/* Runs the done callbacks of futures on a thread of its own */
+class FutureCallbackExecutor
+{
+public:
+
+  static FutureCallbackExecutor& instance()
+  {
+    // never destroyed, since callbacks may still be posted while static objects are destroyed
+    static FutureCallbackExecutor *executor = new FutureCallbackExecutor();
+    return *executor;
+  }
+
+  void post(const boost::function<void()> &callback)
+  {
+    boost::mutex::scoped_lock slock(lock_);
+    callbacks_.push_back(callback);
+    condition_.notify_one();
+  }
+
+private:
+
+  FutureCallbackExecutor() : thread_(boost::bind(&FutureCallbackExecutor::run, this))
+  {
+  }
+
+  void run()
+  {
+    while (true)
+    {
+      boost::function<void()> callback;
+      {
+        boost::mutex::scoped_lock slock(lock_);
+        while (callbacks_.empty())
+          condition_.wait(slock);
+        callback = callbacks_.front();
+        callbacks_.pop_front();
+      }
+      try
+      {
+        callback();
+      }
+      catch(std::exception &ex)
+      {
+        ROS_ERROR("The done callback of a MoveGroup future threw an exception: %s", ex.what());
+      }
+    }
+  }
+
+  boost::mutex lock_;
+  boost::condition_variable condition_;
+  std::deque<boost::function<void()> > callbacks_;
+  boost::thread thread_;
+};
+
 enum ActiveTargetType
 {
   JOINT, POSE, POSITION, ORIENTATION
 };
 
+/* Complete the future of a goal once the goal is done; \e extract (if specified) fills in the value of the future from the result of a successful goal */
+template<typename ActionSpec, typename T>
+void goalTransition(const boost::shared_ptr<typename MoveGroupFuture<T>::State> &state,
+                    void (*extract)(const typename ActionSpec::_action_result_type::_result_type&, T&),
+                    actionlib::ClientGoalHandle<ActionSpec> gh)
+{
+  if (gh.getCommState() != actionlib::CommState::DONE)
+    return;
+  actionlib::TerminalState terminal_state = gh.getTerminalState();
+  boost::shared_ptr<const typename ActionSpec::_action_result_type::_result_type> result = gh.getResult();
+  T value;
+  if (terminal_state == actionlib::TerminalState::SUCCEEDED)
+  {
+    if (result && extract)
+      extract(*result, value);
+  }
+  else
+    ROS_WARN_STREAM("Fail: " << terminal_state.toString() << ": " << terminal_state.getText());
+  state->complete(result ? MoveItErrorCode(result->error_code) : MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE), value);
+}
+
+template<typename ActionSpec>
+void cancelGoal(actionlib::ClientGoalHandle<ActionSpec> gh)
+{
+  gh.cancel();
+}
+
+/* Send a goal through one of the shared action clients; the returned future completes when the goal is done */
+template<typename ActionSpec, typename T>
+MoveGroupFuture<T> sendGoal(actionlib::ActionClient<ActionSpec> &client, const typename ActionSpec::_action_goal_type::_goal_type &goal,
+                            void (*extract)(const typename ActionSpec::_action_result_type::_result_type&, T&))
+{
+  boost::shared_ptr<typename MoveGroupFuture<T>::State> state(new typename MoveGroupFuture<T>::State());
+  actionlib::ClientGoalHandle<ActionSpec> gh = client.sendGoal(goal, boost::bind(&goalTransition<ActionSpec, T>, state, extract, _1));
+
+  // the cancel function holds the goal handle, which keeps the goal tracked until it is done;
+  // completing the future releases the cancel function, so no ownership cycle remains after that
+  state->setCancelFunction(boost::bind(&cancelGoal<ActionSpec>, gh));
+  return MoveGroupFuture<T>(state);
+}
+
+template<typename T>
+MoveGroupFuture<T> failedFuture()
+{
+  boost::shared_ptr<typename MoveGroupFuture<T>::State> state(new typename MoveGroupFuture<T>::State());
+  state->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE), T());
+  return MoveGroupFuture<T>(state);
+}
+
+void extractPlan(const moveit_msgs::MoveGroupResult &result, MoveGroup::Plan &plan)
+{
+  plan.trajectory_ = result.planned_trajectory;
+  plan.start_state_ = result.trajectory_start;
+  plan.planning_time_ = result.planning_time;
+}
+
+void callExecuteService(ros::ServiceClient client, moveit_msgs::ExecuteKnownTrajectory::Request req,
+                        const boost::shared_ptr<MoveGroup::ExecutionFuture::State> &state)
+{
+  moveit_msgs::ExecuteKnownTrajectory::Response res;
+  if (client.call(req, res))
+    state->complete(MoveItErrorCode(res.error_code), NoResult());
+  else
+    state->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE), NoResult());
+}
+
+void callCartesianPathService(ros::ServiceClient client, moveit_msgs::GetCartesianPath::Request req,
+                              const boost::shared_ptr<MoveGroup::CartesianPathFuture::State> &state)
+{
+  moveit_msgs::GetCartesianPath::Response res;
+  MoveGroup::CartesianPath path;
+  if (client.call(req, res))
+  {
+    if (res.error_code.val == moveit_msgs::MoveItErrorCodes::SUCCESS)
+    {
+      path.trajectory_ = res.solution;
+      path.fraction_ = res.fraction;
+    }
+    state->complete(MoveItErrorCode(res.error_code), path);
+  }
+  else
+    state->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE), path);
+}
+
+void planLocally(const planning_scene_monitor::PlanningSceneMonitorPtr &planning_scene_monitor, const planning_pipeline::PlanningPipelinePtr &planning_pipeline,
+                 const moveit_msgs::MotionPlanRequest &req, const boost::shared_ptr<MoveGroup::PlanFuture::State> &state)
+{
+  // plan on a copy, so the monitor can keep applying scene and state updates while planning
+  ::planning_interface::MotionPlanResponse res;
+  generatePlanOnSceneCopy(planning_scene_monitor, planning_pipeline, req, res);
+
+  MoveGroup::Plan plan;
+  if (res.trajectory_ && !res.trajectory_->empty())
+  {
+    robot_state::robotStateToRobotStateMsg(res.trajectory_->getFirstWayPoint(), plan.start_state_);
+    res.trajectory_->getRobotTrajectoryMsg(plan.trajectory_);
+  }
+  plan.planning_time_ = res.planning_time_;
+  state->complete(MoveItErrorCode(res.error_code_), plan);
+}
+
+void publishStopEvent(ros::Publisher publisher)
+{
+  std_msgs::String event;
+  event.data = "stop";
+  publisher.publish(event);
+}
+
+}
+
+void runFutureCallback(const boost::function<void()> &callback)
+{
+  FutureCallbackExecutor::instance().post(callback);
 }
 
 class MoveGroup::MoveGroupImpl
@@ -127,58 +296,63 @@ public:
     
     current_state_monitor_ = getSharedStateMonitor(robot_model_, tf_);
     
-    move_action_client_.reset(new actionlib::SimpleActionClient<moveit_msgs::MoveGroupAction>(node_handle_,
-                                                                                              move_group::MOVE_ACTION,
-                                                                                              false));
-    waitForAction(move_action_client_, wait_for_server, move_group::MOVE_ACTION);
-    
-    pick_action_client_.reset(new actionlib::SimpleActionClient<moveit_msgs::PickupAction>(node_handle_,
-                                                                                           move_group::PICKUP_ACTION,
-                                                                                           false));
-    waitForAction(pick_action_client_, wait_for_server, move_group::PICKUP_ACTION);
-    
-    place_action_client_.reset(new actionlib::SimpleActionClient<moveit_msgs::PlaceAction>(node_handle_,
-                                                                                           move_group::PLACE_ACTION,
-                                                                                           false));
-    waitForAction(place_action_client_, wait_for_server, move_group::PLACE_ACTION);
+    // the action clients are shared by all MoveGroup instances in this process; they all connect
+    // concurrently, so waiting for them in turn takes as long as the slowest connection
+    move_action_client_ = getSharedActionClient<moveit_msgs::MoveGroupAction>(node_handle_, move_group::MOVE_ACTION);
+    pick_action_client_ = getSharedActionClient<moveit_msgs::PickupAction>(node_handle_, move_group::PICKUP_ACTION);
+    place_action_client_ = getSharedActionClient<moveit_msgs::PlaceAction>(node_handle_, move_group::PLACE_ACTION);
+
+    // in case ROS time is published, wait for the time data to arrive
+    ros::Time::waitForValid();
+    ros::Time final_time = wait_for_server == ros::Duration(0, 0) ? ros::Time() : ros::Time::now() + wait_for_server;
+    waitForAction(move_action_client_, final_time, move_group::MOVE_ACTION);
+    waitForAction(pick_action_client_, final_time, move_group::PICKUP_ACTION);
+    waitForAction(place_action_client_, final_time, move_group::PLACE_ACTION);
     
     execute_service_ = node_handle_.serviceClient<moveit_msgs::ExecuteKnownTrajectory>(move_group::EXECUTE_SERVICE_NAME);
     query_service_ = node_handle_.serviceClient<moveit_msgs::QueryPlannerInterfaces>(move_group::QUERY_PLANNERS_SERVICE_NAME);
     cartesian_path_service_ = node_handle_.serviceClient<moveit_msgs::GetCartesianPath>(move_group::CARTESIAN_PATH_SERVICE_NAME);
     
+    if (opt.plan_locally_)
+      initializeLocalPlanning();
+
     ROS_INFO_STREAM("Ready to take MoveGroup commands for group " << opt.group_name_ << ".");
   }
 
-  template<typename T>
-  void waitForAction(const T &action, const ros::Duration &wait_for_server, const std::string &name)
+  void initializeLocalPlanning()
   {
-    ROS_DEBUG("Waiting for MoveGroup action server (%s)...", name.c_str());
-
-    // in case ROS time is published, wait for the time data to arrive
-    ros::Time start_time = ros::Time::now();
-    while (start_time == ros::Time::now())
+    planning_scene_monitor_ = getSharedPlanningSceneMonitor(opt_.robot_description_, tf_, node_handle_.resolveName(opt_.move_group_ns_));
+    if (!planning_scene_monitor_)
     {
-      ros::WallDuration(0.01).sleep();
-      ros::spinOnce();
+      ROS_WARN("Unable to monitor the planning scene locally. Plans will be computed by move_group.");
+      return;
     }
 
-    // wait for the server (and spin as needed)
-    if (wait_for_server == ros::Duration(0, 0))
+    // the pipeline uses the model of the monitored scene, which may differ from a model passed in the options
+    planning_pipeline_ = getSharedPlanningPipeline(planning_scene_monitor_->getRobotModel(), ros::NodeHandle(node_handle_, opt_.move_group_ns_));
+    if (!planning_pipeline_->getPlannerManager())
     {
-      while (node_handle_.ok() && !action->isServerConnected())
-      {
-        ros::WallDuration(0.02).sleep();
-        ros::spinOnce();
-      }
+      ROS_WARN_STREAM("Unable to load planning plugin '" << planning_pipeline_->getPlannerPluginName() << "' locally. Plans will be computed by move_group.");
+      planning_pipeline_.reset();
+      planning_scene_monitor_.reset();
     }
+    else
+      ROS_DEBUG_STREAM("Planning locally for group " << opt_.group_name_ << " using " << planning_pipeline_->getPlannerPluginName());
+  }
+
+  template<typename T>
+  void waitForAction(const T &action, const ros::Time &final_time, const std::string &name)
+  {
+    ROS_DEBUG("Waiting for MoveGroup action server (%s)...", name.c_str());
+
+    // the client is notified by its own callback thread when the server connects; a zero final time means no limit
+    if (final_time.isZero())
+      action->waitForActionServerToStart();
     else
     {
-      ros::Time final_time = ros::Time::now() + wait_for_server;
-      while (node_handle_.ok() && !action->isServerConnected() && final_time > ros::Time::now())
-      {
-        ros::WallDuration(0.02).sleep();
-        ros::spinOnce();
-      }
+      ros::Duration time_left = final_time - ros::Time::now();
+      if (time_left > ros::Duration(0, 0))
+        action->waitForActionServerToStart(time_left);
     }
 
     if (!action->isServerConnected())
@@ -484,17 +658,17 @@ public:
     return place(object, locations);
   }
 
-  MoveItErrorCode place(const std::string &object, const std::vector<moveit_msgs::PlaceLocation> &locations)
+  ExecutionFuture startPlace(const std::string &object, const std::vector<moveit_msgs::PlaceLocation> &locations)
   {
     if (!place_action_client_)
     {
       ROS_ERROR_STREAM("Place action client not found");
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+      return failedFuture<NoResult>();
     }
     if (!place_action_client_->isServerConnected())
     {
       ROS_ERROR_STREAM("Place action server not connected");
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+      return failedFuture<NoResult>();
     }
     moveit_msgs::PlaceGoal goal;
     constructGoal(goal, object);
@@ -506,34 +680,32 @@ public:
     goal.planning_options.planning_scene_diff.is_diff = true;
     goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
 
-    place_action_client_->sendGoal(goal);
+    ExecutionFuture future = sendGoal<moveit_msgs::PlaceAction, NoResult>(*place_action_client_, goal, NULL);
     ROS_DEBUG("Sent place goal with %d locations", (int) goal.place_locations.size());
-    if (!place_action_client_->waitForResult())
+    return future;
+  }
+
+  MoveItErrorCode place(const std::string &object, const std::vector<moveit_msgs::PlaceLocation> &locations)
+  {
+    ExecutionFuture future = startPlace(object, locations);
+    if (!future.wait())
     {
       ROS_INFO_STREAM("Place action returned early");
     }
-    if (place_action_client_->getState() == actionlib::SimpleClientGoalState::SUCCEEDED)
-    {
-      return MoveItErrorCode(place_action_client_->getResult()->error_code);
-    }
-    else
-    {
-      ROS_WARN_STREAM("Fail: " << place_action_client_->getState().toString() << ": " << place_action_client_->getState().getText());
-      return MoveItErrorCode(place_action_client_->getResult()->error_code);
-    }
+    return future.getErrorCode();
   }
 
-  MoveItErrorCode pick(const std::string &object, const std::vector<moveit_msgs::Grasp> &grasps)
+  ExecutionFuture startPick(const std::string &object, const std::vector<moveit_msgs::Grasp> &grasps)
   {
     if (!pick_action_client_)
     {
       ROS_ERROR_STREAM("Pick action client not found");
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+      return failedFuture<NoResult>();
     }
     if (!pick_action_client_->isServerConnected())
     {
       ROS_ERROR_STREAM("Pick action server not connected");
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+      return failedFuture<NoResult>();
     }
     moveit_msgs::PickupGoal goal;
     constructGoal(goal, object);
@@ -545,31 +717,40 @@ public:
     goal.planning_options.planning_scene_diff.is_diff = true;
     goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
 
-    pick_action_client_->sendGoal(goal);
-    if (!pick_action_client_->waitForResult())
+    return sendGoal<moveit_msgs::PickupAction, NoResult>(*pick_action_client_, goal, NULL);
+  }
+
+  MoveItErrorCode pick(const std::string &object, const std::vector<moveit_msgs::Grasp> &grasps)
+  {
+    ExecutionFuture future = startPick(object, grasps);
+    if (!future.wait())
     {
       ROS_INFO_STREAM("Pickup action returned early");
     }
-    if (pick_action_client_->getState() == actionlib::SimpleClientGoalState::SUCCEEDED)
-    {
-      return MoveItErrorCode(pick_action_client_->getResult()->error_code);
-    }
-    else
-    {
-      ROS_WARN_STREAM("Fail: " << pick_action_client_->getState().toString() << ": " << pick_action_client_->getState().getText());
-      return MoveItErrorCode(pick_action_client_->getResult()->error_code);
-    }
+    return future.getErrorCode();
   }
 
-  MoveItErrorCode plan(Plan &plan)
+  PlanFuture startPlan()
   {
+    if (planning_pipeline_)
+    {
+      moveit_msgs::MoveGroupGoal goal;
+      constructGoal(goal);
+
+      // the pipeline can only terminate all the plans it computes, so cancelling a local plan interrupts other local plans as well
+      boost::shared_ptr<PlanFuture::State> state(new PlanFuture::State());
+      state->setCancelFunction(boost::bind(&planning_pipeline::PlanningPipeline::terminate, planning_pipeline_));
+      boost::thread(boost::bind(&planLocally, planning_scene_monitor_, planning_pipeline_, goal.request, state)).detach();
+      return PlanFuture(state);
+    }
+
     if (!move_action_client_)
     {
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+      return failedFuture<Plan>();
     }
     if (!move_action_client_->isServerConnected())
     {
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+      return failedFuture<Plan>();
     }
 
     moveit_msgs::MoveGroupGoal goal;
@@ -580,34 +761,31 @@ public:
     goal.planning_options.planning_scene_diff.is_diff = true;
     goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
 
-    move_action_client_->sendGoal(goal);
-    if (!move_action_client_->waitForResult())
+    return sendGoal<moveit_msgs::MoveGroupAction, Plan>(*move_action_client_, goal, &extractPlan);
+  }
+
+  MoveItErrorCode plan(Plan &plan)
+  {
+    PlanFuture future = startPlan();
+    if (!future.wait())
     {
       ROS_INFO_STREAM("MoveGroup action returned early");
     }
-    if (move_action_client_->getState() == actionlib::SimpleClientGoalState::SUCCEEDED)
-    {
-      plan.trajectory_ = move_action_client_->getResult()->planned_trajectory;
-      plan.start_state_ = move_action_client_->getResult()->trajectory_start;
-      plan.planning_time_ = move_action_client_->getResult()->planning_time;
-      return MoveItErrorCode(move_action_client_->getResult()->error_code);
-    }
-    else
-    {
-      ROS_WARN_STREAM("Fail: " << move_action_client_->getState().toString() << ": " << move_action_client_->getState().getText());
-      return MoveItErrorCode(move_action_client_->getResult()->error_code);
-    }
+    MoveItErrorCode code = future.getErrorCode();
+    if (code)
+      plan = future.getValue();
+    return code;
   }
 
-  MoveItErrorCode move(bool wait)
+  ExecutionFuture startMove()
   {
     if (!move_action_client_)
     {
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+      return failedFuture<NoResult>();
     }    
     if (!move_action_client_->isServerConnected())
     {
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::FAILURE);
+      return failedFuture<NoResult>();
     }
 
     moveit_msgs::MoveGroupGoal goal;
@@ -619,26 +797,37 @@ public:
     goal.planning_options.planning_scene_diff.is_diff = true;
     goal.planning_options.planning_scene_diff.robot_state.is_diff = true;
 
-    move_action_client_->sendGoal(goal);
+    return sendGoal<moveit_msgs::MoveGroupAction, NoResult>(*move_action_client_, goal, NULL);
+  }
+
+  MoveItErrorCode move(bool wait)
+  {
+    // the goal stays tracked by its future's state until it is done, even if the future is discarded
+    ExecutionFuture future = startMove();
     if (!wait)    
     {
-      return MoveItErrorCode(moveit_msgs::MoveItErrorCodes::SUCCESS);
+      return future.isReady() ? future.getErrorCode() : MoveItErrorCode(moveit_msgs::MoveItErrorCodes::SUCCESS);
     }
 
-    if (!move_action_client_->waitForResult())
+    if (!future.wait())
     {
       ROS_INFO_STREAM("MoveGroup action returned early");
     }
+    return future.getErrorCode();
+  }
 
-    if (move_action_client_->getState() == actionlib::SimpleClientGoalState::SUCCEEDED)
-    {
-      return MoveItErrorCode(move_action_client_->getResult()->error_code);
-    }    
-    else
-    {
-      ROS_INFO_STREAM(move_action_client_->getState().toString() << ": " << move_action_client_->getState().getText());
-      return MoveItErrorCode(move_action_client_->getResult()->error_code);
-    }
+  ExecutionFuture startExecute(const Plan &plan)
+  {
+    moveit_msgs::ExecuteKnownTrajectory::Request req;
+    req.trajectory = plan.trajectory_;
+    req.wait_for_execution = true;
+
+    // the service call blocks until execution completes, so it is made in a thread of its own;
+    // stopping trajectory execution is the only way to cancel it
+    boost::shared_ptr<ExecutionFuture::State> state(new ExecutionFuture::State());
+    state->setCancelFunction(boost::bind(&publishStopEvent, trajectory_event_publisher_));
+    boost::thread(boost::bind(&callExecuteService, execute_service_, req, state)).detach();
+    return ExecutionFuture(state);
   }
 
   MoveItErrorCode execute(const Plan &plan, bool wait)
@@ -657,12 +846,9 @@ public:
     }    
   }
 
-  double computeCartesianPath(const std::vector<geometry_msgs::Pose> &waypoints, double step, double jump_threshold,
-                              moveit_msgs::RobotTrajectory &msg, bool avoid_collisions, moveit_msgs::MoveItErrorCodes &error_code)
+  void constructCartesianPathRequest(const std::vector<geometry_msgs::Pose> &waypoints, double step, double jump_threshold, bool avoid_collisions,
+                                     moveit_msgs::GetCartesianPath::Request &req)
   {
-    moveit_msgs::GetCartesianPath::Request req;
-    moveit_msgs::GetCartesianPath::Response res;
-
     if (considered_start_state_)
       robot_state::robotStateToRobotStateMsg(*considered_start_state_, req.start_state);
     req.group_name = opt_.group_name_;
@@ -672,6 +858,14 @@ public:
     req.max_step = step;
     req.jump_threshold = jump_threshold;
     req.avoid_collisions = avoid_collisions;
+  }
+
+  double computeCartesianPath(const std::vector<geometry_msgs::Pose> &waypoints, double step, double jump_threshold,
+                              moveit_msgs::RobotTrajectory &msg, bool avoid_collisions, moveit_msgs::MoveItErrorCodes &error_code)
+  {
+    moveit_msgs::GetCartesianPath::Request req;
+    moveit_msgs::GetCartesianPath::Response res;
+    constructCartesianPathRequest(waypoints, step, jump_threshold, avoid_collisions, req);
 
     if (cartesian_path_service_.call(req, res))
     {
@@ -691,6 +885,16 @@ public:
     }    
   }
 
+  CartesianPathFuture startComputeCartesianPath(const std::vector<geometry_msgs::Pose> &waypoints, double step, double jump_threshold, bool avoid_collisions)
+  {
+    moveit_msgs::GetCartesianPath::Request req;
+    constructCartesianPathRequest(waypoints, step, jump_threshold, avoid_collisions, req);
+
+    boost::shared_ptr<CartesianPathFuture::State> state(new CartesianPathFuture::State());
+    boost::thread(boost::bind(&callCartesianPathService, cartesian_path_service_, req, state)).detach();
+    return CartesianPathFuture(state);
+  }
+
   void stop()
   {
     if (trajectory_event_publisher_)
@@ -996,9 +1200,11 @@ private:
   boost::shared_ptr<tf::Transformer> tf_;
   robot_model::RobotModelConstPtr robot_model_;
   planning_scene_monitor::CurrentStateMonitorPtr current_state_monitor_;
-  boost::scoped_ptr<actionlib::SimpleActionClient<moveit_msgs::MoveGroupAction> > move_action_client_;
-  boost::scoped_ptr<actionlib::SimpleActionClient<moveit_msgs::PickupAction> > pick_action_client_;
-  boost::scoped_ptr<actionlib::SimpleActionClient<moveit_msgs::PlaceAction> > place_action_client_;
+  boost::shared_ptr<actionlib::ActionClient<moveit_msgs::MoveGroupAction> > move_action_client_;
+  planning_scene_monitor::PlanningSceneMonitorPtr planning_scene_monitor_;
+  planning_pipeline::PlanningPipelinePtr planning_pipeline_;
+  boost::shared_ptr<actionlib::ActionClient<moveit_msgs::PickupAction> > pick_action_client_;
+  boost::shared_ptr<actionlib::ActionClient<moveit_msgs::PlaceAction> > place_action_client_;
 
   // general planning params
   robot_state::RobotStatePtr considered_start_state_;
@@ -1103,6 +1309,37 @@ moveit::planning_interface::MoveItErrorCode moveit::planning_interface::MoveGrou
   return impl_->plan(plan);
 }
 
+moveit::planning_interface::MoveGroup::PlanFuture moveit::planning_interface::MoveGroup::startPlan()
+{
+  return impl_->startPlan();
+}
+
+moveit::planning_interface::MoveGroup::ExecutionFuture moveit::planning_interface::MoveGroup::startMove()
+{
+  return impl_->startMove();
+}
+
+moveit::planning_interface::MoveGroup::ExecutionFuture moveit::planning_interface::MoveGroup::startExecute(const Plan &plan)
+{
+  return impl_->startExecute(plan);
+}
+
+moveit::planning_interface::MoveGroup::CartesianPathFuture moveit::planning_interface::MoveGroup::startComputeCartesianPath(const std::vector<geometry_msgs::Pose> &waypoints, double eef_step,
+                                                                                                                          double jump_threshold, bool avoid_collisions)
+{
+  return impl_->startComputeCartesianPath(waypoints, eef_step, jump_threshold, avoid_collisions);
+}
+
+moveit::planning_interface::MoveGroup::ExecutionFuture moveit::planning_interface::MoveGroup::startPick(const std::string &object, const std::vector<moveit_msgs::Grasp> &grasps)
+{
+  return impl_->startPick(object, grasps);
+}
+
+moveit::planning_interface::MoveGroup::ExecutionFuture moveit::planning_interface::MoveGroup::startPlace(const std::string &object, const std::vector<moveit_msgs::PlaceLocation> &locations)
+{
+  return impl_->startPlace(object, locations);
+}
+
 moveit::planning_interface::MoveItErrorCode moveit::planning_interface::MoveGroup::pick(const std::string &object)
 {
   return impl_->pick(object, std::vector<moveit_msgs::Grasp>());
@@ -44,6 +44,7 @@
 #include <boost/python.hpp>
 #include <boost/shared_ptr.hpp>
 #include <Python.h>
+#include <algorithm>
 
 /** @cond IGNORE */
 
@@ -66,14 +67,14 @@ public:
   {
   }
 
-  bool setJointValueTargetPerJointPythonList(const std::string &joint, bp::list &values)
+  bool setJointValueTargetPerJointPythonList(const std::string &joint, const bp::object &values)
   {
-    return setJointValueTarget(joint, py_bindings_tools::doubleFromList(values));
+    return setJointValueTarget(joint, py_bindings_tools::doubleFromSequence(values));
   }
 
-  bool setJointValueTargetPythonList(bp::list &values)
+  bool setJointValueTargetPythonList(const bp::object &values)
   {
-    return setJointValueTarget(py_bindings_tools::doubleFromList(values));
+    return setJointValueTarget(py_bindings_tools::doubleFromSequence(values));
   }
 
   bool setJointValueTargetPythonDict(bp::dict &values)
@@ -107,9 +108,9 @@ public:
     return setJointValueTarget(js_msg);
   }
 
-  void rememberJointValuesFromPythonList(const std::string &string, bp::list &values)
+  void rememberJointValuesFromPythonList(const std::string &string, const bp::object &values)
   {
-    rememberJointValues(string, py_bindings_tools::doubleFromList(values));
+    rememberJointValues(string, py_bindings_tools::doubleFromSequence(values));
   }
 
   const char* getPlanningFrameCStr() const
@@ -137,6 +138,18 @@ public:
     return py_bindings_tools::listFromDouble(getRandomJointValues());
   }
 
+  bp::object getCurrentJointValuesArray()
+  {
+    std::vector<double> v = getCurrentJointValues();
+    return py_bindings_tools::wrapDoubleArray(v);
+  }
+
+  bp::object getRandomJointValuesArray()
+  {
+    std::vector<double> v = getRandomJointValues();
+    return py_bindings_tools::wrapDoubleArray(v);
+  }
+
   bp::dict getRememberedJointValuesPython() const
   {
     const std::map<std::string, std::vector<double> > &rv = getRememberedJointValues();
@@ -267,7 +280,7 @@ public:
     }
   }
 
-  void setStartStatePython(const std::string &msg_str)
+  void setStartStatePython(const bp::object &msg_str)
   {
     moveit_msgs::RobotState msg;
     py_bindings_tools::deserializeMsg(msg_str, msg);
@@ -336,18 +349,39 @@ public:
     return attachObject(object_name, link_name, py_bindings_tools::stringFromList(touch_links));
   }
 
-  bool executePython(const std::string &plan_str)
+  bool executePython(const bp::object &plan_str)
   {
     MoveGroup::Plan plan;
     py_bindings_tools::deserializeMsg(plan_str, plan.trajectory_);
     return execute(plan);
   }
 
-  std::string getPlanPython()
+  bp::object getPlanPython()
   {
     MoveGroup::Plan plan;
     MoveGroup::plan(plan);
-    return py_bindings_tools::serializeMsg(plan.trajectory_);
+    return py_bindings_tools::serializeMsgToPython(plan.trajectory_);
+  }
+
+  bp::tuple getPlanArraysPython()
+  {
+    MoveGroup::Plan plan;
+    MoveGroup::plan(plan);
+    const trajectory_msgs::JointTrajectory &trajectory = plan.trajectory_.joint_trajectory;
+    std::size_t n = trajectory.points.size();
+    std::size_t m = trajectory.joint_names.size();
+    std::vector<double> times(n);
+    std::vector<double> positions(n * m, 0.0);
+    for (std::size_t i = 0 ; i < n ; ++i)
+    {
+      times[i] = trajectory.points[i].time_from_start.toSec();
+      const std::vector<double> &p = trajectory.points[i].positions;
+      std::copy(p.begin(), p.begin() + std::min(p.size(), m), positions.begin() + i * m);
+    }
+    return bp::make_tuple(py_bindings_tools::serializeMsgToPython(plan.trajectory_),
+                          py_bindings_tools::listFromString(trajectory.joint_names),
+                          py_bindings_tools::wrapDoubleArray(times),
+                          py_bindings_tools::wrapDoubleArray(positions, n));
   }
 
   bp::tuple computeCartesianPathPython(const bp::list &waypoints, double eef_step, double jump_threshold, bool avoid_collisions)
@@ -356,10 +390,10 @@ public:
     convertListToArrayOfPoses(waypoints, poses);
     moveit_msgs::RobotTrajectory trajectory;
     double fraction = computeCartesianPath(poses, eef_step, jump_threshold, trajectory, avoid_collisions);
-    return bp::make_tuple(py_bindings_tools::serializeMsg(trajectory), fraction);
+    return bp::make_tuple(py_bindings_tools::serializeMsgToPython(trajectory), fraction);
   }
 
-  int pickGrasp(const std::string &object, const std::string &grasp_str)
+  int pickGrasp(const std::string &object, const bp::object &grasp_str)
   {
     moveit_msgs::Grasp grasp;
     py_bindings_tools::deserializeMsg(grasp_str, grasp);
@@ -371,22 +405,21 @@ public:
     int l = bp::len(grasp_list);
     std::vector<moveit_msgs::Grasp> grasps(l);
     for (int i = 0; i < l ; ++i)
-      py_bindings_tools::deserializeMsg(bp::extract<std::string>(grasp_list[i]), grasps[i]);
+      py_bindings_tools::deserializeMsg(bp::object(grasp_list[i]), grasps[i]);
     return pick(object, grasps).val;
   }
 
-  void setPathConstraintsFromMsg(const std::string &constraints_str)
+  void setPathConstraintsFromMsg(const bp::object &constraints_str)
   {
       moveit_msgs::Constraints constraints_msg;
       py_bindings_tools::deserializeMsg(constraints_str,constraints_msg);
       setPathConstraints(constraints_msg);
   }
 
-  std::string getPathConstraintsPython()
+  bp::object getPathConstraintsPython()
   {
      moveit_msgs::Constraints constraints_msg(getPathConstraints());
-     std::string constraints_str = py_bindings_tools::serializeMsg(constraints_msg);
-     return constraints_str;
+     return py_bindings_tools::serializeMsgToPython(constraints_msg);
   }
 
 };
@@ -461,6 +494,8 @@ static void wrap_move_group_interface()
   MoveGroupClass.def("start_state_monitor",  &MoveGroupWrapper::startStateMonitor);
   MoveGroupClass.def("get_current_joint_values",  &MoveGroupWrapper::getCurrentJointValuesList);
   MoveGroupClass.def("get_random_joint_values",  &MoveGroupWrapper::getRandomJointValuesList);
+  MoveGroupClass.def("get_current_joint_values_array",  &MoveGroupWrapper::getCurrentJointValuesArray);
+  MoveGroupClass.def("get_random_joint_values_array",  &MoveGroupWrapper::getRandomJointValuesArray);
   MoveGroupClass.def("get_remembered_joint_values",  &MoveGroupWrapper::getRememberedJointValuesPython);
 
   MoveGroupClass.def("forget_joint_values", &MoveGroupWrapper::forgetJointValues);
@@ -489,6 +524,7 @@ static void wrap_move_group_interface()
   MoveGroupClass.def("get_planning_time", &MoveGroupWrapper::getPlanningTime);
   MoveGroupClass.def("set_planner_id", &MoveGroupWrapper::setPlannerId);
   MoveGroupClass.def("compute_plan", &MoveGroupWrapper::getPlanPython);
+  MoveGroupClass.def("compute_plan_arrays", &MoveGroupWrapper::getPlanArraysPython);
   MoveGroupClass.def("compute_cartesian_path", &MoveGroupWrapper::computeCartesianPathPython);
   MoveGroupClass.def("set_support_surface_name", &MoveGroupWrapper::setSupportSurfaceName);
   MoveGroupClass.def("attach_object", &MoveGroupWrapper::attachObjectPython);
@@ -0,0 +1,176 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/move_group_interface/move_group.h>
+#include <boost/thread.hpp>
+
+using moveit::planning_interface::MoveItErrorCode;
+typedef moveit::planning_interface::MoveGroupFuture<int> IntFuture;
+typedef boost::shared_ptr<IntFuture::State> IntStatePtr;
+
+namespace
+{
+
+IntStatePtr makeState()
+{
+  return IntStatePtr(new IntFuture::State());
+}
+
+// pass the result on to another operation, so the test can wait for the callback
+void recordResult(const IntStatePtr &record, boost::thread::id *thread, const MoveItErrorCode &code, const int &value)
+{
+  *thread = boost::this_thread::get_id();
+  record->complete(code, value);
+}
+
+void recordResultOf(IntFuture other, const IntStatePtr &record, const MoveItErrorCode &, const int &)
+{
+  if (other.wait(ros::WallDuration(2.0)))
+    record->complete(other.getErrorCode(), other.getValue());
+  else
+    record->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::TIMED_OUT), 0);
+}
+
+void completeBoth(const IntStatePtr &first, const IntStatePtr &second)
+{
+  first->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::SUCCESS), 1);
+  second->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::SUCCESS), 2);
+}
+
+void completeLater(const IntStatePtr &state, int delay_ms)
+{
+  boost::this_thread::sleep(boost::posix_time::milliseconds(delay_ms));
+  state->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::SUCCESS), 3);
+}
+
+void increment(int *count)
+{
+  ++*count;
+}
+
+}
+
+TEST(MoveGroupFuture, CallsDoneCallbacksWithTheResult)
+{
+  IntStatePtr state = makeState();
+  IntFuture future(state);
+  IntStatePtr record = makeState();
+  boost::thread::id callback_thread;
+  future.addDoneCallback(boost::bind(&recordResult, record, &callback_thread, _1, _2));
+  state->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::SUCCESS), 42);
+
+  IntFuture recorded(record);
+  ASSERT_TRUE(recorded.wait(ros::WallDuration(5.0)));
+  EXPECT_TRUE(recorded.getErrorCode());
+  EXPECT_EQ(42, recorded.getValue());
+  EXPECT_NE(boost::this_thread::get_id(), callback_thread);
+
+  // a callback added after the operation completed is called too, and not in the thread that adds it
+  IntStatePtr late_record = makeState();
+  boost::thread::id late_callback_thread;
+  future.addDoneCallback(boost::bind(&recordResult, late_record, &late_callback_thread, _1, _2));
+  IntFuture late_recorded(late_record);
+  ASSERT_TRUE(late_recorded.wait(ros::WallDuration(5.0)));
+  EXPECT_EQ(42, late_recorded.getValue());
+  EXPECT_NE(boost::this_thread::get_id(), late_callback_thread);
+}
+
+TEST(MoveGroupFuture, CallbacksCanWaitForOtherOperations)
+{
+  // both operations are completed by the same thread, as the results of actions are processed by the same spinner
+  // thread; a callback of the first one that waits for the second one must not keep that thread from completing it
+  IntStatePtr first = makeState();
+  IntStatePtr second = makeState();
+  IntStatePtr record = makeState();
+  IntFuture(first).addDoneCallback(boost::bind(&recordResultOf, IntFuture(second), record, _1, _2));
+
+  boost::thread completer(boost::bind(&completeBoth, first, second));
+  IntFuture recorded(record);
+  ASSERT_TRUE(recorded.wait(ros::WallDuration(5.0)));
+  EXPECT_TRUE(recorded.getErrorCode());
+  EXPECT_EQ(2, recorded.getValue());
+  completer.join();
+}
+
+TEST(MoveGroupFuture, CancelsOnlyUntilDone)
+{
+  IntStatePtr state = makeState();
+  IntFuture future(state);
+  int cancelled = 0;
+  state->setCancelFunction(boost::bind(&increment, &cancelled));
+  future.cancel();
+  EXPECT_EQ(1, cancelled);
+  EXPECT_FALSE(future.isReady());
+
+  // completing the operation releases the cancel function; setting one afterwards has no effect
+  state->complete(MoveItErrorCode(moveit_msgs::MoveItErrorCodes::PREEMPTED), 0);
+  future.cancel();
+  state->setCancelFunction(boost::bind(&increment, &cancelled));
+  future.cancel();
+  EXPECT_EQ(1, cancelled);
+  EXPECT_EQ(moveit_msgs::MoveItErrorCodes::PREEMPTED, future.getErrorCode().val);
+
+  // a future that does not refer to an operation cannot be cancelled
+  IntFuture invalid;
+  invalid.cancel();
+  EXPECT_FALSE(invalid.valid());
+}
+
+TEST(MoveGroupFuture, WaitTimesOut)
+{
+  IntStatePtr state = makeState();
+  IntFuture future(state);
+  ros::WallTime start = ros::WallTime::now();
+  EXPECT_FALSE(future.wait(ros::WallDuration(0.2)));
+  EXPECT_GE((ros::WallTime::now() - start).toSec(), 0.19);
+  EXPECT_FALSE(future.isReady());
+
+  // waiting ends when the operation completes, not when the timeout expires
+  boost::thread completer(boost::bind(&completeLater, state, 100));
+  start = ros::WallTime::now();
+  EXPECT_TRUE(future.wait(ros::WallDuration(10.0)));
+  EXPECT_LT((ros::WallTime::now() - start).toSec(), 5.0);
+  EXPECT_TRUE(future.isReady());
+  EXPECT_EQ(3, future.getValue());
+  completer.join();
+
+  EXPECT_FALSE(IntFuture().wait(ros::WallDuration(0.1)));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -37,6 +37,7 @@
 #include <moveit/planning_scene_interface/planning_scene_interface.h>
 #include <moveit/move_group/capability_names.h>
 #include <moveit_msgs/GetPlanningScene.h>
+#include <moveit_ros_move_group/QueryWorldObjects.h>
 #include <ros/ros.h>
 
 namespace moveit
@@ -51,6 +52,7 @@ public:
   PlanningSceneInterfaceImpl()
   {
     planning_scene_service_ = node_handle_.serviceClient<moveit_msgs::GetPlanningScene>(move_group::GET_PLANNING_SCENE_SERVICE_NAME);
+    query_world_objects_service_ = node_handle_.serviceClient<moveit_ros_move_group::QueryWorldObjects>(move_group::QUERY_WORLD_OBJECTS_SERVICE_NAME);
     planning_scene_diff_publisher_ = node_handle_.advertise<moveit_msgs::PlanningScene>("planning_scene", 1);
   }
 
@@ -78,6 +80,24 @@ public:
 
   std::vector<std::string> getKnownObjectNamesInROI(double minx, double miny, double minz, double maxx, double maxy, double maxz, bool with_type, std::vector<std::string> &types)
   {
+    // if move_group can answer the query, only the ids of the matching objects are transferred
+    moveit_ros_move_group::QueryWorldObjects::Request query_request;
+    moveit_ros_move_group::QueryWorldObjects::Response query_response;
+    query_request.use_roi = true;
+    query_request.roi_min.x = minx;
+    query_request.roi_min.y = miny;
+    query_request.roi_min.z = minz;
+    query_request.roi_max.x = maxx;
+    query_request.roi_max.y = maxy;
+    query_request.roi_max.z = maxz;
+    query_request.with_type = with_type;
+    if (query_world_objects_service_.call(query_request, query_response))
+    {
+      if (with_type)
+        types.insert(types.end(), query_response.type_keys.begin(), query_response.type_keys.end());
+      return query_response.ids;
+    }
+
     moveit_msgs::GetPlanningScene::Request request;
     moveit_msgs::GetPlanningScene::Response response;
     std::vector<std::string> result;
@@ -130,9 +150,22 @@ public:
 
   std::map<std::string, geometry_msgs::Pose> getObjectPoses(const std::vector<std::string> &object_ids)
   {
+    std::map<std::string, geometry_msgs::Pose> result;
+    if (object_ids.empty())
+      return result;
+
+    moveit_ros_move_group::QueryWorldObjects::Request query_request;
+    moveit_ros_move_group::QueryWorldObjects::Response query_response;
+    query_request.ids = object_ids;
+    if (query_world_objects_service_.call(query_request, query_response))
+    {
+      for (std::size_t i = 0 ; i < query_response.ids.size() ; ++i)
+        result[query_response.ids[i]] = query_response.poses[i];
+      return result;
+    }
+
     moveit_msgs::GetPlanningScene::Request request;
     moveit_msgs::GetPlanningScene::Response response;
-    std::map<std::string, geometry_msgs::Pose> result;
     request.components.components = request.components.WORLD_OBJECT_GEOMETRY;
     if (!planning_scene_service_.call(request, response))
     {
@@ -185,6 +218,7 @@ private:
 
   ros::NodeHandle node_handle_;
   ros::ServiceClient planning_scene_service_;
+  ros::ServiceClient query_world_objects_service_;
   ros::Publisher planning_scene_diff_publisher_;  
   robot_model::RobotModelConstPtr robot_model_;
 };
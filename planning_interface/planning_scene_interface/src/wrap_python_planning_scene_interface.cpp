@@ -72,6 +72,29 @@ public:
     return moveit::py_bindings_tools::listFromString(getKnownObjectNamesInROI(minx, miny, minz, maxx, maxy, maxz, with_type));
   }
 
+  bp::tuple getObjectPosesPython(const bp::list &object_ids)
+  {
+    std::map<std::string, geometry_msgs::Pose> poses = getObjectPoses(moveit::py_bindings_tools::stringFromList(object_ids));
+    std::vector<std::string> ids;
+    std::vector<double> values;
+    ids.reserve(poses.size());
+    values.reserve(poses.size() * 7);
+    for (std::map<std::string, geometry_msgs::Pose>::const_iterator it = poses.begin() ; it != poses.end() ; ++it)
+    {
+      ids.push_back(it->first);
+      values.push_back(it->second.position.x);
+      values.push_back(it->second.position.y);
+      values.push_back(it->second.position.z);
+      values.push_back(it->second.orientation.x);
+      values.push_back(it->second.orientation.y);
+      values.push_back(it->second.orientation.z);
+      values.push_back(it->second.orientation.w);
+    }
+    // one row of [x, y, z, qx, qy, qz, qw] per object, in the order of the returned ids
+    return bp::make_tuple(moveit::py_bindings_tools::listFromString(ids),
+                          moveit::py_bindings_tools::wrapDoubleArray(values, ids.size()));
+  }
+
 };
 
 static void wrap_planning_scene_interface()
@@ -80,6 +103,7 @@ static void wrap_planning_scene_interface()
 
   PlanningSceneClass.def("get_known_object_names", &PlanningSceneInterfaceWrapper::getKnownObjectNamesPython);
   PlanningSceneClass.def("get_known_object_names_in_roi", &PlanningSceneInterfaceWrapper::getKnownObjectNamesInROIPython);
+  PlanningSceneClass.def("get_object_poses", &PlanningSceneInterfaceWrapper::getObjectPosesPython);
 }
 
 }
@@ -38,6 +38,8 @@
 #define MOVEIT_PY_BINDINGS_TOOLS_PY_CONVERSIONS_
 
 #include <boost/python.hpp>
+#include <Python.h>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -85,6 +87,197 @@ boost::python::list listFromString(const std::vector<std::string>& v)
   return listFromType<std::string>(v);
 }
 
+/** \brief Convert a Python sequence of numbers to a vector of doubles. Contiguous buffers of doubles (numpy float64
+    arrays, array.array('d'), memoryviews) are copied with a single memcpy(); other sequences are converted element
+    by element. */
+inline std::vector<double> doubleFromSequence(const boost::python::object &values)
+{
+  if (PyObject_CheckBuffer(values.ptr()))
+  {
+    Py_buffer view;
+    if (PyObject_GetBuffer(values.ptr(), &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0)
+    {
+      const char *f = view.format;
+      if (f && (*f == '@' || *f == '='))
+        ++f;
+      if (f && std::strcmp(f, "d") == 0 && view.itemsize == sizeof(double))
+      {
+        std::vector<double> v(view.len / sizeof(double));
+        if (!v.empty())
+          memcpy(&v[0], view.buf, v.size() * sizeof(double));
+        PyBuffer_Release(&view);
+        return v;
+      }
+      PyBuffer_Release(&view);
+    }
+    else
+      PyErr_Clear();
+  }
+
+  int l = boost::python::len(values);
+  std::vector<double> v(l);
+  for (int i = 0; i < l ; ++i)
+    v[i] = boost::python::extract<double>(values[i]);
+  return v;
+}
+
+namespace detail
+{
+/** \brief A read-only array of doubles that exports its memory through the buffer protocol */
+struct DoubleArrayObject
+{
+  PyObject_HEAD
+  std::vector<double> *data_;
+  int ndim_;
+  Py_ssize_t shape_[2];
+  Py_ssize_t strides_[2];
+};
+
+inline void destroyDoubleArray(PyObject *self)
+{
+  delete reinterpret_cast<DoubleArrayObject*>(self)->data_;
+  Py_TYPE(self)->tp_free(self);
+}
+
+inline int getDoubleArrayBuffer(PyObject *self, Py_buffer *view, int flags)
+{
+  DoubleArrayObject *array = reinterpret_cast<DoubleArrayObject*>(self);
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+  {
+    PyErr_SetString(PyExc_BufferError, "Array of doubles is read-only");
+    view->obj = NULL;
+    return -1;
+  }
+  view->buf = array->data_->empty() ? NULL : &(*array->data_)[0];
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = array->data_->size() * sizeof(double);
+  view->readonly = 1;
+  view->itemsize = sizeof(double);
+  view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>("d") : NULL;
+  // consumers that do not ask for the shape see the rows as one contiguous sequence of doubles
+  view->ndim = (flags & PyBUF_ND) == PyBUF_ND ? array->ndim_ : 1;
+  view->shape = (flags & PyBUF_ND) == PyBUF_ND ? array->shape_ : NULL;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? array->strides_ : NULL;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+  return 0;
+}
+
+inline Py_ssize_t getDoubleArrayLength(PyObject *self)
+{
+  return reinterpret_cast<DoubleArrayObject*>(self)->shape_[0];
+}
+
+inline PyObject* doubleArrayToList(PyObject *self, PyObject *)
+{
+  DoubleArrayObject *array = reinterpret_cast<DoubleArrayObject*>(self);
+  Py_ssize_t cols = array->ndim_ == 2 ? array->shape_[1] : array->shape_[0];
+  PyObject *result = PyList_New(array->shape_[0]);
+  for (Py_ssize_t i = 0 ; result && i < array->shape_[0] ; ++i)
+  {
+    PyObject *item;
+    if (array->ndim_ == 2)
+    {
+      item = PyList_New(cols);
+      for (Py_ssize_t j = 0 ; item && j < cols ; ++j)
+      {
+        PyObject *value = PyFloat_FromDouble((*array->data_)[i * cols + j]);
+        if (!value)
+        {
+          Py_DECREF(item);
+          item = NULL;
+        }
+        else
+          PyList_SET_ITEM(item, j, value);
+      }
+    }
+    else
+      item = PyFloat_FromDouble((*array->data_)[i]);
+    if (!item)
+    {
+      Py_DECREF(result);
+      result = NULL;
+    }
+    else
+      PyList_SET_ITEM(result, i, item);
+  }
+  return result;
+}
+
+/** \brief Get the Python type of the arrays returned by wrapDoubleArray(), initializing it on first use */
+inline PyTypeObject* getDoubleArrayType()
+{
+  static PyTypeObject type = { PyVarObject_HEAD_INIT(NULL, 0) };
+  static PyBufferProcs buffer_procs;
+  static PySequenceMethods sequence_methods;
+  static PyMethodDef methods[] = {
+    { "tolist", &doubleArrayToList, METH_NOARGS, "Return the values as a list (a list of rows for two-dimensional arrays)" },
+    { NULL, NULL, 0, NULL }
+  };
+
+  if (!(type.tp_flags & Py_TPFLAGS_READY))
+  {
+    buffer_procs.bf_getbuffer = &getDoubleArrayBuffer;
+    sequence_methods.sq_length = &getDoubleArrayLength;
+    type.tp_name = "moveit.DoubleArray";
+    type.tp_basicsize = sizeof(DoubleArrayObject);
+    type.tp_dealloc = &destroyDoubleArray;
+    type.tp_as_sequence = &sequence_methods;
+    type.tp_as_buffer = &buffer_procs;
+#ifdef Py_TPFLAGS_HAVE_NEWBUFFER
+    type.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_NEWBUFFER;
+#else
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+#endif
+    type.tp_doc = "Read-only array of doubles; use numpy.asarray() to access it without copying";
+    type.tp_methods = methods;
+    if (PyType_Ready(&type) < 0)
+      boost::python::throw_error_already_set();
+  }
+  return &type;
+}
+}
+
+/** \brief Wrap a row-major array of doubles in a read-only Python object of the given number of rows, without
+    copying the data. The vector is swapped into storage owned by the Python object, so \e data is left empty.
+    The object supports the buffer protocol, so numpy.asarray() and memoryview() share its memory; tolist() and
+    len() are provided as well. If \e rows is 0, a one-dimensional array is returned. */
+inline boost::python::object wrapDoubleArray(std::vector<double> &data, std::size_t rows = 0)
+{
+  std::size_t cols = rows ? data.size() / rows : data.size();
+  PyTypeObject *type = detail::getDoubleArrayType();
+  detail::DoubleArrayObject *array = PyObject_New(detail::DoubleArrayObject, type);
+  if (!array)
+    boost::python::throw_error_already_set();
+  array->data_ = NULL;
+  boost::python::object result((boost::python::handle<>(reinterpret_cast<PyObject*>(array))));
+  array->data_ = new std::vector<double>();
+  array->data_->swap(data);
+
+  array->ndim_ = rows ? 2 : 1;
+  if (rows)
+  {
+    array->shape_[0] = rows;
+    array->shape_[1] = cols;
+    array->strides_[0] = cols * sizeof(double);
+    array->strides_[1] = sizeof(double);
+  }
+  else
+  {
+    array->shape_[0] = cols;
+    array->strides_[0] = sizeof(double);
+  }
+  return result;
+}
+
+/** \brief Copy a vector of doubles to a one-dimensional read-only Python array (see wrapDoubleArray()) */
+inline boost::python::object arrayFromDouble(const std::vector<double> &v)
+{
+  std::vector<double> copy(v);
+  return wrapDoubleArray(copy);
+}
+
 }
 }
 
@@ -38,6 +38,8 @@
 #define MOVEIT_PY_BINDINGS_TOOLS_SERIALIZE_MSG_
 
 #include <ros/ros.h>
+#include <boost/python.hpp>
+#include <Python.h>
 
 namespace moveit
 {
@@ -71,6 +73,58 @@ void deserializeMsg(const std::string &data, T &msg)
   ros::serialization::deserialize(stream_arg, msg);
 }
 
+/** \brief Convert a ROS message to a Python string. The message is serialized directly into the memory of the
+    Python object, so large messages (e.g., trajectories) are only copied once. */
+template<typename T>
+boost::python::object serializeMsgToPython(const T &msg)
+{
+  std::size_t size = ros::serialization::serializationLength(msg);
+  PyObject *result = PyBytes_FromStringAndSize(NULL, size);
+  if (!result)
+    boost::python::throw_error_already_set();
+  boost::python::object holder((boost::python::handle<>(result)));
+  if (size)
+  {
+    ros::serialization::OStream stream_arg(reinterpret_cast<uint8_t*>(PyBytes_AS_STRING(result)), size);
+    ros::serialization::serialize(stream_arg, msg);
+  }
+  return holder;
+}
+
+/** \brief Convert serialized data held by a Python object to a ROS message. Objects that support the buffer protocol
+    (str, bytearray, memoryview, numpy arrays) are read in place. Unicode strings are encoded as UTF-8 first, since their
+    buffer holds the internal representation of the characters; other objects are converted to a string. */
+template<typename T>
+void deserializeMsg(const boost::python::object &data, T &msg)
+{
+  if (PyUnicode_Check(data.ptr()))
+  {
+    boost::python::object encoded((boost::python::handle<>(PyUnicode_AsUTF8String(data.ptr()))));
+    deserializeMsg(encoded, msg);
+    return;
+  }
+  if (!PyObject_CheckBuffer(data.ptr()))
+  {
+    deserializeMsg(std::string(boost::python::extract<std::string>(data)), msg);
+    return;
+  }
+
+  Py_buffer view;
+  if (PyObject_GetBuffer(data.ptr(), &view, PyBUF_SIMPLE) != 0)
+    boost::python::throw_error_already_set();
+  try
+  {
+    ros::serialization::IStream stream_arg(static_cast<uint8_t*>(view.buf), view.len);
+    ros::serialization::deserialize(stream_arg, msg);
+  }
+  catch(...)
+  {
+    PyBuffer_Release(&view);
+    throw;
+  }
+  PyBuffer_Release(&view);
+}
+
 }
 }
 
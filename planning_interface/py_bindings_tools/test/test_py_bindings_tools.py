@@ -0,0 +1,117 @@
+#!/usr/bin/env python
+
+# Software License Agreement (BSD License)
+#
+#  Copyright (c) 2026, the MoveIt contributors
+#  All rights reserved.
+#
+#  Redistribution and use in source and binary forms, with or without
+#  modification, are permitted provided that the following conditions
+#  are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above
+#     copyright notice, this list of conditions and the following
+#     disclaimer in the documentation and/or other materials provided
+#     with the distribution.
+#   * Neither the name of Willow Garage nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+#  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+#  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+#  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+#  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+#  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+#  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+#  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+#  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+#  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+#  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+#  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+#  POSSIBILITY OF SUCH DAMAGE.
+
+import unittest
+import numpy
+
+from moveit_ros_planning_interface import _moveit_py_bindings_tools_test as conversions
+
+
+class DoubleArrayTest(unittest.TestCase):
+
+    def test_joint_values_array(self):
+        # get_current_joint_values_array() and get_random_joint_values_array() return one value per joint
+        values = [0.1, -0.2, 0.3, 1.5]
+        a = conversions.wrap_double_array(values, 0)
+        n = numpy.asarray(a)
+        self.assertEqual(n.shape, (4,))
+        self.assertEqual(n.dtype, numpy.float64)
+        self.assertEqual(n.tolist(), values)
+        self.assertEqual(a.tolist(), values)
+        self.assertEqual(len(a), 4)
+        self.assertEqual(memoryview(a).tolist(), values)
+
+    def test_plan_arrays(self):
+        # compute_plan_arrays() returns the waypoint times and one row of joint positions per waypoint
+        times = [0.0, 0.5, 1.0]
+        positions = [[0.0, 1.0], [0.5, 1.5], [1.0, 2.0]]
+        t = numpy.asarray(conversions.wrap_double_array(times, 0))
+        self.assertEqual(t.tolist(), times)
+        a = conversions.wrap_double_array([v for row in positions for v in row], len(positions))
+        p = numpy.asarray(a)
+        self.assertEqual(p.shape, (3, 2))
+        self.assertEqual(p.tolist(), positions)
+        self.assertEqual(a.tolist(), positions)
+        self.assertEqual(len(a), 3)
+        self.assertEqual(p[:, 1].tolist(), [1.0, 1.5, 2.0])
+
+    def test_object_poses_array(self):
+        # get_object_poses() returns one row of [x, y, z, qx, qy, qz, qw] per object
+        poses = [[1.0, 2.0, 3.0, 0.0, 0.0, 0.0, 1.0], [4.0, 5.0, 6.0, 0.0, 0.0, 1.0, 0.0]]
+        p = numpy.asarray(conversions.wrap_double_array([v for row in poses for v in row], len(poses)))
+        self.assertEqual(p.shape, (2, 7))
+        self.assertEqual(p.tolist(), poses)
+
+    def test_empty_array(self):
+        a = conversions.wrap_double_array([], 0)
+        self.assertEqual(numpy.asarray(a).shape, (0,))
+        self.assertEqual(a.tolist(), [])
+        self.assertEqual(len(a), 0)
+
+    def test_array_is_read_only(self):
+        n = numpy.asarray(conversions.wrap_double_array([1.0, 2.0], 0))
+        self.assertFalse(n.flags.writeable)
+        with self.assertRaises(ValueError):
+            n[0] = 3.0
+
+    def test_array_outlives_wrapper(self):
+        # the numpy array keeps the memory of the wrapper alive
+        n = numpy.asarray(conversions.wrap_double_array([float(i) for i in range(100)], 10))
+        self.assertEqual(n[9, 9], 99.0)
+        self.assertEqual(n.sum(), sum(range(100)))
+
+    def test_array_converts_back(self):
+        a = conversions.wrap_double_array([1.0, 2.0, 3.0, 4.0], 2)
+        self.assertEqual(conversions.double_from_sequence(a), [1.0, 2.0, 3.0, 4.0])
+        self.assertEqual(conversions.double_from_sequence(numpy.asarray(a)), [1.0, 2.0, 3.0, 4.0])
+        self.assertEqual(conversions.double_from_sequence([1, 2]), [1.0, 2.0])
+
+
+class DeserializeMsgTest(unittest.TestCase):
+
+    def test_buffers(self):
+        data = conversions.serialize_string('hello')
+        self.assertEqual(conversions.deserialize_string(data), 'hello')
+        self.assertEqual(conversions.deserialize_string(bytearray(data)), 'hello')
+        self.assertEqual(conversions.deserialize_string(memoryview(data)), 'hello')
+        self.assertEqual(conversions.deserialize_string(numpy.frombuffer(data, dtype=numpy.uint8)), 'hello')
+
+    def test_unicode(self):
+        # the buffer of a unicode object does not hold the serialized bytes, so it must not be read in place
+        data = conversions.serialize_string('hello')
+        self.assertEqual(conversions.deserialize_string(data.decode('latin-1')), 'hello')
+
+
+if __name__ == '__main__':
+    unittest.main()
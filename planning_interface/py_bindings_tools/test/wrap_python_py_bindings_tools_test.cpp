@@ -0,0 +1,79 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/py_bindings_tools/py_conversions.h>
+#include <moveit/py_bindings_tools/serialize_msg.h>
+#include <std_msgs/String.h>
+
+/** @cond IGNORE */
+
+namespace bp = boost::python;
+
+// the *_array methods of the Python interfaces return their values through wrapDoubleArray();
+// these functions expose the same conversions without requiring a running move_group
+
+static bp::object wrapDoubleArrayPython(const bp::list &values, std::size_t rows)
+{
+  std::vector<double> v = moveit::py_bindings_tools::doubleFromList(values);
+  return moveit::py_bindings_tools::wrapDoubleArray(v, rows);
+}
+
+static bp::list doubleFromSequencePython(const bp::object &values)
+{
+  return moveit::py_bindings_tools::listFromDouble(moveit::py_bindings_tools::doubleFromSequence(values));
+}
+
+static bp::object serializeStringPython(const std::string &data)
+{
+  std_msgs::String msg;
+  msg.data = data;
+  return moveit::py_bindings_tools::serializeMsgToPython(msg);
+}
+
+static std::string deserializeStringPython(const bp::object &data)
+{
+  std_msgs::String msg;
+  moveit::py_bindings_tools::deserializeMsg(data, msg);
+  return msg.data;
+}
+
+BOOST_PYTHON_MODULE(_moveit_py_bindings_tools_test)
+{
+  bp::def("wrap_double_array", &wrapDoubleArrayPython);
+  bp::def("double_from_sequence", &doubleFromSequencePython);
+  bp::def("serialize_string", &serializeStringPython);
+  bp::def("deserialize_string", &deserializeStringPython);
+}
+
+/** @endcond */
@@ -0,0 +1,86 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, the MoveIt contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/warehouse/plan_cache_storage.h>
+#include <pluginlib/class_list_macros.h>
+
+const std::string moveit_warehouse::PlanCacheStorage::DATABASE_NAME = "moveit_plan_cache";
+
+const std::string moveit_warehouse::PlanCacheStorage::PLAN_KEY_NAME = "plan_key";
+
+moveit_warehouse::PlanCacheStorage::PlanCacheStorage(const std::string &host, const unsigned int port, double wait_seconds) :
+  MoveItMessageStorage(host, port, wait_seconds)
+{
+  createCollections();
+  ROS_DEBUG("Connected to MongoDB '%s' on host '%s' port '%u'.", DATABASE_NAME.c_str(), db_host_.c_str(), db_port_);
+}
+
+void moveit_warehouse::PlanCacheStorage::createCollections()
+{
+  plan_collection_.reset(new CachedPlanCollection::element_type(DATABASE_NAME, "cached_plans", db_host_, db_port_, timeout_));
+}
+
+void moveit_warehouse::PlanCacheStorage::reset()
+{
+  plan_collection_.reset();
+  MoveItMessageStorage::drop(DATABASE_NAME);
+  createCollections();
+}
+
+bool moveit_warehouse::PlanCacheStorage::loadPlan(const std::string &key, moveit_msgs::RobotTrajectory &trajectory)
+{
+  mongo_ros::Query q(PLAN_KEY_NAME, key);
+  std::vector<CachedPlanWithMetadata> plans = plan_collection_->pullAllResults(q, false);
+  if (plans.empty())
+    return false;
+  trajectory = *plans.back();
+  return true;
+}
+
+void moveit_warehouse::PlanCacheStorage::storePlan(const std::string &key, const moveit_msgs::RobotTrajectory &trajectory)
+{
+  removePlan(key);
+  mongo_ros::Metadata metadata(PLAN_KEY_NAME, key);
+  plan_collection_->insert(trajectory, metadata);
+  ROS_DEBUG("Stored cached plan");
+}
+
+void moveit_warehouse::PlanCacheStorage::removePlan(const std::string &key)
+{
+  mongo_ros::Query q(PLAN_KEY_NAME, key);
+  unsigned int rem = plan_collection_->removeMessages(q);
+  ROS_DEBUG("Removed %u cached plans", rem);
+}
+
+PLUGINLIB_EXPORT_CLASS(moveit_warehouse::PlanCacheStorage, planning_pipeline::PlanCache::Storage);